@@ -0,0 +1,103 @@
+/* ***************************************************** */
+/* Build observation input filenames for                 */
+/* a given analog date.                                  */
+/* build_obs_filenames.c                                 */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/*! \file build_obs_filenames.c
+    \brief Build observation input filenames for a given analog date.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+/** Build observation input filenames for a given analog date. */
+void
+build_obs_filenames(char **infile, char *format, var_struct *obs_var, int year, int month) {
+  /**
+     @param[out]  infile                 Input filenames, one per observation variable, each of MAXPATH length
+     @param[in]   format                 Filename format, built from observation path, frequency and template
+     @param[in]   obs_var                Input/output observation variables data structure
+     @param[in]   year                   Year of the analog date
+     @param[in]   month                  Month of the analog date
+  */
+
+  int year1; /* First year of data input file */
+  int year2; /* End year of data input file */
+  int tmpi; /* Temporay integer value */
+  int var; /* Variable counter */
+
+  if (obs_var->month_begin != 1) {
+    /* Months in observation files *does not* begin in January: must have 2 years in filename */
+    if (month < obs_var->month_begin)
+      year1 = year - 1;
+    else
+      year1 = year;
+    year2 = year1 + 1;
+    if (obs_var->year_digits != 4) {
+      tmpi = year1 / 100;
+      year1 = year1 - (tmpi*100);
+      tmpi = year2 / 100;
+      year2 = year2 - (tmpi*100);
+    }
+    /* Process each variable and create input filenames */
+    for (var=0; var<obs_var->nobs_var; var++)
+      (void) sprintf(infile[var], format, obs_var->path, obs_var->frequency,
+                     obs_var->acronym[var], year1, year2);
+  }
+  else {
+    /* Months in observation files begins in January: must have 1 year in filename */
+    year1 = year;
+    if (obs_var->year_digits != 4) {
+      tmpi = year1 / 100;
+      year1 = year1 - (tmpi*100);
+    }
+    /* Process each variable and create input filenames */
+    for (var=0; var<obs_var->nobs_var; var++)
+      (void) sprintf(infile[var], format, obs_var->path, obs_var->frequency,
+                     obs_var->acronym[var], year1);
+  }
+}
@@ -0,0 +1,84 @@
+/* ***************************************************** */
+/* Build the filename of a cached                        */
+/* intermediate downscaling product.                     */
+/* cache_filename.c                                      */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file cache_filename.c
+    \brief Build the filename of a cached intermediate downscaling product.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+/** Build the filename of a cached intermediate downscaling product: products are named after the key of the
+    configuration and input files they depend on, so that a product computed with other ones is never used. */
+char *
+cache_filename(data_struct *data, int stage, char *product) {
+  /**
+     @param[in]  data     MASTER data structure.
+     @param[in]  stage    Downscaling stage of product.
+     @param[in]  product  Product name.
+     
+     \return              Allocated filename.
+  */
+
+  char *filename = NULL; /* Cache filename */
+
+  filename = (char *) malloc(MAXPATH * sizeof(char));
+  if (filename == NULL) alloc_error(__FILE__, __LINE__);
+  (void) sprintf(filename, "%s/%s_%s", data->conf->cache_path, data->conf->cache_key[stage], product);
+
+  return filename;
+}
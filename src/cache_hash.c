@@ -0,0 +1,209 @@
+/* ***************************************************** */
+/* Compute the keys of cached intermediate               */
+/* downscaling products.                                 */
+/* cache_hash.c                                          */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file cache_hash.c
+    \brief Compute the keys of cached intermediate downscaling products.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <libs/xml_utils/xml_utils.h>
+#include <dsclim.h>
+
+/** Settings which climatologies of large-scale fields depend on. */
+static const char *cache_settings_clim[] = { "base_time_units", "base_calendar_type", "fixtime", "year_begin_ctrl", "year_begin_other",
+                                             "clim_filter_width", "clim_filter_type", "period_ctrl",
+                                             "domain_large_scale", "domain_secondary_large_scale",
+                                             "number_of_large_scale_fields", "number_of_large_scale_control_fields",
+                                             "number_of_secondary_large_scale_fields", "number_of_secondary_large_scale_control_fields",
+                                             "large_scale_fields", "large_scale_control_fields",
+                                             "secondary_large_scale_fields", "secondary_large_scale_control_fields", NULL };
+/** Additional settings which large-scale fields projected on EOFs depend on. */
+static const char *cache_settings_eof[] = { "eof_name", "longitude_name_eof", "latitude_name_eof", "dimx_name_eof", "dimy_name_eof", NULL };
+/** Learning settings, which large-scale fields projected on EOFs depend on when the learning computes the EOFs. */
+static const char *cache_settings_learning[] = { "learning", NULL };
+/** Settings which only change the output of downscaled data, or how it is computed but not its values:
+    they are left out of the keys of all cached products. */
+static const char *cache_settings_output[] = { "debug", "output", "output_downscaling_data", "period", "format",
+                                               "compression", "compression_level", "deltat", "observations",
+                                               "output_only", "analog_save", "analog_file_ctrl", "analog_file_other",
+                                               "checkpoint_path", "cache_path", "number_of_threads", "stream_chunk",
+                                               "performance_report", "performance_attribute", "prefetch_obs", NULL };
+/** Observation settings, used by the learning when it is computed. */
+static const char *cache_settings_obs[] = { "observations", NULL };
+
+static unsigned long long cache_hash_settings(unsigned long long hash, xmlDocPtr doc, const char **names, int include);
+
+/** Update a hash with the XML text of configuration settings: either the listed ones, or all but the listed ones. */
+static unsigned long long
+cache_hash_settings(unsigned long long hash, xmlDocPtr doc, const char **names, int include) {
+  /**
+     @param[in]  hash     Current hash value.
+     @param[in]  doc      Configuration XML document.
+     @param[in]  names    NULL-terminated list of setting names.
+     @param[in]  include  TRUE to hash listed settings, FALSE to hash settings which are not listed.
+     
+     \return              Updated hash value.
+  */
+
+  xmlNodePtr node = NULL; /* Setting node */
+  xmlBufferPtr buf = NULL; /* XML text of setting node */
+  xmlChar *name = NULL; /* Setting name */
+  int listed; /* If setting is listed */
+  int n; /* Loop counter for setting names */
+
+  for (node=xmlDocGetRootElement(doc)->children; node != NULL; node=node->next) {
+    if (node->type != XML_ELEMENT_NODE || xmlStrcmp(node->name, (const xmlChar *) "setting"))
+      continue;
+    name = xmlGetProp(node, (const xmlChar *) "name");
+    if (name == NULL)
+      continue;
+    listed = FALSE;
+    for (n=0; names[n] != NULL; n++)
+      if (!xmlStrcmp(name, (const xmlChar *) names[n]))
+        listed = TRUE;
+    if (listed == include) {
+      buf = xmlBufferCreate();
+      if (buf == NULL) alloc_error(__FILE__, __LINE__);
+      (void) xmlNodeDump(buf, doc, node, 0, 0);
+      hash = hash_bytes(hash, xmlBufferContent(buf), (size_t) xmlBufferLength(buf));
+      (void) xmlBufferFree(buf);
+    }
+    (void) xmlFree(name);
+  }
+
+  return hash;
+}
+
+/** Compute the keys of cached intermediate downscaling products. Each key is a hash of the software version, of the
+    configuration settings and of the identity (name, size and modification time) of the input files the product
+    depends on: climatologies depend only on large-scale fields, EOF projections also on EOFs, and distances,
+    classification, regression index and analog days on everything but the output settings. */
+int
+cache_hash(data_struct *data) {
+  /**
+     @param[in]  data  MASTER data structure.
+     
+     \return           Status.
+  */
+
+  xmlDocPtr doc = NULL; /* Configuration XML document */
+  unsigned long long hash = HASH_INIT; /* FNV-1a 64-bit hash value */
+  int cat; /* Loop counter for field categories */
+  int i; /* Loop counter for large-scale fields */
+
+  doc = xmlParseMemory(data->conf->config, (int) strlen(data->conf->config));
+  if (doc == NULL || xmlDocGetRootElement(doc) == NULL) {
+    (void) fprintf(stderr, "%s: Cannot parse configuration to compute cache keys.\n", __FILE__);
+    if (doc != NULL) (void) xmlFreeDoc(doc);
+    return -1;
+  }
+
+  /* Climatologies: large-scale fields */
+  hash = hash_bytes(hash, PACKAGE_VERSION, strlen(PACKAGE_VERSION)+1);
+  hash = cache_hash_settings(hash, doc, cache_settings_clim, TRUE);
+  for (cat=0; cat<NCAT; cat++)
+    for (i=0; i<data->field[cat].n_ls; i++) {
+      hash = hash_file(hash, data->field[cat].data[i].filename_ls);
+      if (data->field[cat].data[i].clim_info->clim_remove == TRUE && data->field[cat].data[i].clim_info->clim_provided == TRUE)
+        hash = hash_file(hash, data->field[cat].data[i].clim_info->clim_filein_ls);
+    }
+  (void) sprintf(data->conf->cache_key[CHECKPOINT_CLIM], "%016llx", hash);
+
+  /* Large-scale fields projected on EOFs: also EOFs */
+  hash = cache_hash_settings(hash, doc, cache_settings_eof, TRUE);
+  for (cat=FIELD_LS; cat<=CTRL_FIELD_LS; cat++)
+    for (i=0; i<data->field[cat].n_ls; i++)
+      if (data->field[cat].data[i].eof_info->eof_project == TRUE && data->field[cat].data[i].eof_info->eof_filein_ls != NULL)
+        hash = hash_file(hash, data->field[cat].data[i].eof_info->eof_filein_ls);
+  if (data->learning->eof_compute != FALSE) {
+    /* EOFs computed by the learning from the reanalysis field */
+    hash = cache_hash_settings(hash, doc, cache_settings_learning, TRUE);
+    hash = hash_file(hash, data->learning->filename_rea_field);
+  }
+  (void) sprintf(data->conf->cache_key[CHECKPOINT_EOF], "%016llx", hash);
+
+  /* Distances, classification, regression index and analog days: also learning, regression points and masks */
+  hash = cache_hash_settings(hash, doc, cache_settings_output, FALSE);
+  if (data->learning->learning_provided == TRUE) {
+    hash = hash_file(hash, data->learning->filename_open_weight);
+    hash = hash_file(hash, data->learning->filename_open_learn);
+    hash = hash_file(hash, data->learning->filename_open_clust_learn);
+  }
+  else {
+    hash = cache_hash_settings(hash, doc, cache_settings_obs, TRUE);
+    hash = hash_file(hash, data->conf->obs_var->path);
+    if (data->learning->eof_compute == FALSE) {
+      hash = hash_file(hash, data->learning->obs->filename_eof);
+      hash = hash_file(hash, data->learning->rea->filename_eof);
+    }
+    hash = hash_file(hash, data->learning->filename_rea_sup);
+    hash = hash_bytes(hash, &(data->conf->classif_seed), sizeof(data->conf->classif_seed));
+  }
+  if (data->reg->filename != NULL)
+    hash = hash_file(hash, data->reg->filename);
+  if (data->secondary_mask->use_mask == TRUE)
+    hash = hash_file(hash, data->secondary_mask->filename);
+  if (data->conf->learning_maskfile->use_mask == TRUE)
+    hash = hash_file(hash, data->conf->learning_maskfile->filename);
+  (void) sprintf(data->conf->cache_key[CHECKPOINT_CLASS], "%016llx", hash);
+  (void) sprintf(data->conf->cache_key[CHECKPOINT_ANALOG], "%016llx", hash);
+
+  (void) xmlFreeDoc(doc);
+
+  /* Success status */
+  return 0;
+}
@@ -0,0 +1,112 @@
+/* ***************************************************** */
+/* Compute the hash of configuration and input           */
+/* files validating checkpoint files.                    */
+/* checkpoint_hash.c                                     */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file checkpoint_hash.c
+    \brief Compute the hash of configuration and input files validating checkpoint files.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+/** Compute the hash of configuration and input files validating checkpoint files.
+    Checkpoint files written with another configuration, other large-scale input files or learning data files,
+    or another version of the software are not used to resume downscaling. */
+int
+checkpoint_hash(data_struct *data) {
+  /**
+     @param[in]  data  MASTER data structure.
+     
+     \return           Status.
+  */
+
+  unsigned long long hash = HASH_INIT; /* FNV-1a 64-bit hash value */
+  int cat; /* Loop counter for field categories */
+  int i; /* Loop counter for large-scale fields */
+
+  /* Software version and whole configuration text */
+  hash = hash_bytes(hash, PACKAGE_VERSION, strlen(PACKAGE_VERSION)+1);
+  hash = hash_bytes(hash, data->conf->config, strlen(data->conf->config)+1);
+
+  /* Large-scale input files */
+  for (cat=0; cat<NCAT; cat++)
+    for (i=0; i<data->field[cat].n_ls; i++)
+      hash = hash_file(hash, data->field[cat].data[i].filename_ls);
+
+  /* Learning data files, or learning input files and the actual seed of the classification when learning data is computed */
+  if (data->learning->learning_provided == TRUE) {
+    hash = hash_file(hash, data->learning->filename_open_weight);
+    hash = hash_file(hash, data->learning->filename_open_learn);
+    hash = hash_file(hash, data->learning->filename_open_clust_learn);
+  }
+  else {
+    if (data->learning->eof_compute == FALSE) {
+      hash = hash_file(hash, data->learning->obs->filename_eof);
+      hash = hash_file(hash, data->learning->rea->filename_eof);
+    }
+    else
+      hash = hash_file(hash, data->learning->filename_rea_field);
+    hash = hash_file(hash, data->learning->filename_rea_sup);
+    hash = hash_bytes(hash, &(data->conf->classif_seed), sizeof(data->conf->classif_seed));
+  }
+
+  data->conf->checkpoint_hash = (char *) malloc(17 * sizeof(char));
+  if (data->conf->checkpoint_hash == NULL) alloc_error(__FILE__, __LINE__);
+  (void) sprintf(data->conf->checkpoint_hash, "%016llx", hash);
+
+  /* Success status */
+  return 0;
+}
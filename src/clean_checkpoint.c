@@ -0,0 +1,96 @@
+/* ***************************************************** */
+/* Remove checkpoint files after a completed             */
+/* downscaling.                                          */
+/* clean_checkpoint.c                                    */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file clean_checkpoint.c
+    \brief Remove checkpoint files after a completed downscaling.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+/** Remove checkpoint files after a completed downscaling, so that the next run starts from the beginning
+    and stage data does not use disk space anymore. The checkpoint directory itself is kept. */
+void
+clean_checkpoint(data_struct *data) {
+  /**
+     @param[in]  data  MASTER data structure.
+  */
+
+  char *filename = NULL; /* Checkpoint filename */
+  int stage; /* Loop counter for stages */
+
+  filename = (char *) malloc(MAXPATH * sizeof(char));
+  if (filename == NULL) alloc_error(__FILE__, __LINE__);
+
+  /* State file first: remaining files are ignored without it */
+  (void) sprintf(filename, "%s/%s", data->conf->checkpoint_path, "checkpoint.txt");
+  (void) unlink(filename);
+  for (stage=CHECKPOINT_CLIM; stage<CHECKPOINT_ANALOG; stage++) {
+    (void) sprintf(filename, "%s/stage%d.bin", data->conf->checkpoint_path, stage);
+    (void) unlink(filename);
+  }
+  (void) sprintf(filename, "%s/%s", data->conf->checkpoint_path, "analog_other.nc");
+  (void) unlink(filename);
+  (void) sprintf(filename, "%s/%s", data->conf->checkpoint_path, "analog_ctrl.nc");
+  (void) unlink(filename);
+  (void) sprintf(filename, "%s/%s", data->conf->checkpoint_path, "output_other.txt");
+  (void) unlink(filename);
+  (void) sprintf(filename, "%s/%s", data->conf->checkpoint_path, "output_ctrl.txt");
+  (void) unlink(filename);
+
+  (void) free(filename);
+}
@@ -0,0 +1,173 @@
+/* ***************************************************** */
+/* compute_large_scale_eof Compute EOF and               */
+/* singular values of large-scale fields.                */
+/* compute_large_scale_eof.c                             */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file compute_large_scale_eof.c
+    \brief Use EOF and singular values computed by the learning for large-scale fields.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+/** Use the EOFs and singular values of the reanalysis large-scale field computed by the learning, instead of reading them. */
+int
+compute_large_scale_eof(data_struct *data) {
+  /**
+     @param[in]  data  MASTER data structure.
+     
+     \return           Status.
+  */
+
+  int istat; /* Diagnostic status */
+  int i; /* Loop counter */
+  int j; /* Loop counter */
+  int cat; /* Field category loop counter */
+  int nlon; /* Longitude dimension */
+  int nlat; /* Latitude dimension */
+  int neof; /* EOF dimension */
+  field_data_struct *cur = NULL; /* Current field data */
+
+  /* Loop over large-scale field categories (Control run and Model run) */
+  for (cat=CTRL_FIELD_LS; cat>=FIELD_LS; cat--)
+    /* Loop over large-scale fields */
+    for (i=0; i<data->field[cat].n_ls; i++) {
+
+      cur = &(data->field[cat].data[i]);
+      if (cur->eof_info->eof_project != TRUE || cur->eof_info->eof_compute != TRUE)
+        continue;
+
+      nlon = data->field[cat].nlon_ls;
+      nlat = data->field[cat].nlat_ls;
+      neof = cur->eof_info->neof_ls;
+
+      /* Large-scale fields are projected onto the EOFs of the reanalysis field of the learning: the grids must be the same */
+      if (data->learning->rea_eof_ls == NULL) {
+        (void) fprintf(stderr, "%s: ERROR: Large-scale field #%d of category %d: EOFs of the reanalysis field were not computed by the learning.\n",
+                       __FILE__, i, cat);
+        return -1;
+      }
+      if (data->learning->rea_nlon != nlon || data->learning->rea_nlat != nlat || data->learning->rea_neof != neof) {
+        (void) fprintf(stderr, "%s: ERROR: Large-scale field #%d of category %d does not have the same dimensions as the reanalysis field of the learning. Cannot use computed EOFs: nlon=%d nlat=%d neof=%d. Expected: nlon=%d nlat=%d neof=%d.\n",
+                       __FILE__, i, cat, nlon, nlat, neof, data->learning->rea_nlon, data->learning->rea_nlat, data->learning->rea_neof);
+        return -1;
+      }
+      for (j=0; j<nlon*nlat; j++)
+        if (fabs(data->field[cat].lon_ls[j] - data->learning->rea_lon[j]) > COORD_TOLERANCE ||
+            fabs(data->field[cat].lat_ls[j] - data->learning->rea_lat[j]) > COORD_TOLERANCE) {
+          (void) fprintf(stderr, "%s: ERROR: Large-scale field #%d of category %d is not on the same grid as the reanalysis field of the learning. Cannot use computed EOFs: lon=%lf lat=%lf. Expected: lon=%lf lat=%lf.\n",
+                         __FILE__, i, cat, data->field[cat].lon_ls[j], data->field[cat].lat_ls[j],
+                         data->learning->rea_lon[j], data->learning->rea_lat[j]);
+          return -1;
+        }
+
+      (void) fprintf(stdout, "%s: Using the %d EOFs of the reanalysis field computed by the learning for large-scale field %s.\n",
+                     __FILE__, neof, cur->nomvar_ls);
+      cur->eof_data->eof_ls = (double *) malloc(nlon*nlat*neof * sizeof(double));
+      if (cur->eof_data->eof_ls == NULL) alloc_error(__FILE__, __LINE__);
+      (void) memcpy(cur->eof_data->eof_ls, data->learning->rea_eof_ls, nlon*nlat*neof * sizeof(double));
+      cur->eof_data->sing_ls = (double *) malloc(neof * sizeof(double));
+      if (cur->eof_data->sing_ls == NULL) alloc_error(__FILE__, __LINE__);
+      (void) memcpy(cur->eof_data->sing_ls, data->learning->rea->sing, neof * sizeof(double));
+
+      /* EOF coordinates are the large-scale field subdomain coordinates */
+      if (data->field[cat].lon_eof_ls == NULL) {
+        data->field[cat].lon_eof_ls = (double *) malloc(nlon*nlat * sizeof(double));
+        if (data->field[cat].lon_eof_ls == NULL) alloc_error(__FILE__, __LINE__);
+        data->field[cat].lat_eof_ls = (double *) malloc(nlon*nlat * sizeof(double));
+        if (data->field[cat].lat_eof_ls == NULL) alloc_error(__FILE__, __LINE__);
+        (void) memcpy(data->field[cat].lon_eof_ls, data->field[cat].lon_ls, nlon*nlat * sizeof(double));
+        (void) memcpy(data->field[cat].lat_eof_ls, data->field[cat].lat_ls, nlon*nlat * sizeof(double));
+        data->field[cat].nlon_eof_ls = nlon;
+        data->field[cat].nlat_eof_ls = nlat;
+      }
+
+      /* EOF attributes */
+      cur->eof_info->info->fillvalue = data->learning->rea_fillvalue;
+      (void) free(cur->eof_info->info->coordinates);
+      (void) free(cur->eof_info->info->grid_mapping);
+      (void) free(cur->eof_info->info->units);
+      (void) free(cur->eof_info->info->height);
+      (void) free(cur->eof_info->info->long_name);
+      cur->eof_info->info->coordinates = strdup(cur->info->coordinates);
+      cur->eof_info->info->grid_mapping = strdup(cur->info->grid_mapping);
+      cur->eof_info->info->units = strdup("1");
+      cur->eof_info->info->height = strdup(cur->info->height);
+      cur->eof_info->info->long_name = strdup("Empirical Orthogonal Functions");
+
+      /* If we want to save EOF in NetCDF output file for further use */
+      if (cur->eof_info->eof_save == TRUE) {
+        istat = create_netcdf("Computed EOF", "EOF calculees", "Computed EOF and singular values", "EOF et valeurs singulieres calculees",
+                              "EOF", "C language", data->info->software,
+                              "Computed EOF and singular values", data->info->institution,
+                              data->info->creator_email, data->info->creator_url, data->info->creator_name,
+                              data->info->version, data->info->scenario, data->info->scenario_co2, data->info->model,
+                              data->info->institution_model, data->info->country, data->info->member,
+                              data->info->downscaling_forcing, data->info->contact_email, data->info->contact_name,
+                              data->info->other_contact_email, data->info->other_contact_name,
+                              cur->eof_info->eof_fileout_ls, TRUE, data->conf->format, data->conf->compression);
+        if (istat != 0) return istat;
+        istat = write_netcdf_eof(cur->eof_data->eof_ls, cur->eof_data->sing_ls, cur->eof_info->info->fillvalue,
+                                 data->field[cat].lon_eof_ls, data->field[cat].lat_eof_ls, cur->eof_info->eof_fileout_ls,
+                                 cur->eof_data->eof_nomvar_ls, cur->eof_data->sing_nomvar_ls, cur->eof_info->eof_coords,
+                                 data->conf->lonname_eof, data->conf->latname_eof,
+                                 data->conf->dimxname_eof, data->conf->dimyname_eof, data->conf->eofname, nlon, nlat, neof);
+        if (istat != 0) return istat;
+      }
+    }
+
+  /* Diagnostic status */
+  return 0;
+}
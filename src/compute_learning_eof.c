@@ -0,0 +1,296 @@
+/* ***************************************************** */
+/* compute_learning_eof Compute EOF and                  */
+/* singular values of learning period.                   */
+/* compute_learning_eof.c                                */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file compute_learning_eof.c
+    \brief Compute EOF, singular values and principal components of reanalysis and observation data for learning period.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+static int compute_learning_eof_pc(double **eof, double **sing, double **pc, double *bufin, double missing_value,
+                                   tstruct *timein_ts, data_struct *data, int ni, int nj, int ntime, int neof);
+
+/** Compute EOFs, singular values and normalized principal components of a field, after removing its seasonal cycle. */
+static int
+compute_learning_eof_pc(double **eof, double **sing, double **pc, double *bufin, double missing_value,
+                        tstruct *timein_ts, data_struct *data, int ni, int nj, int ntime, int neof) {
+  /**
+     @param[out] eof            EOFs 3D (ni x nj x neof)
+     @param[out] sing           Singular values (neof)
+     @param[out] pc             Principal components normalized by the singular values 2D (neof x ntime)
+     @param[in]  bufin          Input field 3D (ni x nj x ntime)
+     @param[in]  missing_value  Missing value of bufin
+     @param[in]  timein_ts      Time vector of bufin
+     @param[in]  data           MASTER data structure
+     @param[in]  ni             Horizontal dimension
+     @param[in]  nj             Horizontal dimension
+     @param[in]  ntime          Temporal dimension
+     @param[in]  neof           EOF dimension
+
+     \return                    Status.
+  */
+
+  double *bufnoclim = NULL; /* Field with seasonal cycle removed */
+  double *clim = NULL; /* Climatology */
+  int istat; /* Diagnostic status */
+  int eofi; /* Loop counter */
+  int i; /* Loop counter */
+  int t; /* Loop counter */
+
+  /* Remove seasonal cycle, keeping missing values */
+  bufnoclim = (double *) malloc(ni*nj*ntime * sizeof(double));
+  if (bufnoclim == NULL) alloc_error(__FILE__, __LINE__);
+  clim = (double *) malloc(ni*nj*366 * sizeof(double));
+  if (clim == NULL) alloc_error(__FILE__, __LINE__);
+  (void) remove_seasonal_cycle(bufnoclim, clim, bufin, timein_ts, missing_value,
+                               data->conf->clim_filter_width, data->conf->clim_filter_type, FALSE, ni, nj, ntime);
+  (void) free(clim);
+  for (i=0; i<ni*nj*ntime; i++)
+    if (bufin[i] == missing_value)
+      bufnoclim[i] = missing_value;
+
+  /* Compute EOFs and singular values */
+  (*eof) = (double *) malloc(ni*nj*neof * sizeof(double));
+  if ((*eof) == NULL) alloc_error(__FILE__, __LINE__);
+  (*sing) = (double *) malloc(neof * sizeof(double));
+  if ((*sing) == NULL) alloc_error(__FILE__, __LINE__);
+  istat = compute_eof((*eof), (*sing), bufnoclim, missing_value, data->learning->eof_compute, ni, nj, ntime, neof);
+  if (istat != 0) {
+    (void) free(bufnoclim);
+    return istat;
+  }
+
+  /* Principal components: project the field onto EOFs exactly as the large-scale fields are when downscaling, */
+  /* and normalize them by the singular values as the principal components of learning EOF files */
+  (*pc) = (double *) malloc(neof*ntime * sizeof(double));
+  if ((*pc) == NULL) alloc_error(__FILE__, __LINE__);
+  istat = project_field_eof((*pc), bufnoclim, (*eof), (*sing), missing_value, (double *) NULL, (double *) NULL, 1.0,
+                            ni, nj, ntime, neof);
+  (void) free(bufnoclim);
+  if (istat != 0) return istat;
+  for (eofi=0; eofi<neof; eofi++)
+    for (t=0; t<ntime; t++)
+      (*pc)[t+eofi*ntime] = (*pc)[t+eofi*ntime] / (*sing)[eofi];
+
+  /* Success status */
+  return 0;
+}
+
+/** Compute EOFs, singular values and principal components of reanalysis and observation data for learning period, instead of reading them. */
+int
+compute_learning_eof(data_struct *data) {
+  /**
+     @param[in]  data  MASTER data structure.
+     
+     \return           Status.
+  */
+
+  time_vect_struct *time_s = NULL; /* Time structure of reanalysis field file */
+  time_vect_struct *dest_s[3]; /* Learning, observation and reanalysis time structures of learning period */
+  time_vect_struct *cur = NULL; /* Current time structure */
+  tstruct *timein_ts = NULL; /* Time vector of learning period */
+  double *timeval = NULL; /* Time values of reanalysis field file */
+  char *cal_type = NULL; /* Calendar type (udunits) */
+  char *time_units = NULL; /* Time units (udunits) */
+  double *buf = NULL; /* Field over learning period */
+  double *lon = NULL; /* Longitudes of observation field */
+  double *lat = NULL; /* Latitudes of observation field */
+  double *eof = NULL; /* EOFs of observation field */
+  double missing_value; /* Missing value */
+  int ntime_file; /* Number of times in reanalysis field file */
+  int ntime; /* Number of times in learning period */
+  int nlon; /* Longitude dimension of observation field */
+  int nlat; /* Latitude dimension of observation field */
+  int istat; /* Diagnostic status */
+  int t; /* Loop counter */
+  int tl; /* Loop counter */
+  int n; /* Loop counter */
+
+  /* Learning period: days of reanalysis field file within year_begin and year_end */
+  time_s = (time_vect_struct *) malloc(sizeof(time_vect_struct));
+  if (time_s == NULL) alloc_error(__FILE__, __LINE__);
+  istat = get_time_info(time_s, &timeval, &time_units, &cal_type, &ntime_file, data->learning->filename_rea_field,
+                        data->learning->rea_timename, TRUE);
+  (void) free(cal_type);
+  (void) free(time_units);
+  (void) free(timeval);
+  if (istat < 0) {
+    (void) free(time_s);
+    return -1;
+  }
+  ntime = 0;
+  for (t=0; t<ntime_file; t++)
+    if (time_s->year[t] >= data->learning->year_begin && time_s->year[t] <= data->learning->year_end)
+      ntime++;
+  if (ntime < 2) {
+    (void) fprintf(stderr, "%s: ERROR: Reanalysis field file %s has %d timesteps between years %d and %d. Cannot compute learning EOFs.\n",
+                   __FILE__, data->learning->filename_rea_field, ntime, data->learning->year_begin, data->learning->year_end);
+    istat = -1;
+  }
+  else {
+    data->learning->ntime = ntime;
+    data->learning->obs->ntime = ntime;
+    data->learning->rea->ntime = ntime;
+    dest_s[0] = data->learning->time_s;
+    dest_s[1] = data->learning->obs->time_s;
+    dest_s[2] = data->learning->rea->time_s;
+    for (n=0; n<3; n++) {
+      cur = dest_s[n];
+      cur->year = (int *) malloc(ntime * sizeof(int));
+      if (cur->year == NULL) alloc_error(__FILE__, __LINE__);
+      cur->month = (int *) malloc(ntime * sizeof(int));
+      if (cur->month == NULL) alloc_error(__FILE__, __LINE__);
+      cur->day = (int *) malloc(ntime * sizeof(int));
+      if (cur->day == NULL) alloc_error(__FILE__, __LINE__);
+      cur->hour = (int *) malloc(ntime * sizeof(int));
+      if (cur->hour == NULL) alloc_error(__FILE__, __LINE__);
+      cur->minutes = (int *) malloc(ntime * sizeof(int));
+      if (cur->minutes == NULL) alloc_error(__FILE__, __LINE__);
+      cur->seconds = (double *) malloc(ntime * sizeof(double));
+      if (cur->seconds == NULL) alloc_error(__FILE__, __LINE__);
+      tl = 0;
+      for (t=0; t<ntime_file; t++)
+        if (time_s->year[t] >= data->learning->year_begin && time_s->year[t] <= data->learning->year_end) {
+          cur->year[tl] = time_s->year[t];
+          cur->month[tl] = time_s->month[t];
+          cur->day[tl] = time_s->day[t];
+          cur->hour[tl] = time_s->hour[t];
+          cur->minutes[tl] = time_s->minutes[t];
+          cur->seconds[tl] = time_s->seconds[t];
+          tl++;
+        }
+    }
+  }
+  (void) free(time_s->year);
+  (void) free(time_s->month);
+  (void) free(time_s->day);
+  (void) free(time_s->hour);
+  (void) free(time_s->minutes);
+  (void) free(time_s->seconds);
+  (void) free(time_s);
+  if (istat != 0) return istat;
+
+  timein_ts = (tstruct *) malloc(ntime * sizeof(tstruct));
+  if (timein_ts == NULL) alloc_error(__FILE__, __LINE__);
+  for (t=0; t<ntime; t++) {
+    timein_ts[t].year = data->learning->time_s->year[t];
+    timein_ts[t].month = data->learning->time_s->month[t];
+    timein_ts[t].day = data->learning->time_s->day[t];
+    timein_ts[t].hour = data->learning->time_s->hour[t];
+    timein_ts[t].min = data->learning->time_s->minutes[t];
+    timein_ts[t].sec = (float) data->learning->time_s->seconds[t];
+  }
+
+  /** Reanalysis large-scale field on the large-scale domain: its EOFs are also used to project large-scale fields **/
+  istat = read_field_subdomain_period(&buf, &(data->learning->rea_lon), &(data->learning->rea_lat), &missing_value,
+                                      data->learning->nomvar_rea_field, data->learning->time_s->year,
+                                      data->learning->time_s->month, data->learning->time_s->day,
+                                      data->conf->longitude_min, data->conf->longitude_max,
+                                      data->conf->latitude_min, data->conf->latitude_max,
+                                      data->learning->rea_coords, data->learning->rea_gridname,
+                                      data->learning->rea_lonname, data->learning->rea_latname,
+                                      data->learning->rea_dimxname, data->learning->rea_dimyname,
+                                      data->learning->rea_timename, data->learning->filename_rea_field,
+                                      &(data->learning->rea_nlon), &(data->learning->rea_nlat), ntime);
+  if (istat != 0) {
+    (void) free(timein_ts);
+    return istat;
+  }
+  data->learning->rea_fillvalue = missing_value;
+  (void) fprintf(stdout, "%s: Computing %d EOFs of reanalysis field %s over %d timesteps of the learning period.\n", __FILE__,
+                 data->learning->rea_neof, data->learning->nomvar_rea_field, ntime);
+  istat = compute_learning_eof_pc(&(data->learning->rea_eof_ls), &(data->learning->rea->sing), &(data->learning->rea->eof),
+                                  buf, missing_value, timein_ts, data, data->learning->rea_nlon, data->learning->rea_nlat,
+                                  ntime, data->learning->rea_neof);
+  (void) free(buf);
+  if (istat != 0) {
+    (void) free(timein_ts);
+    return istat;
+  }
+
+  /** Observation field over the same days **/
+  if (data->learning->obs_neof != 0) {
+    istat = read_obs_period(&buf, &lon, &lat, &missing_value, data, data->learning->nomvar_obs_field,
+                            data->learning->time_s->year, data->learning->time_s->month, data->learning->time_s->day,
+                            &nlon, &nlat, ntime);
+    if (istat == -2)
+      (void) fprintf(stderr, "%s: ERROR: Observation variable %s used to compute learning EOFs is not in the observations settings.\n",
+                     __FILE__, data->learning->nomvar_obs_field);
+    if (istat < 0) {
+      (void) free(timein_ts);
+      return -1;
+    }
+    (void) free(lon);
+    (void) free(lat);
+    (void) fprintf(stdout, "%s: Computing %d EOFs of observation field %s over %d timesteps of the learning period.\n", __FILE__,
+                   data->learning->obs_neof, data->learning->nomvar_obs_field, ntime);
+    istat = compute_learning_eof_pc(&eof, &(data->learning->obs->sing), &(data->learning->obs->eof), buf, missing_value,
+                                    timein_ts, data, nlon, nlat, ntime, data->learning->obs_neof);
+    (void) free(buf);
+    (void) free(eof);
+    if (istat != 0) {
+      (void) free(timein_ts);
+      return istat;
+    }
+  }
+
+  (void) free(timein_ts);
+
+  /* Diagnostic status */
+  return 0;
+}
@@ -0,0 +1,267 @@
+/* ***************************************************** */
+/* Downscale several scenarios sharing                   */
+/* the same learning data.                               */
+/* downscale_batch.c                                     */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file downscale_batch.c
+    \brief Downscale several scenarios sharing the same learning data.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+static int downscale_batch_scenario(data_struct *data, char *fileconf);
+
+/** Downscale one scenario configuration with the learning data, regression points and masks already loaded. */
+static int
+downscale_batch_scenario(data_struct *data, char *fileconf) {
+  /**
+     @param[in]  data      MASTER data structure holding the learning data.
+     @param[in]  fileconf  Configuration file of the scenario.
+     
+     \return               Status.
+  */
+
+  data_struct *scen = NULL; /* Data structure of the scenario */
+  short int downscale = FALSE; /* If we want to downscale at least one period, excluding control */
+  int istat; /* Diagnostic status */
+  int s; /* Loop counter for seasons */
+  int i; /* Loop counter */
+  int perf; /* Performance measurement stage */
+
+  scen = (data_struct *) malloc(sizeof(data_struct));
+  if (scen == NULL) alloc_error(__FILE__, __LINE__);
+
+  (void) printf("\n**** LOADING SCENARIO CONFIGURATION %s ****\n\n", fileconf);
+  perf = perf_begin("configuration");
+  istat = load_conf(scen, fileconf);
+  (void) perf_end(perf);
+  if (istat != 0) {
+    (void) fprintf(stderr, "%s: Error in loading scenario configuration file %s.\n", __FILE__, fileconf);
+    return istat;
+  }
+
+  /* The scenario must use the same seasons and clusters as the learning data */
+  if (scen->conf->nseasons != data->conf->nseasons) {
+    (void) fprintf(stderr, "%s: Scenario %s has %d seasons while learning data has %d seasons.\n", __FILE__, fileconf,
+                   scen->conf->nseasons, data->conf->nseasons);
+    return -1;
+  }
+  for (s=0; s<scen->conf->nseasons; s++) {
+    if (scen->conf->season[s].nclusters == -1)
+      scen->conf->season[s].nclusters = data->conf->season[s].nclusters;
+    if (scen->conf->season[s].nreg == -1)
+      scen->conf->season[s].nreg = data->conf->season[s].nreg;
+    if (scen->conf->season[s].nclusters != data->conf->season[s].nclusters ||
+        scen->conf->season[s].nreg != data->conf->season[s].nreg) {
+      (void) fprintf(stderr, "%s: Scenario %s season #%d has %d clusters and %d regression variables while learning data has %d and %d.\n",
+                     __FILE__, fileconf, s, scen->conf->season[s].nclusters, scen->conf->season[s].nreg,
+                     data->conf->season[s].nclusters, data->conf->season[s].nreg);
+      return -1;
+    }
+  }
+
+  /* Reuse analog data of an interrupted run or of the cache, before sharing the learning data with the scenario */
+  (void) reuse_analog_data(scen);
+
+  /* Share read-only learning data, regression points and masks. The structures loaded with the scenario configuration are
+     not freed: the scenario runs in its own process, or its memory is only released at exit when fork is not available. */
+  scen->learning = data->learning;
+  scen->reg = data->reg;
+  scen->secondary_mask = data->secondary_mask;
+  scen->conf->learning_maskfile = data->conf->learning_maskfile;
+
+  for (i=0; i<scen->conf->nperiods; i++)
+    if (scen->conf->period[i].downscale == TRUE)
+      downscale = TRUE;
+  if (scen->conf->period_ctrl->downscale == TRUE || downscale == TRUE) {
+    (void) printf("\n**** DOWNSCALING SCENARIO %s ****\n\n", fileconf);
+    perf = perf_begin("downscaling");
+    istat = wt_downscaling(scen);
+    (void) perf_end(perf);
+    if (istat != 0) {
+      (void) fprintf(stderr, "%s: Error in performing downscaling of scenario %s.\n", __FILE__, fileconf);
+      return istat;
+    }
+  }
+
+  /* Write performance report of the scenario */
+  if (scen->conf->perf_report != NULL)
+    (void) write_perf_report(scen->conf->perf_report);
+
+  return 0;
+}
+
+/** Downscale all scenario configurations listed in a file, sharing the learning data, regression points and masks
+    already loaded in the MASTER data structure. Up to njobs scenarios are processed concurrently, each in its own process. */
+int
+downscale_batch(data_struct *data, char *filebatch, int njobs) {
+  /**
+     @param[in]  data       MASTER data structure holding the learning data.
+     @param[in]  filebatch  File listing one scenario configuration file per line. Empty lines and lines beginning with # are ignored.
+     @param[in]  njobs      Maximum number of scenarios processed concurrently.
+     
+     \return                Status.
+  */
+
+  FILE *infile = NULL; /* Batch list file */
+  char **fileconf = NULL; /* Scenario configuration files */
+  char *line = NULL; /* Line of batch list file */
+  char *eol = NULL; /* End of line */
+  int nscen = 0; /* Number of scenarios */
+  int nfailed = 0; /* Number of failed scenarios */
+  int scen; /* Loop counter for scenarios */
+  int istat; /* Diagnostic status */
+#if defined(HAVE_FORK) && defined(HAVE_SYS_WAIT_H)
+  pid_t *pid = NULL; /* Process identifier of each scenario */
+  pid_t done; /* Process identifier of a finished scenario */
+  int running = 0; /* Number of scenarios being processed */
+  int status; /* Exit status of a finished scenario */
+  int ss; /* Loop counter for scenarios */
+#endif
+
+  /* Read scenario configuration filenames */
+  infile = fopen(filebatch, "r");
+  if (infile == NULL) {
+    (void) fprintf(stderr, "%s: Cannot open batch list file %s: %s\n", __FILE__, filebatch, strerror(errno));
+    return -1;
+  }
+  line = (char *) malloc(MAXPATH * sizeof(char));
+  if (line == NULL) alloc_error(__FILE__, __LINE__);
+  while (fgets(line, MAXPATH, infile) != NULL) {
+    eol = strpbrk(line, "\r\n");
+    if (eol != NULL)
+      *eol = '\0';
+    if (line[0] == '\0' || line[0] == '#')
+      continue;
+    fileconf = (char **) realloc(fileconf, (nscen+1) * sizeof(char *));
+    if (fileconf == NULL) alloc_error(__FILE__, __LINE__);
+    fileconf[nscen++] = strdup(line);
+  }
+  (void) fclose(infile);
+  (void) free(line);
+
+  if (nscen == 0) {
+    (void) fprintf(stderr, "%s: No scenario configuration file in batch list file %s.\n", __FILE__, filebatch);
+    return -1;
+  }
+  if (njobs < 1)
+    njobs = 1;
+  (void) printf("%s: Downscaling %d scenarios, %d at a time.\n", __FILE__, nscen, njobs);
+
+#if defined(HAVE_FORK) && defined(HAVE_SYS_WAIT_H)
+  /* Each scenario runs in a child process which inherits the learning data without copying it */
+  pid = (pid_t *) malloc(nscen * sizeof(pid_t));
+  if (pid == NULL) alloc_error(__FILE__, __LINE__);
+  for (scen=0; scen<=nscen; scen++) {
+    /* Wait for a scenario to finish when all jobs are busy, or for all remaining ones at the end */
+    while (running > 0 && (running >= njobs || scen == nscen)) {
+      done = wait(&status);
+      if (done < 0) break;
+      running--;
+      for (ss=0; ss<scen; ss++)
+        if (pid[ss] == done) {
+          if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            (void) fprintf(stderr, "%s: Scenario %s failed.\n", __FILE__, fileconf[ss]);
+            nfailed++;
+          }
+          else
+            (void) printf("%s: Scenario %s done.\n", __FILE__, fileconf[ss]);
+        }
+    }
+    if (scen == nscen)
+      break;
+
+    /* Avoid duplicating buffered output in the child */
+    (void) fflush(stdout);
+    (void) fflush(stderr);
+    pid[scen] = fork();
+    if (pid[scen] == 0) {
+      /* Measure the performance of this scenario only */
+      (void) perf_reset();
+      istat = downscale_batch_scenario(data, fileconf[scen]);
+      (void) fflush(stdout);
+      _exit( (istat == 0) ? 0 : 1 );
+    }
+    else if (pid[scen] < 0) {
+      (void) fprintf(stderr, "%s: Cannot create process for scenario %s: %s\n", __FILE__, fileconf[scen], strerror(errno));
+      nfailed++;
+    }
+    else
+      running++;
+  }
+  (void) free(pid);
+#else
+  /* Process scenarios in sequence */
+  for (scen=0; scen<nscen; scen++) {
+    istat = downscale_batch_scenario(data, fileconf[scen]);
+    if (istat != 0) {
+      (void) fprintf(stderr, "%s: Scenario %s failed.\n", __FILE__, fileconf[scen]);
+      nfailed++;
+    }
+  }
+#endif
+
+  for (scen=0; scen<nscen; scen++)
+    (void) free(fileconf[scen]);
+  (void) free(fileconf);
+
+  if (nfailed > 0) {
+    (void) fprintf(stderr, "%s: %d of %d scenarios failed.\n", __FILE__, nfailed, nscen);
+    return -1;
+  }
+
+  return 0;
+}
@@ -80,9 +80,13 @@ int main(int argc, char **argv)
   data_struct *data = NULL; /* Main data structure */
   short int license_accept = 0; /* If user has accepted license or not */
   short int downscale = TRUE; /* If we want to downscale at least one period, excluding control */
+  int perf; /* Performance measurement stage */
   
   /* Command-line arguments variables */
   char fileconf[500]; /* Configuration filename */
+  char *filebatch = NULL; /* Batch list of scenario configuration filenames */
+  char *socketpath = NULL; /* Unix-domain socket path of service mode */
+  int njobs = 1; /* Number of scenarios processed concurrently in batch mode */
 
   /* Show license so user can accept or deny it. */
   license_accept = show_license();
@@ -97,6 +101,9 @@ int main(int argc, char **argv)
   /* Print BEGIN banner */
   (void) banner(PACKAGE_NAME, PACKAGE_VERSION, "BEGIN");
 
+  /* Origin of performance measurements of downscaling stages */
+  (void) perf_reset();
+
   /* Allocate memory */
   data = (data_struct *) malloc(sizeof(data_struct));
   if (data == NULL) alloc_error(__FILE__, __LINE__);
@@ -113,6 +120,12 @@ int main(int argc, char **argv)
     for (i=1; i<argc; i++) {
       if ( !strcmp(argv[i], "-conf") )
         (void) strcpy(fileconf, argv[++i]);
+      else if ( !strcmp(argv[i], "-batch") )
+        filebatch = argv[++i];
+      else if ( !strcmp(argv[i], "-serve") )
+        socketpath = argv[++i];
+      else if ( !strcmp(argv[i], "-jobs") )
+        njobs = (int) strtol(argv[++i], (char **)NULL, 10);
       else if ( !strcmp(argv[i], "--version") ) {
         (void) printf("%s version %s\n\n", PACKAGE_NAME, PACKAGE_VERSION);
         (void) banner(PACKAGE_NAME, "OK", "END");
@@ -129,13 +142,19 @@ int main(int argc, char **argv)
   /* Read and store configuration file in memory */
   /* Allocate memory for main data structures */
   (void) printf("\n**** LOADING CONFIGURATION ****\n\n");
+  perf = perf_begin("configuration");
   istat = load_conf(data, fileconf);
+  (void) perf_end(perf);
   if (istat != 0) {
     (void) fprintf(stderr, "%s: Error in loading configuration file. Aborting.\n", __FILE__);
     (void) banner(PACKAGE_NAME, "ABORT", "END");
     (void) abort();
   }
 
+  /* Reuse analog data of an interrupted run or of the cache. In batch and service modes, this configuration only */
+  /* provides the learning and is not downscaled itself. */
+  if (filebatch == NULL && socketpath == NULL)
+    (void) reuse_analog_data(data);
 
   /* Generate analog data only if we are not reading it off disk */
   if (data->conf->output_only == FALSE) {
@@ -143,7 +162,9 @@ int main(int argc, char **argv)
     /* Read regression points positions if needed */
     if (data->reg->filename != NULL) {
       (void) printf("\n**** READING REGRESSION POSITIONS ****\n\n");
+      perf = perf_begin("regression_points");
       istat = read_regression_points(data->reg);
+      (void) perf_end(perf);
       if (istat != 0) {
         (void) fprintf(stderr, "%s: Error in reading regression points positions. Aborting.\n", __FILE__);
         (void) banner(PACKAGE_NAME, "ABORT", "END");
@@ -154,7 +175,9 @@ int main(int argc, char **argv)
     /* Read mask for secondary large-scale fields if needed */
     if (data->secondary_mask->use_mask == TRUE) {
       (void) printf("\n**** SECONDARY LARGE-SCALE FIELDS MASK ****\n\n");
+      perf = perf_begin("masks");
       istat = read_mask(data->secondary_mask);
+      (void) perf_end(perf);
       if (istat != 0) {
         (void) fprintf(stderr, "%s: Error in reading secondary large-scale mask file. Aborting.\n", __FILE__);
         (void) banner(PACKAGE_NAME, "ABORT", "END");
@@ -165,7 +188,9 @@ int main(int argc, char **argv)
     /* Read mask for learning fields if needed */
     if (data->conf->learning_maskfile->use_mask == TRUE) {
       (void) printf("\n**** LEARNING FIELDS MASK ****\n\n");
+      perf = perf_begin("masks");
       istat = read_mask(data->conf->learning_maskfile);
+      (void) perf_end(perf);
       if (istat != 0) {
         (void) fprintf(stderr, "%s: Error in reading learning mask file. Aborting.\n", __FILE__);
         (void) banner(PACKAGE_NAME, "ABORT", "END");
@@ -175,7 +200,9 @@ int main(int argc, char **argv)
 
     /* If wanted, generate learning data */
     (void) printf("\n**** LEARNING ****\n\n");
+    perf = perf_begin("learning");
     istat = wt_learning(data);
+    (void) perf_end(perf);
     if (istat != 0) {
       (void) fprintf(stderr, "%s: Error in computing or reading learning data needed for downscaling. Aborting.\n", __FILE__);
       (void) banner(PACKAGE_NAME, "ABORT", "END");
@@ -183,16 +210,44 @@ int main(int argc, char **argv)
     }
   }
   
+  /* Batch mode: downscale all listed scenarios with the learning data loaded once */
+  if (filebatch != NULL) {
+    (void) printf("\n**** BATCH DOWNSCALING ****\n\n");
+    perf = perf_begin("batch");
+    istat = downscale_batch(data, filebatch, njobs);
+    (void) perf_end(perf);
+    if (istat != 0) {
+      (void) fprintf(stderr, "%s: Error in performing batch downscaling. Aborting.\n", __FILE__);
+      (void) banner(PACKAGE_NAME, "ABORT", "END");
+      (void) abort();
+    }
+  }
+
+  /* Service mode: downscale jobs received over a local socket with the learning data loaded once */
+  if (socketpath != NULL) {
+    (void) printf("\n**** SERVICE MODE ****\n\n");
+    perf = perf_begin("service");
+    istat = serve_downscaling(data, socketpath, njobs);
+    (void) perf_end(perf);
+    if (istat != 0) {
+      (void) fprintf(stderr, "%s: Error in service mode. Aborting.\n", __FILE__);
+      (void) banner(PACKAGE_NAME, "ABORT", "END");
+      (void) abort();
+    }
+  }
+
   /* Perform downscaling */
   downscale = FALSE;
   for (i=0; i<data->conf->nperiods; i++)
     if (data->conf->period[i].downscale == TRUE)
       downscale = TRUE;
-  if (data->conf->period_ctrl->downscale == TRUE || downscale == TRUE) {
+  if (filebatch == NULL && socketpath == NULL && (data->conf->period_ctrl->downscale == TRUE || downscale == TRUE)) {
     (void) printf("\n**** DOWNSCALING ****\n\n");
     if (data->conf->output_only == TRUE)
       (void) printf("****WARNING: Configuration for reading analog dates and writing data ONLY!\n\n");
+    perf = perf_begin("downscaling");
     istat = wt_downscaling(data);
+    (void) perf_end(perf);
     if (istat != 0) {
       (void) fprintf(stderr, "%s: Error in performing downscaling. Aborting.\n", __FILE__);
       (void) banner(PACKAGE_NAME, "ABORT", "END");
@@ -200,10 +255,17 @@ int main(int argc, char **argv)
     }
   }
   
+  /* Write performance report of downscaling stages */
+  if (data->conf->perf_report != NULL) {
+    (void) printf("\n**** PERFORMANCE REPORT ****\n\n");
+    (void) write_perf_report(data->conf->perf_report);
+  }
+
   /* Free main data structure */
   (void) printf("\n**** FREE MEMORY ****\n\n");
   (void) free_main_data(data);
   (void) free(data);
+  (void) perf_free();
 
   /* Print END banner */
   (void) banner(PACKAGE_NAME, "OK", "END");
@@ -223,6 +285,9 @@ show_usage(char *pgm) {
 
   (void) fprintf(stderr, "%s:: usage:\n", pgm);
   (void) fprintf(stderr, "-conf: configuration file\n");
+  (void) fprintf(stderr, "-batch: file listing scenario configuration files to downscale with the learning of the configuration file\n");
+  (void) fprintf(stderr, "-serve: Unix-domain socket path on which to accept downscaling jobs using the learning of the configuration file\n");
+  (void) fprintf(stderr, "-jobs: number of scenarios or jobs downscaled concurrently in batch or service mode (default 1)\n");
 
 }
 
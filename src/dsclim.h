@@ -58,6 +58,30 @@ LICENSE END */
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
 #endif
+#ifdef HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+#ifdef HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+#ifdef HAVE_SIGNAL_H
+#include <signal.h>
+#endif
+#ifdef HAVE_SYS_SOCKET_H
+#include <sys/socket.h>
+#endif
+#ifdef HAVE_SYS_UN_H
+#include <sys/un.h>
+#endif
 #ifdef HAVE_STRING_H
 #include <string.h>
 #endif
@@ -100,9 +124,26 @@ LICENSE END */
 /** Large-scale secondary fields category for control-run. */
 #define CTRL_SEC_FIELD_LS 3
 
+/** No checkpoint: downscaling starts from the beginning. */
+#define CHECKPOINT_NONE 0
+/** Checkpoint after climatology removal of large-scale fields. */
+#define CHECKPOINT_CLIM 1
+/** Checkpoint after projection of large-scale fields on EOFs. */
+#define CHECKPOINT_EOF 2
+/** Checkpoint after distances to clusters, classification and regression index of the downscaled days. */
+#define CHECKPOINT_CLASS 3
+/** Checkpoint after analog days search. */
+#define CHECKPOINT_ANALOG 4
+
+/** Seconds a service client has to send its job request. */
+#define SERVE_READ_TIMEOUT 30
+
 /** Maximum length of paths/filenames strings. */
 #define MAXPATH 5000
 
+/** Tolerance in degrees when comparing the coordinates of two grids. */
+#define COORD_TOLERANCE 1.0e-4
+
 /** Compression level **/
 #define DEFLATE_LEVEL 6
 
@@ -179,7 +220,10 @@ typedef struct {
   int eof_project; /**< If we want to project a large scale field onto its EOF. */
   double eof_scale; /**< Large scale field scaling for projection on EOF. */
   int eof_weight; /**< If we want to apply EOF surface weighting (default is not, scaling weight factor 1.0). */
+  int eof_compute; /**< If EOF and singular values are those of the reanalysis field computed by the learning instead of read from eof_filein_ls. */
+  int eof_save; /**< If we want to save computed EOF and singular values in a file. */
   char *eof_filein_ls; /**< EOF and singular values of large-scale fields input filename. */
+  char *eof_fileout_ls; /**< EOF and singular values of large-scale fields output filename. */
   info_field_struct *info; /**< Information (field attributes) about large scale fields EOF. */
   int neof_ls; /**< EOF dimension of large scale fields. */
   char *eof_coords; /**< EOF coordinates NetCDF (1D or 2D). */
@@ -238,6 +282,7 @@ typedef struct {
   eof_data_struct *eof_data; /**< EOF data. */
   downscale_struct *down; /**< Downscaling fields for large scale fields. */
   double first_variance; /**< Variance of the first EOF. */
+  double *clim_ls; /**< Control-run climatology (366 days) kept to remove it from streamed large-scale fields. */
 } field_data_struct;
 
 /** Data structure to hold field information and data field_struct. */
@@ -306,6 +351,7 @@ typedef struct {
 typedef struct {
   int learning_provided; /**< If learning data is already available and will be read from files. */
   int learning_save; /**< If learning data will be saved in files. */
+  int learning_incremental; /**< If clusters are warm-started from the weights of a previous learning. */
   char *filename_open_weight; /**< Filename for reading weight data in NetCDF format. */
   char *filename_open_learn; /**< Filename for reading learning data in NetCDF format. */
   char *filename_open_clust_learn; /**< Filename for reading clusters learning data in NetCDF format. */
@@ -346,6 +392,18 @@ typedef struct {
   time_vect_struct *time_s; /**< Time structure of the whole learning period. */
   int obs_neof; /**< Number of EOFs for observation data. */
   int rea_neof; /**< Number of EOFs reanalysis data. */
+  int eof_compute; /**< EOF computation method of reanalysis and observation data (FALSE: EOFs are read from files). */
+  int year_begin; /**< 4-digit first year of learning period when EOFs are computed. */
+  int year_end; /**< 4-digit last year of learning period when EOFs are computed. */
+  char *filename_rea_field; /**< Filename for reanalysis large-scale field when EOFs are computed. */
+  char *nomvar_rea_field; /**< NetCDF variable name for reanalysis large-scale field when EOFs are computed. */
+  char *nomvar_obs_field; /**< NetCDF variable name for observation field when EOFs are computed. */
+  double *rea_eof_ls; /**< Computed EOFs of the reanalysis large-scale field, for projecting large-scale fields. */
+  double *rea_lon; /**< Computed EOFs of the reanalysis large-scale field longitudes. */
+  double *rea_lat; /**< Computed EOFs of the reanalysis large-scale field latitudes. */
+  int rea_nlon; /**< Computed EOFs of the reanalysis large-scale field number of longitudes. */
+  int rea_nlat; /**< Computed EOFs of the reanalysis large-scale field number of latitudes. */
+  double rea_fillvalue; /**< Missing value of the computed EOFs of the reanalysis large-scale field. */
   char *rea_coords; /**< Coordinates for reanalysis data (1D or 2D). */
   char *rea_gridname; /**< Grid name for reanalysis data (1D or 2D). */
   char *rea_dimxname; /**< X Dimension name for reanalysis files. */
@@ -434,6 +492,9 @@ typedef struct {
 /** General configuration data structure conf_struct. */
 typedef struct {
   int debug; /**< Debugging flag. */
+  char *perf_report; /**< Performance report filename of downscaling stages, in JSON format (NULL if not used). */
+  int perf_attribute; /**< If we want to write the performance report as a global attribute of output files. */
+  int prefetch_obs; /**< If we want to read ahead the observation files of the next analog dates when writing output. */
   int format; /**< Format for NetCDF output files. */
   int compression; /**< Compression for NetCDF-4 output files. */
   int compression_level; /**< Compression Level for NetCDF-4 output files. */
@@ -443,6 +504,7 @@ typedef struct {
   char *config; /**< Whole configuration file text. */
   int clim_filter_width; /**< Climatology filter width. */
   char *clim_filter_type; /**< Climatology filter type. */
+  int stream_chunk; /**< Number of timesteps read at a time when streaming model run large-scale fields projected onto EOF (0: read whole fields). */
   char *cal_type; /**< Calendar-type for downscaling. */
   char *time_units; /**< Base time units for downscaling. */
   char *dimxname_eof; /**< X Dimension name (EOF file) for downscaling. */
@@ -474,19 +536,48 @@ typedef struct {
   period_struct *period_ctrl; /**< Control run period definition. */
   int downscale; /**< Downscale or not control-run period. */
   char *classif_type; /**< Classification type (euclidian only for now). */
+  char *classif_init; /**< Type of initial cluster centers of classification (random or kmeans++). */
   int nclassifications; /**< Maximum number of classifications. */
   int npartitions; /**< Number of partitions. */
+  double classif_tolerance; /**< Stop classification iterations when no cluster center moves more than this (0: only when stable). */
+  unsigned long int classif_seed; /**< Master seed of the random number generators used to generate partitions. */
+  int nthreads; /**< Number of threads for partitions generation and season-parallel analog days search. */
   var_struct *obs_var; /**< Structure for observation variables information. */
   int analog_save; /**< If we want to save analog data. */
   int output_only; /**< If we just want to output downscaled data using only analog data and observation database. */
   int output; /**< If we want to output downscaled data. */
   char *analog_file_ctrl; /**< Analog data filename for control run. */
   char *analog_file_other; /**< Analog data filename for control run. */
+  char *checkpoint_path; /**< Directory of checkpoint files used to resume an interrupted downscaling (NULL if not used). */
+  char *checkpoint_hash; /**< Hash of configuration and input files validating checkpoint files. */
+  int checkpoint_stage; /**< Last downscaling stage completed according to valid checkpoint files. */
+  int checkpoint_year[NCAT]; /**< Last output year completely written according to valid checkpoint files, for each field category (-1 if none). */
+  char *cache_path; /**< Directory of cached intermediate downscaling products reused across runs (NULL if not used). */
+  char cache_key[CHECKPOINT_ANALOG+1][17]; /**< Keys of configuration and input files of cached products, for each downscaling stage. */
   int use_downscaled_year; /**< If we want to also search the analog day in the year of the current downscaled year. */
   int only_wt; /**< If we want to restrict search to only the same weather type. */
   double deltat; /**< Absolute difference of temperature to use to correct temperature when downscaling and comparing large-scale temperature index. */
 } conf_struct;
 
+/** Performance measurements of a downscaling stage perf_stage_struct. */
+typedef struct {
+  char *name; /**< Stage name. */
+  int parent; /**< Index of the enclosing stage (-1 if none). */
+  int level; /**< Nesting level of the stage. */
+  int ncalls; /**< Number of times the stage was run. */
+  double wall; /**< Wall-clock time in seconds. */
+  double cpu; /**< User and system CPU time of all threads in seconds. */
+  long maxrss; /**< Peak resident set size of the process at the end of the stage in kilobytes. */
+  long maxrss_incr; /**< Increase of the peak resident set size during the stage in kilobytes. */
+  unsigned long long nread; /**< Bytes of data read from NetCDF files. */
+  unsigned long long nwritten; /**< Bytes of data written to NetCDF files. */
+  double wall_begin; /**< Wall-clock time when the stage began. */
+  double cpu_begin; /**< CPU time when the stage began. */
+  long maxrss_begin; /**< Peak resident set size when the stage began. */
+  unsigned long long nread_begin; /**< Bytes read from NetCDF files when the stage began. */
+  unsigned long long nwritten_begin; /**< Bytes written to NetCDF files when the stage began. */
+} perf_stage_struct;
+
 /** MASTER data structure data_struct. */
 typedef struct {
   info_struct *info; /**< Information structure. */
@@ -501,11 +592,17 @@ typedef struct {
 int load_conf(data_struct *data, char *fileconf);
 int wt_downscaling(data_struct *data);
 int wt_learning(data_struct *data);
+int downscale_batch(data_struct *data, char *filebatch, int njobs);
+int serve_downscaling(data_struct *data, char *socketpath, int njobs);
 int read_large_scale_fields(data_struct *data);
 int read_large_scale_eof(data_struct *data);
+int compute_large_scale_eof(data_struct *data);
+int project_large_scale_field_stream(data_struct *data, int cat, int i);
+int warm_start_clusters(double *clusters, double *pc_eof_days, data_struct *data, int s, int ntime);
 int read_learning_obs_eof(data_struct *data);
 int read_learning_rea_eof(data_struct *data);
 int read_learning_fields(data_struct *data);
+int compute_learning_eof(data_struct *data);
 int read_obs_period(double **buffer, double **lon, double **lat, double *missing_value, data_struct *data, char *varname,
                     int *year, int *month, int *day, int *nlon, int *nlat, int ntime);
 int read_field_subdomain_period(double **buffer, double **lon, double **lat, double *missing_value, char *varname,
@@ -521,6 +618,7 @@ int find_the_days(analog_day_struct analog_days, double *precip_index, double *p
                   int *year_learn, int *month_learn, int *day_learn, char *time_units,
                   int ntime, int ntime_learn, int *months, int nmonths, int ndays, int ndayschoices, int npts, int shuffle, int sup,
                   int sup_choice, int sup_cov, int use_downscaled_year, int only_wt, int nlon, int nlat, int sup_nlon, int sup_nlat);
+int find_the_days_seasons(data_struct *data, short int *mask_sub, int *ntime_sub, int cat, int i);
 void compute_secondary_large_scale_diff(double *delta, double **delta_dayschoice, analog_day_struct analog_days, double *sup_field_index,
                                         double *sup_field_index_learn, double sup_field_var, double sup_field_var_learn, int ntimes);
 int merge_seasons(analog_day_struct analog_days_merged, analog_day_struct analog_days, int *merged_itimes, int ntimes_merged, int ntimes);
@@ -535,13 +633,36 @@ int output_downscaled_analog(analog_day_struct analog_days, double *delta, int o
                              int file_format, int file_compression, int file_compression_level,
                              int debug,
                              info_struct *info, var_struct *obs_var, period_struct *period,
-                             double *time_ls, int ntime);
+                             double *time_ls, int ntime, int year_done, char *year_file, char *checkpoint_hash,
+                             int perf_attribute, int prefetch_obs);
+void build_obs_filenames(char **infile, char *format, var_struct *obs_var, int year, int month);
 int write_learning_fields(data_struct *data);
 int write_regression_fields(data_struct *data, char *filename, double **timeval, int *ntime, double **precip_index, double **distclust,
                             double **sup_index);
 void read_analog_data(analog_day_struct *analog_days, double **delta, double **time_ls, char *filename, char *timename);
 void save_analog_data(analog_day_struct analog_days, double *delta, double **delta_dayschoice, double *dist, int *cluster,
                       double *time_ls, char *filename, data_struct *data);
+int checkpoint_hash(data_struct *data);
+int read_checkpoint_state(data_struct *data);
+int write_checkpoint_state(char *filename, char *hash, char *key, int value);
+int save_checkpoint(data_struct *data, int stage, int **ntime_sub);
+int read_checkpoint(data_struct *data, int stage, int **ntime_sub);
+void clean_checkpoint(data_struct *data);
+int write_stage_data(data_struct *data, int stage, int **ntime_sub, char *filename, char *hash);
+int read_stage_data(data_struct *data, int stage, int **ntime_sub, char *filename, char *hash);
+int cache_hash(data_struct *data);
+char *cache_filename(data_struct *data, int stage, char *product);
+int write_cache_array(char *filename, char *key, double *buf, size_t n);
+int read_cache_array(char *filename, char *key, double *buf, size_t n);
+void set_output_only(data_struct *data);
+int reuse_analog_data(data_struct *data);
+int perf_begin(char *name);
+void perf_end(int stage);
+char *perf_report(void);
+void perf_reset(void);
+void perf_free(void);
+int write_perf_report(char *filename);
+int write_perf_attribute(char *filename);
 void free_main_data(data_struct *data);
 const char *get_filename_ext(const char *filename);
 
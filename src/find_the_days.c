@@ -54,6 +54,16 @@ LICENSE END */
 
 #include <dsclim.h>
 
+#ifdef HAVE_PTHREAD_H
+/** udunits is not thread-safe: serialize its use when several seasons are searched concurrently. */
+static pthread_mutex_t find_the_days_udunits_lock = PTHREAD_MUTEX_INITIALIZER;
+#define UDUNITS_LOCK() (void) pthread_mutex_lock(&find_the_days_udunits_lock)
+#define UDUNITS_UNLOCK() (void) pthread_mutex_unlock(&find_the_days_udunits_lock)
+#else
+#define UDUNITS_LOCK()
+#define UDUNITS_UNLOCK()
+#endif
+
 /** Find analog days given cluster, supplemental large-scale field, and precipitation distances. */
 int
 find_the_days(analog_day_struct analog_days, double *precip_index, double *precip_index_learn,
@@ -152,10 +162,12 @@ find_the_days(analog_day_struct analog_days, double *precip_index, double *preci
   double timei; /* udunits Time value */
 
   /* Initialize udunits */
+  UDUNITS_LOCK();
   ut_set_error_message_handler(ut_ignore);
   unitSystem = ut_read_xml(NULL);
   ut_set_error_message_handler(ut_write_to_stderr);
   dataunits = ut_parse(unitSystem, time_units, UT_ASCII);
+  UDUNITS_UNLOCK();
 
   /* Initialize random number generator if needed */
   if (shuffle == TRUE) {
@@ -394,7 +406,9 @@ find_the_days(analog_day_struct analog_days, double *precip_index, double *preci
         analog_days.month[t] = month_learn[analog_days.tindex[t]];
         analog_days.day[t] = day_learn[analog_days.tindex[t]];
         analog_days.tindex_all[t] = buf_learn_sub_i[analog_days.tindex[t]];
+        UDUNITS_LOCK();
         istat = utInvCalendar2(analog_days.year[t], analog_days.month[t], analog_days.day[t], 0, 0, 0.0, dataunits, &timei);
+        UDUNITS_UNLOCK();
         analog_days.time[t] = (int) timei;
 
         /* Save date of day being downscaled */
@@ -463,7 +477,9 @@ find_the_days(analog_day_struct analog_days, double *precip_index, double *preci
         analog_days.month[t] = month_learn[analog_days.tindex[t]];
         analog_days.day[t] = day_learn[analog_days.tindex[t]];
         analog_days.tindex_all[t] = buf_learn_sub_i[analog_days.tindex[t]];
+        UDUNITS_LOCK();
         istat = utInvCalendar2(analog_days.year[t], analog_days.month[t], analog_days.day[t], 0, 0, 0.0, dataunits, &timei);
+        UDUNITS_UNLOCK();
         analog_days.time[t] = (int) timei;
 
         /* Save date of day being downscaled */
@@ -524,8 +540,10 @@ find_the_days(analog_day_struct analog_days, double *precip_index, double *preci
   (void) free(buf_sub_i);
   (void) free(buf_learn_sub_i);
 
+  UDUNITS_LOCK();
   (void) ut_free(dataunits);
   (void) ut_free_system(unitSystem);  
+  UDUNITS_UNLOCK();
       
   return 0;
 }
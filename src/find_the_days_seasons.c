@@ -0,0 +1,228 @@
+/* ***************************************************** */
+/* Find analog days of all seasons,                      */
+/* processing seasons concurrently.                      */
+/* find_the_days_seasons.c                               */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file find_the_days_seasons.c
+    \brief Find analog days of all seasons, processing seasons concurrently.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+/** Shared arguments of the season workers. */
+typedef struct {
+  data_struct *data; /**< MASTER data structure. */
+  short int *mask_sub; /**< Mask for covariance of secondary large-scale field. */
+  int *ntime_sub; /**< Number of times of each season. */
+  int *istat; /**< Status of each season. */
+  int cat; /**< Large-scale field category. */
+  int i; /**< Large-scale field index. */
+  int nthreads; /**< Number of threads. */
+} find_the_days_seasons_work_struct;
+
+/** Arguments of one worker thread. */
+typedef struct {
+  find_the_days_seasons_work_struct *work; /**< Shared arguments. */
+  int first; /**< First season processed by this worker, next ones are spaced by nthreads. */
+} find_the_days_seasons_thread_struct;
+
+static void *find_the_days_seasons_worker(void *arg);
+
+/** Worker searching analog days of its share of the seasons. Each season only writes its own analog days structure. */
+static void *
+find_the_days_seasons_worker(void *arg) {
+
+  find_the_days_seasons_thread_struct *thread = (find_the_days_seasons_thread_struct *) arg; /* Worker arguments */
+  find_the_days_seasons_work_struct *work = thread->work; /* Shared arguments */
+  data_struct *data = work->data; /* MASTER data structure */
+  int cat = work->cat; /* Large-scale field category */
+  int i = work->i; /* Large-scale field index */
+  int s; /* Loop counter for seasons */
+
+  for (s=thread->first; s<data->conf->nseasons; s+=work->nthreads) {
+    (void) printf("%s: Searching analog days for season #%d\n", __FILE__, s);
+    work->istat[s] = find_the_days(data->field[cat].analog_days[s], data->field[cat].precip_index[s], data->learning->data[s].precip_index,
+                                   data->field[cat+2].data[i].down->smean_norm[s], data->learning->data[s].sup_index,
+                                   data->field[cat+2].data[i].down->sup_val_norm[s], data->learning->data[s].sup_val, work->mask_sub,
+                                   data->field[cat].data[i].down->days_class_clusters[s], data->learning->data[s].class_clusters,
+                                   data->field[cat].time_s->year, data->field[cat].time_s->month, data->field[cat].time_s->day,
+                                   data->learning->data[s].time_s->year, data->learning->data[s].time_s->month,
+                                   data->learning->data[s].time_s->day, data->conf->time_units,
+                                   data->field[cat].ntime_ls, data->learning->data[s].ntime,
+                                   data->conf->season[s].month, data->conf->season[s].nmonths,
+                                   data->conf->season[s].ndays, data->conf->season[s].ndayschoices, data->reg->npts,
+                                   data->conf->season[s].shuffle, data->conf->season[s].secondary_choice,
+                                   data->conf->season[s].secondary_main_choice, data->conf->season[s].secondary_cov,
+                                   data->conf->use_downscaled_year, data->conf->only_wt,
+                                   data->field[cat+2].nlon_ls, data->field[cat+2].nlat_ls,
+                                   data->learning->sup_nlon, data->learning->sup_nlat);
+  }
+
+  return NULL;
+}
+
+/** Find analog days of all seasons for one large-scale field. Seasons only share read-only inputs,
+    so they are processed concurrently on up to number_of_threads threads. */
+int
+find_the_days_seasons(data_struct *data, short int *mask_sub, int *ntime_sub, int cat, int i) {
+  /**
+     @param[in,out]  data       MASTER data structure.
+     @param[in]      mask_sub   Mask for covariance of secondary large-scale field.
+     @param[in]      ntime_sub  Number of times of each season.
+     @param[in]      cat        Large-scale field category.
+     @param[in]      i          Large-scale field index.
+     
+     \return                    Status.
+  */
+
+  find_the_days_seasons_work_struct work; /* Shared arguments of workers */
+  find_the_days_seasons_thread_struct *thread = NULL; /* Arguments of each worker */
+  int s; /* Loop counter for seasons */
+  int ii; /* Loop counter */
+  int t; /* Loop counter for threads */
+  int istat = 0; /* Diagnostic status */
+#ifdef HAVE_PTHREAD_H
+  pthread_t *tid = NULL; /* Thread identifiers */
+#endif
+
+  /* Allocate analog days of each season */
+  for (s=0; s<data->conf->nseasons; s++) {
+    data->field[cat].analog_days[s].ntime = ntime_sub[s];
+    data->field[cat].analog_days[s].time = (int *) malloc(ntime_sub[s] * sizeof(int));
+    if (data->field[cat].analog_days[s].time == NULL) alloc_error(__FILE__, __LINE__);
+    data->field[cat].analog_days[s].tindex = (int *) malloc(ntime_sub[s] * sizeof(int));
+    if (data->field[cat].analog_days[s].tindex == NULL) alloc_error(__FILE__, __LINE__);
+    data->field[cat].analog_days[s].tindex_all = (int *) malloc(ntime_sub[s] * sizeof(int));
+    if (data->field[cat].analog_days[s].tindex_all == NULL) alloc_error(__FILE__, __LINE__);
+    data->field[cat].analog_days[s].year = (int *) malloc(ntime_sub[s] * sizeof(int));
+    if (data->field[cat].analog_days[s].year == NULL) alloc_error(__FILE__, __LINE__);
+    data->field[cat].analog_days[s].month = (int *) malloc(ntime_sub[s] * sizeof(int));
+    if (data->field[cat].analog_days[s].month == NULL) alloc_error(__FILE__, __LINE__);
+    data->field[cat].analog_days[s].day = (int *) malloc(ntime_sub[s] * sizeof(int));
+    if (data->field[cat].analog_days[s].day == NULL) alloc_error(__FILE__, __LINE__);
+    data->field[cat].analog_days[s].tindex_s_all = (int *) malloc(ntime_sub[s] * sizeof(int));
+    if (data->field[cat].analog_days[s].tindex_s_all == NULL) alloc_error(__FILE__, __LINE__);
+    data->field[cat].analog_days[s].year_s = (int *) malloc(ntime_sub[s] * sizeof(int));
+    if (data->field[cat].analog_days[s].year_s == NULL) alloc_error(__FILE__, __LINE__);
+    data->field[cat].analog_days[s].month_s = (int *) malloc(ntime_sub[s] * sizeof(int));
+    if (data->field[cat].analog_days[s].month_s == NULL) alloc_error(__FILE__, __LINE__);
+    data->field[cat].analog_days[s].day_s = (int *) malloc(ntime_sub[s] * sizeof(int));
+    if (data->field[cat].analog_days[s].day_s == NULL) alloc_error(__FILE__, __LINE__);
+    data->field[cat].analog_days[s].ndayschoice = (int *) malloc(ntime_sub[s] * sizeof(int));
+    if (data->field[cat].analog_days[s].ndayschoice == NULL) alloc_error(__FILE__, __LINE__);
+    data->field[cat].analog_days[s].analog_dayschoice = (tstruct **) malloc(ntime_sub[s] * sizeof(tstruct *));
+    if (data->field[cat].analog_days[s].analog_dayschoice == NULL) alloc_error(__FILE__, __LINE__);
+    data->field[cat].analog_days[s].metric_norm = (float **) malloc(ntime_sub[s] * sizeof(float *));
+    if (data->field[cat].analog_days[s].metric_norm == NULL) alloc_error(__FILE__, __LINE__);
+    data->field[cat].analog_days[s].tindex_dayschoice = (int **) malloc(ntime_sub[s] * sizeof(int *));
+    if (data->field[cat].analog_days[s].tindex_dayschoice == NULL) alloc_error(__FILE__, __LINE__);
+    for (ii=0; ii<ntime_sub[s]; ii++) {
+      data->field[cat].analog_days[s].ndayschoice[ii] = data->conf->season[s].ndayschoices;
+      data->field[cat].analog_days[s].analog_dayschoice[ii] = (tstruct *) NULL;
+      data->field[cat].analog_days[s].metric_norm[ii] = (float *) NULL;            
+      data->field[cat].analog_days[s].tindex_dayschoice[ii] = (int *) NULL;
+    }
+  }
+
+  work.data = data;
+  work.mask_sub = mask_sub;
+  work.ntime_sub = ntime_sub;
+  work.cat = cat;
+  work.i = i;
+  work.nthreads = (data->conf->nthreads < data->conf->nseasons) ? data->conf->nthreads : data->conf->nseasons;
+  if (work.nthreads < 1)
+    work.nthreads = 1;
+  work.istat = (int *) malloc(data->conf->nseasons * sizeof(int));
+  if (work.istat == NULL) alloc_error(__FILE__, __LINE__);
+
+  thread = (find_the_days_seasons_thread_struct *) malloc(work.nthreads * sizeof(find_the_days_seasons_thread_struct));
+  if (thread == NULL) alloc_error(__FILE__, __LINE__);
+  for (t=0; t<work.nthreads; t++) {
+    thread[t].work = &work;
+    thread[t].first = t;
+  }
+
+#ifdef HAVE_PTHREAD_H
+  tid = (pthread_t *) malloc(work.nthreads * sizeof(pthread_t));
+  if (tid == NULL) alloc_error(__FILE__, __LINE__);
+  /* The calling thread processes the first share itself */
+  for (t=1; t<work.nthreads; t++) {
+    istat = pthread_create(&(tid[t]), NULL, find_the_days_seasons_worker, (void *) &(thread[t]));
+    if (istat != 0) {
+      (void) fprintf(stderr, "%s: ABORT: Cannot create thread %d!\n", __FILE__, t);
+      (void) abort();
+    }
+  }
+  (void) find_the_days_seasons_worker((void *) &(thread[0]));
+  for (t=1; t<work.nthreads; t++)
+    (void) pthread_join(tid[t], NULL);
+  (void) free(tid);
+#else
+  for (t=0; t<work.nthreads; t++)
+    (void) find_the_days_seasons_worker((void *) &(thread[t]));
+#endif
+
+  /* Report the first season in error */
+  istat = 0;
+  for (s=0; s<data->conf->nseasons; s++)
+    if (work.istat[s] != 0 && istat == 0)
+      istat = work.istat[s];
+
+  (void) free(thread);
+  (void) free(work.istat);
+
+  return istat;
+}
@@ -79,6 +79,14 @@ free_main_data(data_struct *data) {
     (void) free(data->conf->analog_file_ctrl);
   if (data->conf->analog_save == TRUE || data->conf->output_only == TRUE)
     (void) free(data->conf->analog_file_other);
+  if (data->conf->checkpoint_path != NULL) {
+    (void) free(data->conf->checkpoint_path);
+    (void) free(data->conf->checkpoint_hash);
+  }
+  if (data->conf->cache_path != NULL)
+    (void) free(data->conf->cache_path);
+  if (data->conf->perf_report != NULL)
+    (void) free(data->conf->perf_report);
 
   for (i=0; i<NCAT; i++) {
 
@@ -91,10 +99,15 @@ free_main_data(data_struct *data) {
       if (data->field[i].data[j].clim_info->clim_save == TRUE || data->field[i].data[j].clim_info->clim_provided == TRUE)
         (void) free(data->field[i].data[j].clim_info->clim_nomvar_ls);
       (void) free(data->field[i].data[j].clim_info);
+      if (data->field[i].data[j].clim_ls != NULL)
+        (void) free(data->field[i].data[j].clim_ls);
 
       if (data->field[i].data[j].eof_info->eof_project == TRUE) {
         (void) free(data->field[i].data[j].eof_info->eof_coords);
-        (void) free(data->field[i].data[j].eof_info->eof_filein_ls);
+        if (data->field[i].data[j].eof_info->eof_filein_ls != NULL)
+          (void) free(data->field[i].data[j].eof_info->eof_filein_ls);
+        if (data->field[i].data[j].eof_info->eof_fileout_ls != NULL)
+          (void) free(data->field[i].data[j].eof_info->eof_fileout_ls);
         (void) free(data->field[i].data[j].eof_data->eof_nomvar_ls);
         (void) free(data->field[i].data[j].eof_data->sing_nomvar_ls);
 
@@ -375,6 +388,12 @@ free_main_data(data_struct *data) {
 
     (void) free(data->learning->nomvar_rea_sup);
     (void) free(data->learning->filename_rea_sup);
+    (void) free(data->learning->filename_rea_field);
+    (void) free(data->learning->nomvar_rea_field);
+    (void) free(data->learning->nomvar_obs_field);
+    (void) free(data->learning->rea_eof_ls);
+    (void) free(data->learning->rea_lon);
+    (void) free(data->learning->rea_lat);
     (void) free(data->learning->rea_coords);
     (void) free(data->learning->rea_gridname);
     (void) free(data->learning->rea_dimxname);
@@ -417,6 +436,8 @@ free_main_data(data_struct *data) {
     (void) free(data->learning->filename_open_learn);
     (void) free(data->learning->filename_open_clust_learn);
   }
+  else if (data->learning->learning_incremental == TRUE)
+    (void) free(data->learning->filename_open_weight);
 
   if (data->conf->output_only != TRUE)
     (void) free(data->learning->pc_normalized_var);
@@ -568,6 +589,7 @@ free_main_data(data_struct *data) {
   
   (void) free(data->conf->clim_filter_type);
   (void) free(data->conf->classif_type);
+  (void) free(data->conf->classif_init);
   (void) free(data->conf->time_units);
   (void) free(data->conf->cal_type);
   (void) free(data->conf->dimxname_eof);
@@ -593,4 +615,7 @@ free_main_data(data_struct *data) {
   (void) free(data->learning);
   (void) free(data->reg);
   (void) free(data->field);
+
+  /* Free NetCDF metadata cache */
+  meta_cache_free();
 }
@@ -53,76 +53,100 @@ LICENSE END */
 
 #include <classif.h>
 
-/** Algorithm to generate best clusters among many tries. */
-int
-best_clusters(double *best_clusters, double *pc_eof_days, char *type, int npart, int nclassif, int neof, int ncluster, int ndays) {
-  /**
-     @param[out]     best_clusters      Best clusters' positions.
-     @param[in]      pc_eof_days        Principal Components of EOF (daily data).
-     @param[in]      type               Type of distance used. Possible values: euclidian.
-     @param[in]      npart              Number of classification partitions to try.
-     @param[in]      nclassif           Maximum number of classifications to perform in the iterative algorithm.
-     @param[in]      neof               Number of EOFs.
-     @param[in]      ncluster           Number of clusters.
-     @param[in]      ndays              Number of days in the pc_eof_days vector.
-
-     \return         Minimum number of iterations needed.
-  */
+/** Shared arguments of the partition generation and comparison workers. */
+typedef struct {
+  double *testclusters; /**< Clusters of all partitions. */
+  double *meandist; /**< Mean distance of each partition to all other partitions. */
+  int *niter; /**< Number of iterations needed for each partition. */
+  pc_days_struct *pc_days; /**< Principal Components of EOF (daily data), day-major. */
+  char *type; /**< Type of distance used. */
+  char *init; /**< Type of initial cluster centers. */
+  int npart; /**< Number of partitions. */
+  int nclassif; /**< Maximum number of classifications. */
+  int neof; /**< Number of EOFs. */
+  int ncluster; /**< Number of clusters. */
+  int nthreads; /**< Number of threads. */
+  unsigned long int seed; /**< Master seed of the random number generators. */
+  double tol; /**< Cluster center shift tolerance to stop iterations. */
+} best_clusters_work_struct;
+
+/** Arguments of one worker thread. */
+typedef struct {
+  best_clusters_work_struct *work; /**< Shared arguments. */
+  int first; /**< First partition processed by this worker, next ones are spaced by nthreads. */
+} best_clusters_thread_struct;
+
+static unsigned long int best_clusters_seed(unsigned long int seed, int part);
+static void *best_clusters_generate(void *arg);
+static void *best_clusters_compare(void *arg);
+static void best_clusters_run(void *(*worker)(void *), best_clusters_work_struct *work);
+
+/** Derive the seed of one partition from the master seed (splitmix64 mixing, so that neighbouring partitions get unrelated streams). */
+static unsigned long int
+best_clusters_seed(unsigned long int seed, int part) {
+
+  unsigned long long int z; /* Mixed seed */
+
+  z = (unsigned long long int) seed + (unsigned long long int) (part+1) * 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z = z ^ (z >> 31);
+
+  return (unsigned long int) z;
+}
 
-  double min_meandistval; /* Minimum distance between a partition and all other partitions */
-  double meandistval; /* Mean distance value between each corresponding clusters for the comparison of two partitions. */
-  double maxdistval; /* Maximum distance over all clusters for the two partitions comparison. */
-  double minval; /* Minimum distance to find a corresponding closest cluster in another partition. */
-  double dist_bary; /* Distance summed over all EOFs between a cluster in one partition and other clusters in other partitions. */
-  double val; /* Difference in positions between a cluster in one partition and other clusters in other partitions for a particular EOF. */
+/** Worker generating its share of the partitions. */
+static void *
+best_clusters_generate(void *arg) {
 
+  best_clusters_thread_struct *thread = (best_clusters_thread_struct *) arg; /* Worker arguments */
+  best_clusters_work_struct *work = thread->work; /* Shared arguments */
   double *tmpcluster = NULL; /* Temporary vector of clusters for one partition. */
-  double *testclusters = NULL; /* Temporary vector of clusters for all partitions. */
-  
-  int min_cluster = -1; /* Cluster number used to find a corresponding cluster in another partition. */
-  int min_partition = -1; /* Partition number used to find the partition which has the minimum distance to all other partitions. */
-
   int part; /* Loop counter for partitions */
-  int part1; /* Loop counter for partitions inside loop */
-  int part2; /* Loop counter for partitions inside loop */
   int clust; /* Loop counter for clusters */
-  int clust1; /* Loop counter for clusters inside loop */
-  int clust2; /* Loop counter for clusters inside loop */
   int eof; /* Loop counter for eofs */
 
-  int niter; /* Number of iterations */
-  int niter_min; /* Minimum number of iterations */
-
-  (void) fprintf(stdout, "%s:: BEGIN: Find the best partition of clusters.\n", __FILE__);
-
-  niter_min = 99999;
-
-  /* Allocate memory */
-  tmpcluster = (double *) calloc(neof*ncluster, sizeof(double));
+  tmpcluster = (double *) calloc(work->neof*work->ncluster, sizeof(double));
   if (tmpcluster == NULL) alloc_error(__FILE__, __LINE__);
-  testclusters = (double *) calloc(neof*ncluster*npart, sizeof(double));
-  if (testclusters == NULL) alloc_error(__FILE__, __LINE__);
 
-  /* Generate npart clusters (which will be used to find the best clustering). */
-  (void) fprintf(stdout, "%s:: Generating %d partitions of clusters.\n", __FILE__, npart);
-  for (part=0; part<npart; part++) {
+  for (part=thread->first; part<work->npart; part+=work->nthreads) {
 #if DEBUG >= 1
-    (void) fprintf(stdout, "%s:: Generating %d/%d partition of clusters.\n", __FILE__, part+1, npart);
+    (void) fprintf(stdout, "%s:: Generating %d/%d partition of clusters.\n", __FILE__, part+1, work->npart);
 #endif
-    niter = generate_clusters(tmpcluster, pc_eof_days, type, nclassif, neof, ncluster, ndays);
-    if (niter < niter_min) niter_min = niter;
-    for (clust=0; clust<ncluster; clust++)
-      for (eof=0; eof<neof; eof++)
-        testclusters[part+eof*npart+clust*npart*neof] = tmpcluster[eof+clust*neof];
+    work->niter[part] = generate_clusters(tmpcluster, work->pc_days, work->type, work->init, work->nclassif, work->ncluster,
+                                          best_clusters_seed(work->seed, part), work->tol);
+    for (clust=0; clust<work->ncluster; clust++)
+      for (eof=0; eof<work->neof; eof++)
+        work->testclusters[part+eof*work->npart+clust*work->npart*work->neof] = tmpcluster[eof+clust*work->neof];
   }
 
-  /** Try to find best partition (clustering) which is closest to all the other partitions (which corresponds to
-      the partition closest to the barycenter of partitions. */
-  min_meandistval = 9999999999.9;
-  min_partition = -1;
-  /* Loop over all partition and compute distance between each other partition. */
-  (void) fprintf(stdout, "%s:: Computing distance between each partitions of clusters.\n", __FILE__);
-  for (part1=0; part1<npart; part1++) {
+  (void) free(tmpcluster);
+
+  return NULL;
+}
+
+/** Worker computing the mean distance of its share of the partitions to all other partitions. */
+static void *
+best_clusters_compare(void *arg) {
+
+  best_clusters_thread_struct *thread = (best_clusters_thread_struct *) arg; /* Worker arguments */
+  best_clusters_work_struct *work = thread->work; /* Shared arguments */
+  double *testclusters = work->testclusters; /* Clusters of all partitions */
+  double meandistval; /* Mean distance value between each corresponding clusters for the comparison of two partitions. */
+  double maxdistval; /* Maximum distance over all clusters for the two partitions comparison. */
+  double minval; /* Minimum distance to find a corresponding closest cluster in another partition. */
+  double dist_bary; /* Distance summed over all EOFs between a cluster in one partition and other clusters in other partitions. */
+  double val; /* Difference in positions between a cluster in one partition and other clusters in other partitions for a particular EOF. */
+  int min_cluster = -1; /* Cluster number used to find a corresponding cluster in another partition. */
+  int npart = work->npart; /* Number of partitions */
+  int neof = work->neof; /* Number of EOFs */
+  int part1; /* Loop counter for partitions */
+  int part2; /* Loop counter for partitions inside loop */
+  int clust1; /* Loop counter for clusters */
+  int clust2; /* Loop counter for clusters inside loop */
+  int eof; /* Loop counter for eofs */
+
+  for (part1=thread->first; part1<npart; part1+=work->nthreads) {
 #if DEBUG >= 1
     (void) fprintf(stdout, "%s:: Partition %d/%d.\n", __FILE__, part1+1, npart);
 #endif
@@ -134,27 +158,20 @@ best_clusters(double *best_clusters, double *pc_eof_days, char *type, int npart,
 
         maxdistval = -9999999999.9;
         
-        for (clust1=0; clust1<ncluster; clust1++) {
+        for (clust1=0; clust1<work->ncluster; clust1++) {
           
           /* Find closest cluster to current one (in terms of distance summed over all EOF). */
           minval = 9999999999.9;
           min_cluster = -1;
-          for (clust2=0; clust2<ncluster; clust2++) {
-
-            if ( !strcmp(type, "euclidian") ) {
-              /* Sum distances over all EOF. */
-              dist_bary = 0.0;
-              for (eof=0; eof<neof; eof++) {
-                val = testclusters[part2+eof*npart+clust1*npart*neof] - testclusters[part1+eof*npart+clust2*npart*neof];
-                dist_bary += (val * val);
-              }
-              
-              dist_bary = sqrt(dist_bary);
-            }
-            else {
-              (void) fprintf(stderr, "best_clusters: ABORT: Unknown distance type=%s!!\n", type);
-              (void) abort();
+          for (clust2=0; clust2<work->ncluster; clust2++) {
+
+            /* Sum distances over all EOF. */
+            dist_bary = 0.0;
+            for (eof=0; eof<neof; eof++) {
+              val = testclusters[part2+eof*npart+clust1*npart*neof] - testclusters[part1+eof*npart+clust2*npart*neof];
+              dist_bary += (val * val);
             }
+            dist_bary = sqrt(dist_bary);
             
             /* Check for minimum distance. We want to find the corresponding closest cluster in another partition. */
             if (dist_bary < minval) {
@@ -178,13 +195,143 @@ best_clusters(double *best_clusters, double *pc_eof_days, char *type, int npart,
       }
     }
     /* Compute the mean of the distances between each corresponding clusters for the comparison of two partitions. */
-    meandistval = meandistval / (double) (npart-1);
-    /* We want to keep the partition which has the minimum distance to all other partitions. */
-    if (meandistval < min_meandistval) {
-      min_meandistval = meandistval;
-      min_partition = part1;
+    work->meandist[part1] = meandistval / (double) (npart-1);
+  }
+
+  return NULL;
+}
+
+/** Run a worker on nthreads threads, or sequentially when threads are not available. */
+static void
+best_clusters_run(void *(*worker)(void *), best_clusters_work_struct *work) {
+
+  best_clusters_thread_struct *thread = NULL; /* Arguments of each worker */
+  int t; /* Loop counter for threads */
+#ifdef HAVE_PTHREAD_H
+  pthread_t *tid = NULL; /* Thread identifiers */
+  int istat; /* Diagnostic status */
+#endif
+
+  thread = (best_clusters_thread_struct *) malloc(work->nthreads * sizeof(best_clusters_thread_struct));
+  if (thread == NULL) alloc_error(__FILE__, __LINE__);
+  for (t=0; t<work->nthreads; t++) {
+    thread[t].work = work;
+    thread[t].first = t;
+  }
+
+#ifdef HAVE_PTHREAD_H
+  tid = (pthread_t *) malloc(work->nthreads * sizeof(pthread_t));
+  if (tid == NULL) alloc_error(__FILE__, __LINE__);
+  /* The calling thread processes the first share itself */
+  for (t=1; t<work->nthreads; t++) {
+    istat = pthread_create(&(tid[t]), NULL, worker, (void *) &(thread[t]));
+    if (istat != 0) {
+      (void) fprintf(stderr, "best_clusters: ABORT: Cannot create thread %d!\n", t);
+      (void) abort();
     }
   }
+  (void) worker((void *) &(thread[0]));
+  for (t=1; t<work->nthreads; t++)
+    (void) pthread_join(tid[t], NULL);
+  (void) free(tid);
+#else
+  for (t=0; t<work->nthreads; t++)
+    (void) worker((void *) &(thread[t]));
+#endif
+
+  (void) free(thread);
+}
+
+/** Algorithm to generate best clusters among many tries. */
+int
+best_clusters(double *best_clusters, double *pc_eof_days, char *type, char *init, int npart, int nclassif, int neof, int ncluster, int ndays,
+              int nthreads, unsigned long int seed, double tol) {
+  /**
+     @param[out]     best_clusters      Best clusters' positions.
+     @param[in]      pc_eof_days        Principal Components of EOF (daily data).
+     @param[in]      type               Type of distance used. Possible values: euclidian.
+     @param[in]      init               Type of initial cluster centers. Possible values: random, kmeans++.
+     @param[in]      npart              Number of classification partitions to try.
+     @param[in]      nclassif           Maximum number of classifications to perform in the iterative algorithm.
+     @param[in]      neof               Number of EOFs.
+     @param[in]      ncluster           Number of clusters.
+     @param[in]      ndays              Number of days in the pc_eof_days vector.
+     @param[in]      nthreads           Number of threads used to generate and compare partitions.
+     @param[in]      seed               Master seed: partition p uses a seed derived from it and p, so results do not depend on nthreads.
+     @param[in]      tol                Cluster center shift tolerance to stop iterations of each partition (disabled if <= 0).
+
+     \return         Minimum number of iterations needed.
+  */
+
+  best_clusters_work_struct work; /* Shared arguments of workers */
+  pc_days_struct pc_days; /* Principal components packed day-major */
+
+  double min_meandistval; /* Minimum distance between a partition and all other partitions */
+
+  int min_partition = -1; /* Partition number used to find the partition which has the minimum distance to all other partitions. */
+
+  int part; /* Loop counter for partitions */
+  int clust; /* Loop counter for clusters */
+  int eof; /* Loop counter for eofs */
+
+  int niter_min; /* Minimum number of iterations */
+
+  (void) fprintf(stdout, "%s:: BEGIN: Find the best partition of clusters.\n", __FILE__);
+
+  if ( strcmp(type, "euclidian") ) {
+    (void) fprintf(stderr, "best_clusters: ABORT: Unknown distance type=%s!!\n", type);
+    (void) abort();
+  }
+
+  if (nthreads < 1) nthreads = 1;
+  if (nthreads > npart) nthreads = npart;
+
+  /* Pack principal components once for all partitions */
+  (void) pack_pc_days(&pc_days, pc_eof_days, neof, ndays);
+  work.pc_days = &pc_days;
+  work.type = type;
+  work.init = init;
+  work.npart = npart;
+  work.nclassif = nclassif;
+  work.neof = neof;
+  work.ncluster = ncluster;
+  work.nthreads = nthreads;
+  work.seed = seed;
+  work.tol = tol;
+
+  /* Allocate memory */
+  work.testclusters = (double *) calloc(neof*ncluster*npart, sizeof(double));
+  if (work.testclusters == NULL) alloc_error(__FILE__, __LINE__);
+  work.meandist = (double *) calloc(npart, sizeof(double));
+  if (work.meandist == NULL) alloc_error(__FILE__, __LINE__);
+  work.niter = (int *) calloc(npart, sizeof(int));
+  if (work.niter == NULL) alloc_error(__FILE__, __LINE__);
+
+  /* Generate npart clusters (which will be used to find the best clustering). */
+  (void) fprintf(stdout, "%s:: Generating %d partitions of clusters using %d thread(s) and seed %lu.\n", __FILE__, npart, nthreads, seed);
+  (void) best_clusters_run(best_clusters_generate, &work);
+
+  niter_min = 99999;
+  for (part=0; part<npart; part++) {
+    (void) fprintf(stdout, "%s:: Partition %d/%d: %d iterations.\n", __FILE__, part+1, npart, work.niter[part]);
+    if (work.niter[part] < niter_min) niter_min = work.niter[part];
+  }
+
+  /** Try to find best partition (clustering) which is closest to all the other partitions (which corresponds to
+      the partition closest to the barycenter of partitions. */
+  /* Loop over all partition and compute distance between each other partition. */
+  (void) fprintf(stdout, "%s:: Computing distance between each partitions of clusters.\n", __FILE__);
+  (void) best_clusters_run(best_clusters_compare, &work);
+
+  /* We want to keep the partition which has the minimum distance to all other partitions.
+     Selection is done in partition order so that it does not depend on the number of threads. */
+  min_meandistval = 9999999999.9;
+  min_partition = -1;
+  for (part=0; part<npart; part++)
+    if (work.meandist[part] < min_meandistval) {
+      min_meandistval = work.meandist[part];
+      min_partition = part;
+    }
 
   if (min_partition == -1) {
     /* Failing algorithm */
@@ -196,11 +343,13 @@ best_clusters(double *best_clusters, double *pc_eof_days, char *type, int npart,
   (void) fprintf(stdout, "%s:: Save best partition of clusters.\n", __FILE__);
   for (clust=0; clust<ncluster; clust++)
     for (eof=0; eof<neof; eof++)
-      best_clusters[eof+clust*neof] = testclusters[min_partition+eof*npart+clust*npart*neof];  
+      best_clusters[eof+clust*neof] = work.testclusters[min_partition+eof*npart+clust*npart*neof];  
 
   /* Free memory. */
-  (void) free(tmpcluster);
-  (void) free(testclusters);
+  (void) free(work.testclusters);
+  (void) free(work.meandist);
+  (void) free(work.niter);
+  (void) free_pc_days(&pc_days);
 
   (void) fprintf(stdout, "%s:: END: Find the best partition of clusters. Partition %d selected.\n", __FILE__, min_partition);
 
@@ -57,16 +57,15 @@ LICENSE END */
 
 /** Output a vector (dimension days) containing the closer (Euclidian distance) cluster number. The distance is computed as the distance between a day's principal components for each EOF and the cluster principal components for each EOF. To evaluate the closest one, all the square of the distances for all EOFs are summed for each cluster, before the square root is applied. */
 void
-class_days_pc_clusters(int *days_class_cluster, double *pc_eof_days, double *eof_days_cluster, char *type,
-                       int neof, int ncluster, int ndays) {
+class_days_pc_clusters(int *days_class_cluster, pc_days_struct *pc_days, double *eof_days_cluster, char *type,
+                       int neof, int ncluster) {
   /**
      @param[out]     days_class_cluster      Cluster number associated for each day.
-     @param[in]      pc_eof_days             Principal Components of EOF (daily data).
+     @param[in]      pc_days                 Principal Components of EOF (daily data), day-major.
      @param[in]      eof_days_cluster        Clusters' centroid positions for each eof.
      @param[in]      type                    Type of distance used. Possible values: euclidian.
-     @param[in]      neof                    Number of EOFs.
+     @param[in]      neof                    Number of leading EOFs used for distances, at most pc_days->neof.
      @param[in]      ncluster                Number of clusters.
-     @param[in]      ndays                   Number of days in the pc_eof_days vector.
   */
 
   double dist_min; /* Minimum distance found between a given day PC (summed over all EOF) and each cluster centroid. */
@@ -75,6 +74,8 @@ class_days_pc_clusters(int *days_class_cluster, double *pc_eof_days, double *eof
   double val; /* Distance between a given day PC (for a particular EOF) and one cluster centroid. */
   double dist_clust; /* Distance (full computation of dist_sum). */
   
+  double *pc = NULL; /* Principal components of current day, contiguous over EOFs */
+
   int day; /* Loop counter for days */
   int clust; /* Loop counter for cluster */
   int eof; /* Loop counter for eofs */
@@ -83,7 +84,9 @@ class_days_pc_clusters(int *days_class_cluster, double *pc_eof_days, double *eof
     /* Euclidian distance type */
 
     /* Parse each day */
-    for (day=0; day<ndays; day++) {
+    for (day=0; day<pc_days->ndays; day++) {
+
+      pc = &(pc_days->pc[day*pc_days->neof]);
 
       /* Initialize */
       dist_min = 9999999999.0;
@@ -103,9 +106,9 @@ class_days_pc_clusters(int *days_class_cluster, double *pc_eof_days, double *eof
         dist_sum = 0.0;
         /* Sum all distances (over EOF) between the PC of the day and the PC of the cluster centroid for each EOF respectively */
         for (eof=0; eof<neof; eof++) {
-          val = pc_eof_days[day+eof*ndays] - eof_days_cluster[eof+clust*neof];
+          val = pc[eof] - eof_days_cluster[eof+clust*neof];
 #if DEBUG >= 9
-          printf("%d %d %lf %lf\n",clust,eof,pc_eof_days[day+eof*ndays],eof_days_cluster[eof+clust*neof]);
+          printf("%d %d %lf %lf\n",clust,eof,pc[eof],eof_days_cluster[eof+clust*neof]);
 #endif
           /* Euclidian distance: square */
           dist_sum += (val * val);
@@ -0,0 +1,210 @@
+/* ***************************************************** */
+/* Classification subroutine: find the closest cluster   */
+/* of each day in EOF space using distance bounds        */
+/* to skip most distance computations.                   */
+/* class_days_pc_clusters_bounds.c                       */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/*! \file class_days_pc_clusters_bounds.c
+    \brief Classification subroutine find the closest cluster of each day in EOF space using distance bounds to skip most distance computations.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <classif.h>
+
+/** Same classification as class_days_pc_clusters (Euclidian distance) for the iterations of the clustering algorithm,
+    accelerated with Hamerly's bounds. For each day an upper bound on the distance to its cluster and a lower bound on the
+    distance to any other cluster are kept between calls, and updated from the cluster centroid shifts. A day is only
+    compared to all clusters when its bounds cannot prove that its cluster is unchanged, in which case the distances are
+    computed exactly as in class_days_pc_clusters, so that the classification is identical. Principal components are
+    day-major so that distances read contiguous memory. */
+int
+class_days_pc_clusters_bounds(int *days_class_cluster, double *upper_bound, double *lower_bound, double *prev_cluster,
+                              pc_days_struct *pc_days, double *eof_days_cluster, int init, int ncluster) {
+  /**
+     @param[in,out]  days_class_cluster      Cluster number associated for each day (input is ignored if init != 0).
+     @param[in,out]  upper_bound             Upper bound of the distance between each day and its cluster (ndays).
+     @param[in,out]  lower_bound             Lower bound of the distance between each day and any other cluster (ndays).
+     @param[in,out]  prev_cluster            Clusters' centroid positions at the previous call (neof x ncluster).
+     @param[in]      pc_days                 Principal Components of EOF (daily data), day-major.
+     @param[in]      eof_days_cluster        Clusters' centroid positions for each eof.
+     @param[in]      init                    Set to 1 at the first call, to compute all distances and initialize bounds.
+     @param[in]      ncluster                Number of clusters.
+
+     \return         Number of days which changed cluster (ndays if init != 0).
+  */
+
+  double *shift = NULL; /* Distance each cluster centroid moved since the previous call */
+  double *half_sep = NULL; /* Half the distance between each cluster centroid and its closest other centroid */
+  double shift_max; /* Largest centroid shift */
+  double shift_max2; /* Second largest centroid shift */
+  int clust_shift_max = -1; /* Cluster with the largest centroid shift */
+  double bound; /* Bound against which upper bound is checked */
+  double dist_min; /* Minimum distance found between a given day PC (summed over all EOF) and each cluster centroid. */
+  double dist_min2; /* Second minimum distance */
+  int clust_dist_min; /* Cluster number which has the minimum distance dist_min */
+  double dist_sum; /* Sum of distances (partial computation) over all EOFs */
+  double val; /* Distance between a given day PC (for a particular EOF) and one cluster centroid. */
+  double dist_clust; /* Distance (full computation of dist_sum). */
+  int nchanged = 0; /* Number of days which changed cluster */
+
+  int neof = pc_days->neof; /* Number of EOFs */
+  int ndays = pc_days->ndays; /* Number of days */
+  double *pc = NULL; /* Principal components of current day, contiguous over EOFs */
+  int day; /* Loop counter for days */
+  int clust; /* Loop counter for cluster */
+  int clust2; /* Loop counter for cluster */
+  int eof; /* Loop counter for eofs */
+
+  shift = (double *) calloc(ncluster, sizeof(double));
+  if (shift == NULL) alloc_error(__FILE__, __LINE__);
+  half_sep = (double *) malloc(ncluster * sizeof(double));
+  if (half_sep == NULL) alloc_error(__FILE__, __LINE__);
+
+  /* Centroid shifts since previous call */
+  shift_max = 0.0;
+  shift_max2 = 0.0;
+  if (init == 0)
+    for (clust=0; clust<ncluster; clust++) {
+      dist_sum = 0.0;
+      for (eof=0; eof<neof; eof++) {
+        val = eof_days_cluster[eof+clust*neof] - prev_cluster[eof+clust*neof];
+        dist_sum += (val * val);
+      }
+      shift[clust] = sqrt(dist_sum);
+      if (shift[clust] > shift_max) {
+        shift_max2 = shift_max;
+        shift_max = shift[clust];
+        clust_shift_max = clust;
+      }
+      else if (shift[clust] > shift_max2)
+        shift_max2 = shift[clust];
+    }
+
+  /* Half distance to closest other centroid: a day closer than that to its centroid cannot be closer to another one */
+  for (clust=0; clust<ncluster; clust++) {
+    half_sep[clust] = 9999999999.0;
+    for (clust2=0; clust2<ncluster; clust2++)
+      if (clust2 != clust) {
+        dist_sum = 0.0;
+        for (eof=0; eof<neof; eof++) {
+          val = eof_days_cluster[eof+clust*neof] - eof_days_cluster[eof+clust2*neof];
+          dist_sum += (val * val);
+        }
+        if (0.5 * sqrt(dist_sum) < half_sep[clust])
+          half_sep[clust] = 0.5 * sqrt(dist_sum);
+      }
+  }
+
+  /* Parse each day */
+  for (day=0; day<ndays; day++) {
+
+    pc = &(pc_days->pc[day*neof]);
+
+    if (init == 0) {
+      clust = days_class_cluster[day];
+
+      /* Update bounds with centroid shifts */
+      upper_bound[day] += shift[clust];
+      lower_bound[day] -= (clust == clust_shift_max) ? shift_max2 : shift_max;
+
+      /* Keep a relative margin so that rounding errors in the bounds can never skip a needed comparison */
+      bound = (lower_bound[day] > half_sep[clust]) ? lower_bound[day] : half_sep[clust];
+      if (upper_bound[day] * (1.0 + CLASSIF_BOUND_EPS) < bound * (1.0 - CLASSIF_BOUND_EPS))
+        continue;
+
+      /* Tighten upper bound with exact distance to current cluster */
+      dist_sum = 0.0;
+      for (eof=0; eof<neof; eof++) {
+        val = pc[eof] - eof_days_cluster[eof+clust*neof];
+        dist_sum += (val * val);
+      }
+      upper_bound[day] = sqrt(dist_sum);
+      if (upper_bound[day] * (1.0 + CLASSIF_BOUND_EPS) < bound * (1.0 - CLASSIF_BOUND_EPS))
+        continue;
+    }
+
+    /* Compare to all clusters, as in class_days_pc_clusters */
+    dist_min = 9999999999.0;
+    dist_min2 = 9999999999.0;
+    clust_dist_min = 999;
+    for (clust=0; clust<ncluster; clust++) {
+      dist_sum = 0.0;
+      for (eof=0; eof<neof; eof++) {
+        val = pc[eof] - eof_days_cluster[eof+clust*neof];
+        dist_sum += (val * val);
+      }
+      dist_clust = sqrt(dist_sum);
+      if (dist_clust < dist_min) {
+        dist_min2 = dist_min;
+        clust_dist_min = clust;
+        dist_min = dist_clust;
+      }
+      else if (dist_clust < dist_min2)
+        dist_min2 = dist_clust;
+    }
+    if (clust_dist_min == 999) {
+      /* Failing algorithm */
+      (void) fprintf(stderr, "%s: ABORT: Impossible: no cluster was selected!! Problem in algorithm...\n", __FILE__);
+      (void) abort();
+    }
+
+    if (init != 0 || days_class_cluster[day] != clust_dist_min)
+      nchanged++;
+    days_class_cluster[day] = clust_dist_min;
+    upper_bound[day] = dist_min;
+    lower_bound[day] = dist_min2;
+  }
+
+  /* Save centroids for next call */
+  for (clust=0; clust<ncluster*neof; clust++)
+    prev_cluster[clust] = eof_days_cluster[clust];
+
+  (void) free(shift);
+  (void) free(half_sep);
+
+  return nchanged;
+}
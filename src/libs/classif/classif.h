@@ -76,24 +76,47 @@ LICENSE END */
 #ifdef HAVE_STRING_H
 #include <string.h>
 #endif
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
 
 /* GNU GSL includes */
 #include <gsl/gsl_rng.h>
 #include <gsl/gsl_randist.h>
 #include <gsl/gsl_statistics.h>
 
+/** Relative margin applied to distance bounds in class_days_pc_clusters_bounds to absorb rounding errors. */
+#define CLASSIF_BOUND_EPS 1.0e-10
+
 /* Local dependent includes */
 #include <misc.h>
 
+/** Principal components packed day-major: all EOFs of a day are contiguous. */
+typedef struct {
+  double *pc; /**< Principal components, pc[eof+day*neof]. */
+  int neof; /**< Number of EOFs. */
+  int ndays; /**< Number of days. */
+} pc_days_struct;
+
 /* Prototypes */
-void class_days_pc_clusters(int *days_class_cluster, double *pc_eof_days, double *eof_days_cluster, char *type,
-                            int neof, int ncluster, int ndays);
-int generate_clusters(double *clusters, double *pc_eof_days, char *type, int nclassif, int neof, int ncluster, int ndays);
-int best_clusters(double *best_clusters, double *pc_eof_days, char *type, int npart, int nclassif, int neof, int ncluster, int ndays);
-void mean_variance_dist_clusters(double *mean_dist, double *var_dist, double *pc, double *clusters, double *var_pc,
-                                 double *var_pc_norm_all, int neof, int nclust, int ntime);
-void dist_clusters_normctrl(double *dist_pc, double *pc, double *clusters, double *var_pc,
-                            double *var_pc_norm_all, double *mean_ctrl, double *var_ctrl,
-                            int neof, int nclust, int ntime);
+void class_days_pc_clusters(int *days_class_cluster, pc_days_struct *pc_days, double *eof_days_cluster, char *type,
+                            int neof, int ncluster);
+int class_days_pc_clusters_bounds(int *days_class_cluster, double *upper_bound, double *lower_bound, double *prev_cluster,
+                                  pc_days_struct *pc_days, double *eof_days_cluster, int init, int ncluster);
+void update_clusters_centroid(double *clusters, int *ndays_cluster, pc_days_struct *pc_days, int *days_class_cluster, int ncluster);
+void seed_clusters(double *eof_days_cluster, pc_days_struct *pc_days, char *init, gsl_rng *rng, int ncluster);
+int generate_clusters(double *clusters, pc_days_struct *pc_days, char *type, char *init, int nclassif, int ncluster,
+                      unsigned long int seed, double tol);
+int best_clusters(double *best_clusters, double *pc_eof_days, char *type, char *init, int npart, int nclassif, int neof, int ncluster, int ndays,
+                  int nthreads, unsigned long int seed, double tol);
+void pack_pc_days(pc_days_struct *pc_days, double *pc_eof_days, int neof, int ndays);
+void unpack_pc_days(double *pc_eof_days, pc_days_struct *pc_days);
+void free_pc_days(pc_days_struct *pc_days);
+void dist_clusters(double *dist_pc, int *days_class_cluster, pc_days_struct *pc_days, double *clusters, double *var_pc,
+                   double *var_pc_norm_all, int nclust);
+void mean_variance_dist_clusters(double *mean_dist, double *var_dist, pc_days_struct *pc_days, double *clusters, double *var_pc,
+                                 double *var_pc_norm_all, int nclust);
+void dist_clusters_normctrl(double *dist_pc, int *days_class_cluster, pc_days_struct *pc_days, double *clusters, double *var_pc,
+                            double *var_pc_norm_all, double *mean_ctrl, double *var_ctrl, int nclust);
 #endif
 
@@ -0,0 +1,140 @@
+/* ***************************************************** */
+/* Compute normalized distances to clusters and          */
+/* classify days in a single pass.                       */
+/* dist_clusters.c                                       */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/*! \file dist_clusters.c
+    \brief Compute normalized distances to clusters and classify days in a single pass.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <classif.h>
+
+/** Compute distances of normalized EOF-projected large-scale field to normalized clusters, and optionally classify each day in
+    its closest cluster (Euclidian distance without normalization, as in class_days_pc_clusters), in a single pass over days.
+    Field and cluster centroids are normalized once, and the field is packed day-major by the caller so that distances read contiguous memory. */
+void
+dist_clusters(double *dist_pc, int *days_class_cluster, pc_days_struct *pc_days, double *clusters, double *var_pc, double *var_pc_norm_all,
+              int nclust) {
+  /**
+     @param[out]  dist_pc            Distances of normalized EOF-projected large-scale field to normalized clusters (ntime x nclust).
+     @param[out]  days_class_cluster Closest cluster of each day. Not computed if NULL.
+     @param[in]   pc_days            EOF-projected large-scale field, day-major.
+     @param[in]   clusters           Cluster centroids for each EOF in EOF-projected space of the large-scale field.
+     @param[in]   var_pc             Variance of EOF-projected large-scale field of the learning period, for each EOF separately.
+     @param[in]   var_pc_norm_all    Norm of the variance of the first EOF of the EOF-projected large-scale field of the control run.
+     @param[in]   nclust             Clusters dimension
+  */
+
+  double *pcnorm = NULL; /* Normalized EOF-projected field, packed day-major */
+  double *clustnorm = NULL; /* Normalized cluster centroids */
+  double *pcday = NULL; /* EOF-projected field of current timestep, contiguous over EOFs */
+  double *pcnormday = NULL; /* Normalized EOF-projected field of current timestep, contiguous over EOFs */
+  double sum; /* Sum of squared normalized distances over EOFs */
+  double sum_class; /* Sum of squared distances over EOFs, for classification */
+  double val; /* Distance for one EOF */
+  double dist_min; /* Minimum distance for classification */
+  int clust_dist_min; /* Closest cluster */
+
+  int neof = pc_days->neof; /* EOF dimension */
+  int ntime = pc_days->ndays; /* Time dimension */
+  int eof; /* EOF loop counter */
+  int nt; /* Time loop counter */
+  int clust; /* Cluster loop counter */
+
+  /* Normalize field and cluster centroids once */
+  pcnorm = (double *) malloc(neof*ntime * sizeof(double));
+  if (pcnorm == NULL) alloc_error(__FILE__, __LINE__);
+  for (nt=0; nt<ntime; nt++)
+    for (eof=0; eof<neof; eof++)
+      pcnorm[eof+nt*neof] = pc_days->pc[eof+nt*neof] / sqrt(var_pc_norm_all[eof]);
+  clustnorm = (double *) malloc(neof*nclust * sizeof(double));
+  if (clustnorm == NULL) alloc_error(__FILE__, __LINE__);
+  for (clust=0; clust<nclust; clust++)
+    for (eof=0; eof<neof; eof++)
+      clustnorm[eof+clust*neof] = clusters[eof+clust*neof] / sqrt(var_pc[eof]);
+
+  for (nt=0; nt<ntime; nt++) {
+    pcday = &(pc_days->pc[nt*neof]);
+    pcnormday = &(pcnorm[nt*neof]);
+    dist_min = 9999999999.0;
+    clust_dist_min = 999;
+    for (clust=0; clust<nclust; clust++) {
+      /* Normalized distance */
+      sum = 0.0;
+      for (eof=0; eof<neof; eof++) {
+        val = pcnormday[eof] - clustnorm[eof+clust*neof];
+        sum += (val * val);
+      }
+      dist_pc[nt+clust*ntime] = sqrt(sum);
+
+      /* Distance for classification */
+      if (days_class_cluster != NULL) {
+        sum_class = 0.0;
+        for (eof=0; eof<neof; eof++) {
+          val = pcday[eof] - clusters[eof+clust*neof];
+          sum_class += (val * val);
+        }
+        if (sqrt(sum_class) < dist_min) {
+          dist_min = sqrt(sum_class);
+          clust_dist_min = clust;
+        }
+      }
+    }
+    if (days_class_cluster != NULL) {
+      if (clust_dist_min == 999) {
+        /* Failing algorithm */
+        (void) fprintf(stderr, "%s: ABORT: Impossible: no cluster was selected!! Problem in algorithm...\n", __FILE__);
+        (void) abort();
+      }
+      days_class_cluster[nt] = clust_dist_min;
+    }
+  }
+
+  (void) free(pcnorm);
+  (void) free(clustnorm);
+}
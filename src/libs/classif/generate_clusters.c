@@ -55,63 +55,48 @@ LICENSE END */
 
 /** Algorithm to generate clusters based on the Michelangeli et al (1995) methodology. */
 int
-generate_clusters(double *clusters, double *pc_eof_days, char *type, int nclassif,
-                  int neof, int ncluster, int ndays) {
+generate_clusters(double *clusters, pc_days_struct *pc_days, char *type, char *init, int nclassif,
+                  int ncluster, unsigned long int seed, double tol) {
   /**
-     @param[out]     clusters      Clusters' positions.
-     @param[in]      pc_eof_days   Principal Components of EOF (daily data).
+     @param[in,out]  clusters      Clusters' positions. On input, initial cluster centers when init is provided.
+     @param[in]      pc_days       Principal Components of EOF (daily data), day-major.
      @param[in]      type          Type of distance used. Possible values: euclidian.
+     @param[in]      init          Type of initial cluster centers. Possible values: random, kmeans++, provided.
      @param[in]      nclassif      Maximum number of classifications to perform in the iterative algorithm.
-     @param[in]      neof          Number of EOFs.
      @param[in]      ncluster      Number of clusters.
-     @param[in]      ndays         Number of days in the pc_eof_days vector.
+     @param[in]      seed          Seed of the random number generator used to choose initial points.
+     @param[in]      tol           Also stop when no cluster center moved more than tol (PC-space distance). Disabled if <= 0.
 
      \return         Number of iterations.
   */
 
-  unsigned long int *random_num = NULL; /* Vector of random numbers for random choice of initial points. */
   int eof; /* Loop counter for EOF. */
   int clust; /* Loop counter for clusters. */
-  int day; /* Loop counter for days. */
   int classif; /* Loop counter for classifications. */
-  int ndays_cluster; /* Number of days in the current cluster. */
+  int *ndays_cluster = NULL; /* Number of days in each cluster. */
 
   const gsl_rng_type *T; /* For random number generation type. */
   gsl_rng *rng; /* For random number generation. */
 
-  double cluster_bary; /* Cluster barycentre. */
-  double ndiff_cluster_bary; /* Distance between current cluster barycenter and previous value in the iteration. */
-  double mean_days; /* Mean of the days (PC-space) for a cluster. */
+  double shift; /* Distance between the new cluster center and the previous one. */
+  double shift_max; /* Maximum distance between the new cluster centers and the previous ones. */
+  int nchanged; /* Number of days which changed cluster in the classification. */
   double *eof_days_cluster = NULL; /* Vector of clusters' barycenter positions (PC-space). */
   int *days_class_cluster = NULL; /* Vector of classification of days into each cluster. */
-
-  static unsigned long int seed = 0;
+  double *upper_bound = NULL; /* Upper bound of the distance between each day and its cluster. */
+  double *lower_bound = NULL; /* Lower bound of the distance between each day and other clusters. */
+  double *prev_cluster = NULL; /* Clusters' barycenter positions at the previous classification. */
+  int neof = pc_days->neof; /* Number of EOFs. */
+  int ndays = pc_days->ndays; /* Number of days. */
 
   (void) fprintf(stdout, "%s:: BEGIN: Find clusters among data points.\n", __FILE__);
 
-  /***********************************/
-  /** Generate ncluster random days **/
-  /***********************************/
-
-  (void) fprintf(stdout, "%s:: Choosing %d random points.\n", __FILE__, ncluster);
+  if ( strcmp(type, "euclidian") ) {
+    /* Unknown distance type */
+    (void) fprintf(stderr, "%s: ABORT: Unknown distance type=%s!!\n", __FILE__, type);
+    (void) abort();
+  }
 
-  /* Initialize random number generator */
-  T = gsl_rng_default;
-  rng = gsl_rng_alloc(T);
-  /** Warning: we are using time() as the seed. Don't run this subroutine twice with the same time.
-      If you do you will get the exact same sequence. **/
-  if (seed == 0) seed = time(NULL);
-  (void) gsl_rng_set(rng, seed++);
-  
-  /* Generate ncluster random days and initialize cluster PC array */
-  random_num = (unsigned long int *) calloc(ncluster, sizeof(unsigned long int));
-  if (random_num == NULL) alloc_error(__FILE__, __LINE__);
-  for (clust=0; clust<ncluster; clust++)
-    random_num[clust] = gsl_rng_uniform_int(rng, ndays);  
-  
-  /* Free random number generator */
-  (void) gsl_rng_free(rng);
-  
   /********************/
   /** Main algorithm **/
   /********************/
@@ -121,97 +106,90 @@ generate_clusters(double *clusters, double *pc_eof_days, char *type, int nclassi
   if (eof_days_cluster == NULL) alloc_error(__FILE__, __LINE__);
   days_class_cluster = (int *) calloc(ndays, sizeof(int));
   if (days_class_cluster == NULL) alloc_error(__FILE__, __LINE__);
+  upper_bound = (double *) malloc(ndays * sizeof(double));
+  if (upper_bound == NULL) alloc_error(__FILE__, __LINE__);
+  lower_bound = (double *) malloc(ndays * sizeof(double));
+  if (lower_bound == NULL) alloc_error(__FILE__, __LINE__);
+  prev_cluster = (double *) malloc(neof*ncluster * sizeof(double));
+  if (prev_cluster == NULL) alloc_error(__FILE__, __LINE__);
+  ndays_cluster = (int *) malloc(ncluster * sizeof(int));
+  if (ndays_cluster == NULL) alloc_error(__FILE__, __LINE__);
   
-  /* Initialize cluster PC array randomly */
-  (void) fprintf(stdout, "%s:: Initializing cluster array.\n", __FILE__);
-  for (eof=0; eof<neof; eof++)
-    for (clust=0; clust<ncluster; clust++) {
-      eof_days_cluster[eof+clust*neof] = pc_eof_days[random_num[clust]+eof*ndays];
-
-#if DEBUG >= 7
-      (void) fprintf(stderr, "eof=%d cluster=%d eof_days_cluster=%lf\n", eof, clust, eof_days_cluster[eof+clust*neof]);
-#endif
-    }
-
-  (void) free(random_num);
+  /* Initialize cluster PC array */
+  (void) fprintf(stdout, "%s:: Choosing %d initial points (%s).\n", __FILE__, ncluster, init);
+  if ( !strcmp(init, "provided") ) {
+    /* Warm start from the cluster centers given on input */
+    for (clust=0; clust<ncluster; clust++)
+      for (eof=0; eof<neof; eof++)
+        eof_days_cluster[eof+clust*neof] = clusters[eof+clust*neof];
+  }
+  else {
+    T = gsl_rng_default;
+    rng = gsl_rng_alloc(T);
+    /* Each call has its own generator so that concurrent calls with different seeds are independent and reproducible */
+    (void) gsl_rng_set(rng, seed);
+    (void) seed_clusters(eof_days_cluster, pc_days, init, rng, ncluster);
+    (void) gsl_rng_free(rng);
+  }
 
-  /* Iterate by performing up to nclassif classifications. Stop if same cluster center positions in two consecutive iterations. */
-  cluster_bary = -9999999999.9;
-  ndiff_cluster_bary = -9999999999.9;
+  /* Iterate by performing up to nclassif classifications. Stop when no day changed cluster, since cluster centers
+     would then be the same as the previous ones, or when no cluster center moved by more than tol. */
   classif = 0;
 
   (void) fprintf(stdout, "%s:: Iterate up to %d classifications or when classification is stable.\n", __FILE__, nclassif);
 
-  while (ndiff_cluster_bary != 0.0 && classif < nclassif) {
+  while (classif < nclassif) {
 
-#if DEBUG >= 7
-    (void) fprintf(stderr, "classif=%d cluster_bary=%lf\n", classif, cluster_bary);
-#endif
-
-    /* Classify each day (pc_eof_days) in the current clusters (eof_days_cluster) = days_class_cluster */
-    (void) class_days_pc_clusters(days_class_cluster, pc_eof_days, eof_days_cluster, type, neof, ncluster, ndays);
-
-    /* For each cluster, perform a mean of all points falling in that cluster.
-       Compare to the current clusters by calculating the 'coordinates' (PC-space) of the 'new' cluster center. */
-    cluster_bary = -9999999999.9;
-
-    /* Loop over clusters and EOFs */
-    for (clust=0; clust<ncluster; clust++) {
-      for (eof=0; eof<neof; eof++) {
-        mean_days = 0.0;
-        ndays_cluster = 0;
-
-        /* Compute the mean (PC-space) of all the days of the current cluster */
-        for (day=0; day<ndays; day++)
-          if (days_class_cluster[day] == clust) {
-            mean_days += pc_eof_days[day+eof*ndays];
-            ndays_cluster++;
-          }
-
-        if (ndays_cluster > 0) {
-
-          mean_days = mean_days / (double) ndays_cluster;
-
-          /** Try to find the maximum distance (PC-space) between the new cluster center and the previous value **/
+    /* Classify each day (pc_days) in the current clusters (eof_days_cluster) = days_class_cluster */
+    /* Distance bounds kept across iterations skip most distance computations once clusters move little */
+    nchanged = class_days_pc_clusters_bounds(days_class_cluster, upper_bound, lower_bound, prev_cluster, pc_days, eof_days_cluster,
+                                             (classif == 0), ncluster);
 
 #if DEBUG >= 7
-          (void) fprintf(stderr, "eof=%d cluster=%d diff_cluster_bary=%lf mean_days=%lf eof_days_cluster=%lf\n",
-                         eof, clust, fabs(mean_days - eof_days_cluster[eof+clust*neof]), mean_days, eof_days_cluster[eof+clust*neof]);
+    (void) fprintf(stderr, "classif=%d nchanged=%d\n", classif, nchanged);
 #endif
 
-          /* Compute the difference between the new cluster center position and the previous one */
-          ndiff_cluster_bary = fabs(mean_days - eof_days_cluster[eof+clust*neof]);
+    classif++;
 
-          /* If this new cluster center position is further away than the other EOF's ones, choose this new cluster center */
-          if ( ndiff_cluster_bary > cluster_bary )
-            cluster_bary = mean_days;
+    /* Stable classification: clusters already contains the cluster centers of this classification */
+    if (classif > 1 && nchanged == 0)
+      break;
 
-          /* Store the new cluster center value */
-          clusters[eof+clust*neof] = mean_days;
+    /* For each cluster, perform a mean of all points falling in that cluster (new cluster center),
+       and compute the distance (PC-space) between the new cluster center and the previous one. */
+    (void) update_clusters_centroid(clusters, ndays_cluster, pc_days, days_class_cluster, ncluster);
+
+    shift_max = 0.0;
+    for (clust=0; clust<ncluster; clust++) {
+      shift = 0.0;
+      for (eof=0; eof<neof; eof++)
+        shift += (clusters[eof+clust*neof] - eof_days_cluster[eof+clust*neof]) * (clusters[eof+clust*neof] - eof_days_cluster[eof+clust*neof]);
+      shift = sqrt(shift);
+      if (shift > shift_max)
+        shift_max = shift;
 
 #if DEBUG >= 7
-          if (classif == 0 || cluster_bary == 0.0)
-            (void) fprintf(stderr, "eof=%d cluster=%d mean_pc_days=%lf ndays_cluster=%d cluster_bary=%lf\n",
-                           eof, clust, mean_days, ndays_cluster, cluster_bary);
+      (void) fprintf(stderr, "cluster=%d ndays_cluster=%d shift=%lf\n", clust, ndays_cluster[clust], shift);
 #endif
-        }
-        else
-          clusters[eof+clust*neof] = 0;
-      }
     }
 
-    classif++;
+    /* Cluster centers did not move more than the tolerance */
+    if (tol > 0.0 && shift_max <= tol)
+      break;
 
     /* Update the cluster center matrix with the new values */
-    if (cluster_bary != 0.0 && classif < nclassif)
-      for (clust=0; clust<ncluster; clust++)
-        for (eof=0; eof<neof; eof++)
-          eof_days_cluster[eof+clust*neof] = clusters[eof+clust*neof];
+    for (clust=0; clust<ncluster; clust++)
+      for (eof=0; eof<neof; eof++)
+        eof_days_cluster[eof+clust*neof] = clusters[eof+clust*neof];
   }
 
   /* Free memory */
   (void) free(eof_days_cluster);
   (void) free(days_class_cluster);
+  (void) free(upper_bound);
+  (void) free(lower_bound);
+  (void) free(prev_cluster);
+  (void) free(ndays_cluster);
 
   (void) fprintf(stdout, "%s:: END: Find clusters among data points. %d iterations needed.\n", __FILE__, classif);
 
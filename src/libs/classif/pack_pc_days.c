@@ -0,0 +1,78 @@
+/* ***************************************************** */
+/* Pack principal components in day-major order.         */
+/* pack_pc_days.c                                        */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/*! \file pack_pc_days.c
+    \brief Pack principal components in day-major order.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <classif.h>
+
+/** Pack principal components stored EOF-major (pc[day+eof*ndays]) into a day-major pc_days_struct (pc[eof+day*neof]),
+    so that all EOFs of one day are contiguous in memory. */
+void
+pack_pc_days(pc_days_struct *pc_days, double *pc_eof_days, int neof, int ndays) {
+  /**
+     @param[out]     pc_days                 Day-major principal components. Memory is allocated.
+     @param[in]      pc_eof_days             Principal Components of EOF (daily data), EOF-major.
+     @param[in]      neof                    Number of EOFs.
+     @param[in]      ndays                   Number of days in the pc_eof_days vector.
+  */
+
+  int day; /* Loop counter for days */
+  int eof; /* Loop counter for eofs */
+
+  pc_days->neof = neof;
+  pc_days->ndays = ndays;
+  pc_days->pc = (double *) malloc(neof*ndays * sizeof(double));
+  if (pc_days->pc == NULL) alloc_error(__FILE__, __LINE__);
+
+  for (eof=0; eof<neof; eof++)
+    for (day=0; day<ndays; day++)
+      pc_days->pc[eof+day*neof] = pc_eof_days[day+eof*ndays];
+}
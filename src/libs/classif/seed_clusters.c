@@ -0,0 +1,158 @@
+/* ***************************************************** */
+/* Choose initial cluster centers among days             */
+/* in EOF space.                                         */
+/* seed_clusters.c                                       */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/*! \file seed_clusters.c
+    \brief Choose initial cluster centers among days in EOF space.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <classif.h>
+
+/** Choose initial cluster centers among days, either uniformly at random or with k-means++ seeding, where each new center is
+    drawn with a probability proportional to the squared distance of the day to the closest center already chosen. */
+void
+seed_clusters(double *eof_days_cluster, pc_days_struct *pc_days, char *init, gsl_rng *rng, int ncluster) {
+  /**
+     @param[out]     eof_days_cluster        Initial clusters' centroid positions for each eof.
+     @param[in]      pc_days                 Principal Components of EOF (daily data), day-major.
+     @param[in]      init                    Initialization type. Possible values: random, kmeans++.
+     @param[in]      rng                     Random number generator.
+     @param[in]      ncluster                Number of clusters.
+  */
+
+  unsigned long int *random_num = NULL; /* Vector of random numbers for random choice of initial points. */
+  double *dist_min = NULL; /* Squared distance of each day to the closest chosen center */
+  double dist_sum; /* Squared distance between a day and a center */
+  double dist_total; /* Sum of dist_min over all days */
+  double target; /* Random position in the cumulative sum of dist_min */
+  double val; /* Difference between a day and a center for one EOF */
+  int neof = pc_days->neof; /* Number of EOFs */
+  int ndays = pc_days->ndays; /* Number of days */
+  int day; /* Loop counter for days */
+  int day_pos; /* Last day with positive dist_min in the cumulative sum, -1 if none */
+  int day_next; /* Next day with positive dist_min after the drawn one */
+  int clust; /* Loop counter for clusters */
+  int eof; /* Loop counter for eofs */
+
+  if ( !strcmp(init, "random") ) {
+    /* Generate ncluster random days */
+    random_num = (unsigned long int *) calloc(ncluster, sizeof(unsigned long int));
+    if (random_num == NULL) alloc_error(__FILE__, __LINE__);
+    for (clust=0; clust<ncluster; clust++)
+      random_num[clust] = gsl_rng_uniform_int(rng, ndays);  
+    for (eof=0; eof<neof; eof++)
+      for (clust=0; clust<ncluster; clust++)
+        eof_days_cluster[eof+clust*neof] = pc_days->pc[eof+random_num[clust]*neof];
+    (void) free(random_num);
+  }
+  else if ( !strcmp(init, "kmeans++") ) {
+    dist_min = (double *) malloc(ndays * sizeof(double));
+    if (dist_min == NULL) alloc_error(__FILE__, __LINE__);
+
+    /* First center is a random day */
+    day = (int) gsl_rng_uniform_int(rng, ndays);
+    for (eof=0; eof<neof; eof++)
+      eof_days_cluster[eof] = pc_days->pc[eof+day*neof];
+    for (day=0; day<ndays; day++)
+      dist_min[day] = 9999999999.0;
+
+    for (clust=1; clust<ncluster; clust++) {
+      /* Update squared distance to closest center with the last chosen one */
+      dist_total = 0.0;
+      for (day=0; day<ndays; day++) {
+        dist_sum = 0.0;
+        for (eof=0; eof<neof; eof++) {
+          val = pc_days->pc[eof+day*neof] - eof_days_cluster[eof+(clust-1)*neof];
+          dist_sum += (val * val);
+        }
+        if (dist_sum < dist_min[day])
+          dist_min[day] = dist_sum;
+        dist_total += dist_min[day];
+      }
+
+      /* Draw next center with probability proportional to dist_min */
+      if (dist_total > 0.0) {
+        target = gsl_rng_uniform(rng) * dist_total;
+        day_pos = -1;
+        for (day=0; day<ndays-1; day++) {
+          if (dist_min[day] > 0.0) day_pos = day;
+          target -= dist_min[day];
+          if (target < 0.0) break;
+        }
+        /* Rounding could end on a day already chosen as center: take the nearest day with positive weight */
+        if (dist_min[day] == 0.0) {
+          for (day_next=day+1; day_next<ndays; day_next++)
+            if (dist_min[day_next] > 0.0) break;
+          if (day_pos < 0 || (day_next < ndays && (day_next - day) < (day - day_pos)))
+            day = day_next;
+          else
+            day = day_pos;
+        }
+      }
+      else
+        /* All days are on chosen centers */
+        day = (int) gsl_rng_uniform_int(rng, ndays);
+
+      for (eof=0; eof<neof; eof++)
+        eof_days_cluster[eof+clust*neof] = pc_days->pc[eof+day*neof];
+    }
+
+    (void) free(dist_min);
+  }
+  else {
+    (void) fprintf(stderr, "%s: ABORT: Unknown cluster initialization type=%s!!\n", __FILE__, init);
+    (void) abort();
+  }
+
+#if DEBUG >= 7
+  for (clust=0; clust<ncluster; clust++)
+    for (eof=0; eof<neof; eof++)
+      (void) fprintf(stderr, "eof=%d cluster=%d eof_days_cluster=%lf\n", eof, clust, eof_days_cluster[eof+clust*neof]);
+#endif
+}
@@ -0,0 +1,102 @@
+/* ***************************************************** */
+/* Compute the centroid of each cluster in EOF space     */
+/* in a single pass over the days.                       */
+/* update_clusters_centroid.c                            */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/*! \file update_clusters_centroid.c
+    \brief Compute the centroid of each cluster in EOF space in a single pass over the days.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <classif.h>
+
+/** Compute the centroid (mean of the principal components of its days) of each cluster. Sums and counts of all clusters
+    are accumulated in a single pass over the day-major principal components, instead of one pass over all days for each
+    (cluster, EOF) pair. Days are summed in the same order, so results are identical. Clusters with no day are set to 0. */
+void
+update_clusters_centroid(double *clusters, int *ndays_cluster, pc_days_struct *pc_days, int *days_class_cluster, int ncluster) {
+  /**
+     @param[out]     clusters                Clusters' centroid positions for each eof.
+     @param[out]     ndays_cluster           Number of days in each cluster.
+     @param[in]      pc_days                 Principal Components of EOF (daily data), day-major.
+     @param[in]      days_class_cluster      Cluster number associated for each day.
+     @param[in]      ncluster                Number of clusters.
+  */
+
+  double *sum = NULL; /* Sum of principal components of the days of each cluster */
+  double *pc = NULL; /* Principal components of current day */
+  double *sumclust = NULL; /* Sums of the cluster of current day */
+  int neof = pc_days->neof; /* Number of EOFs */
+  int day; /* Loop counter for days */
+  int clust; /* Loop counter for clusters */
+  int eof; /* Loop counter for eofs */
+
+  sum = (double *) calloc(neof*ncluster, sizeof(double));
+  if (sum == NULL) alloc_error(__FILE__, __LINE__);
+
+  for (clust=0; clust<ncluster; clust++)
+    ndays_cluster[clust] = 0;
+
+  /* Accumulate all clusters in one pass */
+  for (day=0; day<pc_days->ndays; day++) {
+    clust = days_class_cluster[day];
+    ndays_cluster[clust]++;
+    pc = &(pc_days->pc[day*neof]);
+    sumclust = &(sum[clust*neof]);
+    for (eof=0; eof<neof; eof++)
+      sumclust[eof] += pc[eof];
+  }
+
+  for (clust=0; clust<ncluster; clust++)
+    for (eof=0; eof<neof; eof++)
+      if (ndays_cluster[clust] > 0)
+        clusters[eof+clust*neof] = sum[eof+clust*neof] / (double) ndays_cluster[clust];
+      else
+        clusters[eof+clust*neof] = 0;
+
+  (void) free(sum);
+}
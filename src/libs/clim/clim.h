@@ -75,6 +75,7 @@ LICENSE END */
 #include <filter.h>
 
 /* Prototypes */
+void clim_daily_climyear(double *clim, double *bufin, tstruct *buftime, double missing_val, int ni, int nj, int ntime);
 void clim_daily_tserie_climyear(double *bufout, double *bufin, tstruct *buftime, double missing_val, int ni, int nj, int ntime);
 void remove_seasonal_cycle(double *bufout, double *clim, double *bufin, tstruct *buftime, double missing_val,
                            int filter_width, char *type, int clim_provided, int ni, int nj, int ntime);
@@ -0,0 +1,110 @@
+/* ***************************************************** */
+/* Compute daily climatology of a                        */
+/* 366-day climatological year.                          */
+/* clim_daily_climyear.c                                 */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/*! \file clim_daily_climyear.c
+    \brief Compute daily climatology of a 366-day climatological year.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <clim.h>
+
+/** Compute daily climatology of a 366-day climatological year from a daily time serie, in a single pass over the data. */
+void
+clim_daily_climyear(double *clim, double *bufin, tstruct *buftime, double missing_val, int ni, int nj, int nt) {
+  /**
+     @param[out]     clim          Output 3D matrix of daily climatology on 366 days.
+     @param[in]      bufin         Input 3D matrix.
+     @param[in]      buftime       Time vector for input vector data.
+     @param[in]      missing_val   Missing value.
+     @param[in]      ni            Horizontal dimension of buffer input vector.
+     @param[in]      nj            Horizontal dimension of buffer input vector.
+     @param[in]      nt            Temporal dimension of buffer input vector.
+  */
+
+  int *ndays = NULL; /* Number of matching days, for each day of the climatological year. */
+  int dayofclimy; /* Day of the 366-day climatological year, starting at 0. */
+
+  int t; /* Loop counter for time. */
+  int i; /* Loop counter for ni. */
+  int j; /* Loop counter for nj. */
+  int day; /* Loop counter for days of the climatological year. */
+  int npts = ni*nj; /* Number of grid points. */
+
+  /* Allocate memory */
+  ndays = (int *) calloc(366*npts, sizeof(int));
+  if (ndays == NULL) alloc_error(__FILE__, __LINE__);
+
+  for (i=0; i<366*npts; i++)
+    clim[i] = 0.0;
+
+  /* Accumulate in a single pass over all the times the values for each day and month of the climatological year */
+  for (t=0; t<nt; t++)
+    if (buftime[t].month >= 1 && buftime[t].month <= 12 && buftime[t].day >= 1 && buftime[t].day <= 31) {
+      dayofclimy = dayofclimyear(buftime[t].day, buftime[t].month) - 1;
+      for (j=0; j<nj; j++)
+        for (i=0; i<ni; i++)
+          if (bufin[i+j*ni+t*npts] != missing_val) {
+            /* Ignore missing values */
+            clim[i+j*ni+dayofclimy*npts] += bufin[i+j*ni+t*npts]; /* Sum all the values for this matching day/month */
+            ndays[i+j*ni+dayofclimy*npts]++;
+          }
+    }
+
+  /* Compute the mean over all the matching days */
+  for (day=0; day<366; day++)
+    for (j=0; j<nj; j++)
+      for (i=0; i<ni; i++)
+        if (ndays[i+j*ni+day*npts] > 0)
+          clim[i+j*ni+day*npts] = clim[i+j*ni+day*npts] / (double) ndays[i+j*ni+day*npts];
+        else
+          clim[i+j*ni+day*npts] = missing_val;
+
+  /* Free memory */
+  (void) free(ndays);
+}
@@ -66,72 +66,32 @@ clim_daily_tserie_climyear(double *bufout, double *bufin, tstruct *buftime, doub
      @param[in]      nt         Temporal dimension of buffer input vector.
   */
 
-  int *index = NULL; /* Index to flag matching a specific day and month in a time serie covering several years. */
-  double *sum; /* Sum over all matching days. */
-  int *ndays = NULL; /* Number of days matching days. */
-  int month; /* Climatological month. */
+  double *clim = NULL; /* Daily climatology on 366 days. */
+  int dayofclimy; /* Day of the 366-day climatological year, starting at 0. */
 
   int t; /* Loop counter for time. */
   int i; /* Loop counter for ni. */
   int j; /* Loop counter for nj. */
-  int day; /* Loop counter for days. */
+  int npts = ni*nj; /* Number of grid points. */
 
   (void) fprintf(stdout, "%s: Computing climatological months of a daily time serie.\n", __FILE__);
 
   /* Allocate memory */
-  index = (int *) calloc(nt, sizeof(int));
-  if (index == NULL) alloc_error(__FILE__, __LINE__);
-  sum = (double *) malloc(ni*nj * sizeof(double));
-  if (sum == NULL) alloc_error(__FILE__, __LINE__);
-  ndays = (int *) malloc(ni*nj * sizeof(int));
-  if (ndays == NULL) alloc_error(__FILE__, __LINE__);
-
-  /* Loop over the 12 months of the year to generate daily climatological months */
-  for (month=1; month<=12; month++) {
-    
-    /* Loop over each day of the month */
-    for (day=1; day<=31; day++) {
-      
+  clim = (double *) malloc(366*npts * sizeof(double));
+  if (clim == NULL) alloc_error(__FILE__, __LINE__);
+
+  /* Compute daily climatology on 366 days */
+  (void) clim_daily_climyear(clim, bufin, buftime, missing_val, ni, nj, nt);
+
+  /* Assign mean value for all days used in computing this mean */
+  for (t=0; t<nt; t++)
+    if (buftime[t].month >= 1 && buftime[t].month <= 12 && buftime[t].day >= 1 && buftime[t].day <= 31) {
+      dayofclimy = dayofclimyear(buftime[t].day, buftime[t].month) - 1;
       for (j=0; j<nj; j++)
-        for (i=0; i<ni; i++) {
-          sum[i+j*ni] = 0.0;
-          ndays[i+j*ni] = 0; /* Initialize the number of days */
-        }
-      
-      /* Loop over all the times */
-      for (t=0; t<nt; t++) {
-        /* Initialize */
-        index[t] = 0;
-        if (buftime[t].day == day && buftime[t].month == month) {
-          /* The climatological day and month match */
-          index[t] = 1; /* Flag it */
-          for (j=0; j<nj; j++)
-            for (i=0; i<ni; i++)
-              if (bufin[i+j*ni+t*ni*nj] != missing_val) {
-                /* Ignore missing values */
-                sum[i+j*ni] += bufin[i+j*ni+t*ni*nj]; /* Sum all the values for this matching day/month */
-                ndays[i+j*ni]++;
-              }
-        }
-      }
-      for (t=0; t<nt; t++)
-        /* Compute the mean over all the matching days and apply mean for all these flagged days */
-        /* Assign mean value for all flagged days used in computing this mean */
-        if (index[t] == 1) {
-          for (j=0; j<nj; j++)
-            for (i=0; i<ni; i++)
-              if (ndays[i+j*ni] > 0) {
-                bufout[i+j*ni+t*ni*nj] = sum[i+j*ni] / (double) ndays[i+j*ni];
-              }
-              else {
-                bufout[i+j*ni+t*ni*nj] = missing_val;
-              }
-        }
+        for (i=0; i<ni; i++)
+          bufout[i+j*ni+t*npts] = clim[i+j*ni+dayofclimy*npts];
     }
-  }
 
   /* Free memory */
-  (void) free(index);
-  (void) free(sum);
-  (void) free(ndays);
+  (void) free(clim);
 }
@@ -62,7 +62,7 @@ remove_seasonal_cycle(double *bufout, double *clim, double *bufin, tstruct *buft
      @param[out,in]  clim          Climatology vector (on 366 days). Can be already provided as input or not (clim_provided parameter).
      @param[in]      bufin         Input 3D matrix.
      @param[in]      buftime       Time vector for input vector data.
-     @param[in]      type          Type of filter. Possible values: hanning.
+     @param[in]      type          Type of filter. Possible values: hanning, hamming, blackman, rectangular.
      @param[in]      missing_val   Missing value.
      @param[in]      filter_width  Width of filter.
      @param[in]      clim_provided Set to 1 if clim is already calculated and provided as input.
@@ -75,58 +75,55 @@ remove_seasonal_cycle(double *bufout, double *clim, double *bufin, tstruct *buft
   int i; /* Loop counter for ni. */
   int j; /* Loop counter for nj. */
   int t; /* Loop counter. */
-  int ndays_m = 31; /* Maximum number of days in a month. */
-  int month; /* Climatological month. */
   int day; /* Climatological day. */
+  int prevday; /* Previous climatological day with data. */
+  int nextday; /* Next climatological day with data. */
   int dayofclimy; /* Day of year in a 366-day climatological year */
-
-  /* Allocate temporay buffer memory. */
-  tmpbuf = (double *) calloc(ni*nj*ntime, sizeof(double));
-  if (tmpbuf == NULL) alloc_error(__FILE__, __LINE__);
+  int npts = ni*nj; /* Number of grid points. */
 
   (void) fprintf(stdout, "%s: Removing seasonal cycle for a time serie.\n", __FILE__);
 
   if (clim_provided != TRUE) {
     /* Climatology field was not provided */
 
+    /* Allocate temporay buffer memory. */
+    tmpbuf = (double *) malloc(366*npts * sizeof(double));
+    if (tmpbuf == NULL) alloc_error(__FILE__, __LINE__);
+
     /* Compute daily climatologies for climatological year */
-    (void) clim_daily_tserie_climyear(bufout, bufin, buftime, missing_val, ni, nj, ntime);
-    (void) fprintf(stdout, "%s: Using a %s filter for climatology (wrap edges).\n", __FILE__, type);
-    /* Filter climatologies using a filter (wrap edges) */
-    (void) filter(tmpbuf, bufout, type, filter_width, ni, nj, ntime);
-    
-    /* Remove climatology from time serie */
-    for (t=0; t<ntime; t++)
-      for (j=0; j<nj; j++)
-        for (i=0; i<ni; i++)
-          bufout[i+j*ni+t*ni*nj] = bufin[i+j*ni+t*ni*nj] - tmpbuf[i+j*ni+t*ni*nj];
-    
-    /** Output filtered climatology value **/
-    for (month=0; month<12; month++)
-      for (day=0; day<ndays_m; day++)
-        /* Loop over all the times */
-        for (t=0; t<ntime; t++) {
-          if (buftime[t].day == (day+1) && buftime[t].month == (month+1)) {
-            dayofclimy = dayofclimyear(day+1, month+1);
-            for (j=0; j<nj; j++)
-              for (i=0; i<ni; i++)
-                clim[i+j*ni+(dayofclimy-1)*ni*nj] = tmpbuf[i+j*ni+t*ni*nj];
-            /* Exit loop: matched month and day */
-            t = ntime;
+    (void) clim_daily_climyear(tmpbuf, bufin, buftime, missing_val, ni, nj, ntime);
+
+    /* Days of the climatological year without data (such as February 29th in a serie without leap years) */
+    /* are linearly interpolated from surrounding days, wrapping around the year, so that they do not bias the filter */
+    for (j=0; j<nj; j++)
+      for (i=0; i<ni; i++)
+        for (day=0; day<366; day++)
+          if (tmpbuf[i+j*ni+day*npts] == missing_val) {
+            for (prevday=1; prevday<366; prevday++)
+              if (tmpbuf[i+j*ni+((day-prevday+366)%366)*npts] != missing_val)
+                break;
+            for (nextday=1; nextday<366; nextday++)
+              if (tmpbuf[i+j*ni+((day+nextday)%366)*npts] != missing_val)
+                break;
+            if (prevday < 366)
+              tmpbuf[i+j*ni+day*npts] = ( (double) nextday * tmpbuf[i+j*ni+((day-prevday+366)%366)*npts] +
+                                          (double) prevday * tmpbuf[i+j*ni+((day+nextday)%366)*npts] ) /
+                (double) (prevday + nextday);
           }
-        }
+
+    (void) fprintf(stdout, "%s: Using a %s filter for climatology (wrap edges).\n", __FILE__, type);
+    /* Filter the 366-day climatological cycle using a filter (wrap edges: circular) */
+    (void) filter(clim, tmpbuf, type, filter_width, ni, nj, 366);
+
+    /* Free memory */
+    (void) free(tmpbuf);
   }
-  else {
-    /* Climatology field was provided */
-    /* Loop over all the times */
-    for (t=0; t<ntime; t++) {
-      dayofclimy = dayofclimyear(buftime[t].day, buftime[t].month);
-      for (j=0; j<nj; j++)
-        for (i=0; i<ni; i++)
-          bufout[i+j*ni+t*ni*nj] = bufin[i+j*ni+t*ni*nj] - clim[i+j*ni+(dayofclimy-1)*ni*nj];
-    }
+
+  /* Remove climatology from time serie */
+  for (t=0; t<ntime; t++) {
+    dayofclimy = dayofclimyear(buftime[t].day, buftime[t].month);
+    for (j=0; j<nj; j++)
+      for (i=0; i<ni; i++)
+        bufout[i+j*ni+t*npts] = bufin[i+j*ni+t*npts] - clim[i+j*ni+(dayofclimy-1)*npts];
   }
-  
-  /* Free memory */
-  (void) free(tmpbuf);
 }
@@ -69,12 +69,22 @@ LICENSE END */
 #include <string.h>
 #endif
 
+#include <gsl/gsl_fft_real.h>
+#include <gsl/gsl_fft_halfcomplex.h>
+
 /* Local dependent includes */
 #include <misc.h>
 
+/** Number of grid points processed together by the filter kernels. */
+#define FILTER_BLOCK 64
+/** Minimum filter width for which the FFT convolution is used instead of the direct one. */
+#define FILTER_FFT_MIN_WIDTH 32
+
 /* Prototypes */
 void filter(double *bufferf, double *buffer, char *type, int width, int ni, int nj, int nt);
 void filter_window(double **filter_window, char *type, int width);
+void filter_direct(double *bufferf, double *buffer, double *filter_window, int width, int npts, int nt);
+void filter_fft(double *bufferf, double *buffer, double *filter_window, int width, int npts, int nt);
 
 #endif
 
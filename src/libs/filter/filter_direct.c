@@ -0,0 +1,119 @@
+/* ***************************************************** */
+/* Direct convolution filter on blocks                   */
+/* of grid points.                                       */
+/* filter_direct.c                                       */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/*! \file filter_direct.c
+    \brief Direct convolution filter on blocks of grid points. Uses wrap edges.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <filter.h>
+
+/** Direct convolution filter, applied to blocks of grid points at once. Uses wrap edges. */
+void
+filter_direct(double *bufferf, double *buffer, double *filter_window, int width, int npts, int nt) {
+  /**
+     @param[out]     bufferf         Filtered version of buffer input matrix.
+     @param[in]      buffer          Input matrix, dimensioned npts x nt.
+     @param[in]      filter_window   Filter window vector.
+     @param[in]      width           Width of filter.
+     @param[in]      npts            Number of grid points of buffer input matrix.
+     @param[in]      nt              Temporal dimension of buffer input matrix.
+  */
+
+  double *tmpbuf = NULL; /* Block of grid points expanded in time: wrapping edges. */
+  double *sum = NULL; /* To sum values over filter window width, for each grid point of the block. */
+  double *row = NULL; /* Pointer to one time step of the expanded block. */
+  double weight; /* Filter window weight. */
+
+  int half_width; /* Half-width of filter window. */
+  int ntaps; /* Number of filter window values used. */
+  int pt; /* First grid point of the block. */
+  int nb; /* Number of grid points in the block. */
+  int p; /* Loop counter for grid points of the block. */
+  int t; /* Loop counter. */
+  int tt; /* Loop counter. */
+
+  /* Half-width */
+  half_width = ( width - 1 ) / 2;
+  ntaps = width - 1;
+
+  /* Expanded version of a block of grid points: times are rows of FILTER_BLOCK contiguous grid points */
+  tmpbuf = (double *) malloc((nt+ntaps) * FILTER_BLOCK * sizeof(double));
+  if (tmpbuf == NULL) alloc_error(__FILE__, __LINE__);
+  sum = (double *) malloc(FILTER_BLOCK * sizeof(double));
+  if (sum == NULL) alloc_error(__FILE__, __LINE__);
+
+  for (pt=0; pt<npts; pt+=FILTER_BLOCK) {
+    nb = ( (npts-pt) < FILTER_BLOCK ) ? (npts-pt) : FILTER_BLOCK;
+
+    /* Gather the block, wrapping edges */
+    for (tt=0; tt<(nt+ntaps); tt++) {
+      t = (tt - half_width) % nt;
+      if (t < 0) t += nt;
+      (void) memcpy(&(tmpbuf[tt*nb]), &(buffer[pt+t*npts]), nb * sizeof(double));
+    }
+
+    /* Apply filter to all grid points of the block at once */
+    for (t=0; t<nt; t++) {
+      for (p=0; p<nb; p++)
+        sum[p] = 0.0;
+      for (tt=0; tt<ntaps; tt++) {
+        weight = filter_window[tt];
+        row = &(tmpbuf[(t+tt)*nb]);
+        for (p=0; p<nb; p++)
+          sum[p] += weight * row[p];
+      }
+      (void) memcpy(&(bufferf[pt+t*npts]), sum, nb * sizeof(double));
+    }
+  }
+
+  /* Free memory */
+  (void) free(tmpbuf);
+  (void) free(sum);
+}
@@ -0,0 +1,148 @@
+/* ***************************************************** */
+/* FFT convolution filter on blocks                      */
+/* of grid points.                                       */
+/* filter_fft.c                                          */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/*! \file filter_fft.c
+    \brief FFT convolution filter on blocks of grid points. Uses wrap edges.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <filter.h>
+
+/** FFT (circular) convolution filter, applied to blocks of grid points transposed to time-contiguous series. Uses wrap edges. */
+void
+filter_fft(double *bufferf, double *buffer, double *filter_window, int width, int npts, int nt) {
+  /**
+     @param[out]     bufferf         Filtered version of buffer input matrix.
+     @param[in]      buffer          Input matrix, dimensioned npts x nt.
+     @param[in]      filter_window   Filter window vector.
+     @param[in]      width           Width of filter.
+     @param[in]      npts            Number of grid points of buffer input matrix.
+     @param[in]      nt              Temporal dimension of buffer input matrix.
+  */
+
+  double *kernel = NULL; /* Filter window as a circular convolution kernel of length nt, then its transform */
+  double *tmpbuf = NULL; /* Block of grid points, time-contiguous for each grid point. */
+  double *serie = NULL; /* Pointer to the time serie of one grid point of the block. */
+  double re; /* Real part of a complex value. */
+  double im; /* Imaginary part of a complex value. */
+
+  gsl_fft_real_wavetable *real = NULL; /* Real FFT trigonometric tables */
+  gsl_fft_halfcomplex_wavetable *hc = NULL; /* Inverse FFT trigonometric tables */
+  gsl_fft_real_workspace *work = NULL; /* FFT workspace */
+
+  int half_width; /* Half-width of filter window. */
+  int ntaps; /* Number of filter window values used. */
+  int pt; /* First grid point of the block. */
+  int nb; /* Number of grid points in the block. */
+  int p; /* Loop counter for grid points of the block. */
+  int t; /* Loop counter. */
+  int k; /* Loop counter for frequencies. */
+
+  /* Half-width */
+  half_width = ( width - 1 ) / 2;
+  ntaps = width - 1;
+
+  /* Allocate memory */
+  kernel = (double *) calloc(nt, sizeof(double));
+  if (kernel == NULL) alloc_error(__FILE__, __LINE__);
+  tmpbuf = (double *) malloc(nt * FILTER_BLOCK * sizeof(double));
+  if (tmpbuf == NULL) alloc_error(__FILE__, __LINE__);
+  real = gsl_fft_real_wavetable_alloc((size_t) nt);
+  if (real == NULL) alloc_error(__FILE__, __LINE__);
+  hc = gsl_fft_halfcomplex_wavetable_alloc((size_t) nt);
+  if (hc == NULL) alloc_error(__FILE__, __LINE__);
+  work = gsl_fft_real_workspace_alloc((size_t) nt);
+  if (work == NULL) alloc_error(__FILE__, __LINE__);
+
+  /* Output at time t is the sum over tt of filter_window[tt] * buffer[t+tt-half_width]: */
+  /* this is a circular convolution with the kernel filter_window[tt] located at half_width-tt */
+  for (t=0; t<ntaps; t++) {
+    k = (half_width - t) % nt;
+    if (k < 0) k += nt;
+    kernel[k] += filter_window[t];
+  }
+  (void) gsl_fft_real_transform(kernel, (size_t) 1, (size_t) nt, real, work);
+
+  for (pt=0; pt<npts; pt+=FILTER_BLOCK) {
+    nb = ( (npts-pt) < FILTER_BLOCK ) ? (npts-pt) : FILTER_BLOCK;
+
+    /* Transpose the block to time-contiguous series */
+    for (t=0; t<nt; t++)
+      for (p=0; p<nb; p++)
+        tmpbuf[t+p*nt] = buffer[pt+p+t*npts];
+
+    for (p=0; p<nb; p++) {
+      serie = &(tmpbuf[p*nt]);
+      (void) gsl_fft_real_transform(serie, (size_t) 1, (size_t) nt, real, work);
+      /* Multiply transforms, stored in mixed-radix halfcomplex format */
+      serie[0] *= kernel[0];
+      for (k=1; 2*k<nt; k++) {
+        re = serie[2*k-1];
+        im = serie[2*k];
+        serie[2*k-1] = re * kernel[2*k-1] - im * kernel[2*k];
+        serie[2*k] = re * kernel[2*k] + im * kernel[2*k-1];
+      }
+      if (nt % 2 == 0)
+        serie[nt-1] *= kernel[nt-1];
+      (void) gsl_fft_halfcomplex_inverse(serie, (size_t) 1, (size_t) nt, hc, work);
+    }
+
+    /* Transpose back */
+    for (t=0; t<nt; t++)
+      for (p=0; p<nb; p++)
+        bufferf[pt+p+t*npts] = tmpbuf[t+p*nt];
+  }
+
+  /* Free memory */
+  (void) free(kernel);
+  (void) free(tmpbuf);
+  gsl_fft_real_wavetable_free(real);
+  gsl_fft_halfcomplex_wavetable_free(hc);
+  gsl_fft_real_workspace_free(work);
+}
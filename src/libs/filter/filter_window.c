@@ -53,20 +53,24 @@ LICENSE END */
 
 #include <filter.h>
 
-/** Filter window subroutine. Uses hanning. */
+/** Filter window subroutine. Uses hanning, hamming, blackman or rectangular window. */
 void
 filter_window(double **filter_window, char *type, int width) {
   /**
      @param[out]     filter_window     Output filter window vector.
-     @param[in]      type              Type of filter. Possible values: hanning.
-     @param[in]      width             Width of filter.
+     @param[in]      type              Type of filter. Possible values: hanning, hamming, blackman, rectangular.
+     @param[in]      width             Width of filter. The filtering kernels use its first width-1 values.
   */
 
-  double scale_factor; /* Hanning filter scale factor. */
-  double alpha = 0.5; /* alpha value for hanning filter. */
+  double scale_factor; /* Window scale factor. */
+  double alpha; /* alpha value for hanning and hamming filters. */
   double sum; /* Sum for normalizing filter window. */
+  int ntaps; /* Number of filter window values used by the filtering kernels. */
   int i; /* Loop counter. */
 
+  /* Filtering kernels use the first width-1 values of the window */
+  ntaps = width - 1;
+
   /* Check if number is odd. If it is, make it even by adding one. */
   if (width % 2 != 0) width++;
 
@@ -74,27 +78,40 @@ filter_window(double **filter_window, char *type, int width) {
   (*filter_window) = (double *) calloc(width, sizeof(double));
   if ((*filter_window) == NULL) alloc_error(__FILE__, __LINE__);
   
-  if ( !strcmp(type, "hanning") ) {
-    /** We are using a hanning filter. **/
-    
-    /* Scale factor */
-    scale_factor = 2.0 * M_PI / (double) width;
-    
-    /* Compute filter window. */
-    sum = 0.0;
-    for (i=0; i<width; i++) {
-      /* Hanning definition */
+  /* Scale factor */
+  scale_factor = 2.0 * M_PI / (double) width;
+
+  if ( !strcmp(type, "hanning") || !strcmp(type, "hamming") ) {
+    /** We are using a hanning or hamming filter. **/
+    if ( !strcmp(type, "hanning") )
+      alpha = 0.5;
+    else
+      alpha = 0.54;
+    for (i=0; i<width; i++)
+      /* Hanning and hamming definition */
       (*filter_window)[i] = (alpha - 1.0) * cos( ((double) i) * scale_factor) + alpha;
-      sum += (*filter_window)[i];
-    }
-    
-    /* Normalizing to 1.0 */
+  }
+  else if ( !strcmp(type, "blackman") ) {
+    /** We are using a blackman filter. **/
     for (i=0; i<width; i++)
-      (*filter_window)[i] /= sum;
+      /* Blackman definition */
+      (*filter_window)[i] = 0.42 - 0.5 * cos( ((double) i) * scale_factor) + 0.08 * cos( 2.0 * ((double) i) * scale_factor);
+  }
+  else if ( !strcmp(type, "rectangular") ) {
+    /** We are using a rectangular filter: running mean over the ntaps values used when filtering. **/
+    for (i=0; i<ntaps; i++)
+      (*filter_window)[i] = 1.0;
   }
   else {
     /* Unknown filter type */
     (void) fprintf(stderr, "%s: ABORT: Unknown filtering type: %s\n", __FILE__, type);
     (void) abort();
   }
+
+  /* Normalizing to 1.0 */
+  sum = 0.0;
+  for (i=0; i<width; i++)
+    sum += (*filter_window)[i];
+  for (i=0; i<width; i++)
+    (*filter_window)[i] /= sum;
 }
@@ -81,6 +81,21 @@ get_time_attributes(char **time_units, char **cal_type, char *filename, char *va
 
   size_t t_len; /* Length of time units string */
 
+  meta_cache_struct *cache = NULL; /* Metadata cache entry */
+  char *key = NULL; /* Metadata cache request identifier */
+
+  /* Serve request from metadata cache if time attributes of this file were already read */
+  key = (char *) malloc((strlen(varname)+11) * sizeof(char));
+  if (key == NULL) alloc_error(__FILE__, __LINE__);
+  (void) sprintf(key, "timeattr %s", varname);
+  cache = meta_cache_find(filename, key);
+  if (cache != NULL) {
+    (*time_units) = strdup(cache->time_units);
+    (*cal_type) = strdup(cache->cal_type);
+    (void) free(key);
+    return 0;
+  }
+
   /* Read data in NetCDF file */
 
   /* Open NetCDF file for reading */
@@ -127,6 +142,14 @@ get_time_attributes(char **time_units, char **cal_type, char *filename, char *va
   istat = ncclose(ncinid);
   if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
 
+  /* Keep time attributes in metadata cache */
+  cache = meta_cache_add(filename, key);
+  if (cache != NULL) {
+    cache->time_units = strdup(*time_units);
+    cache->cal_type = strdup(*cal_type);
+  }
+  (void) free(key);
+
   /* Success status */
   return 0;
 }
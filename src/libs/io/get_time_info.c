@@ -98,8 +98,28 @@ get_time_info(time_vect_struct *time_s, double **timeval, char **time_units, cha
   ut_system *unitSystem = NULL; /* Unit System (udunits) */
   ut_unit *dataunits = NULL; /* Data units (udunits) */
 
+  meta_cache_struct *cache = NULL; /* Metadata cache entry */
+  char *key = NULL; /* Metadata cache request identifier */
+
   int t; /* Time loop counter */
 
+  /* Serve request from metadata cache if time information of this file was already read */
+  key = (char *) malloc((strlen(varname)+6) * sizeof(char));
+  if (key == NULL) alloc_error(__FILE__, __LINE__);
+  (void) sprintf(key, "time %s", varname);
+  cache = meta_cache_find(filename, key);
+  if (cache != NULL) {
+    if (outinfo == TRUE)
+      printf("%s: Using cached time information of NetCDF input file %s\n", __FILE__, filename);
+    *ntime = cache->n1;
+    (*timeval) = meta_cache_dup(cache->val1, cache->n1);
+    (*time_units) = strdup(cache->time_units);
+    (*cal_type) = strdup(cache->cal_type);
+    meta_cache_copy_time(time_s, cache->time_s, cache->n1);
+    (void) free(key);
+    return 0;
+  }
+
   /* Read data in NetCDF file */
 
   /* Open NetCDF file for reading */
@@ -127,6 +147,7 @@ get_time_info(time_vect_struct *time_s, double **timeval, char **time_units, cha
   
   if (varndims != 1) {
     (void) fprintf(stderr, "Error NetCDF type and/or dimensions Line %d.\n", __LINE__);
+    (void) free(key);
     return -1;
   }
 
@@ -209,6 +230,7 @@ get_time_info(time_vect_struct *time_s, double **timeval, char **time_units, cha
     if (istat < 0) {
       (void) ut_free(dataunits);
       (void) ut_free_system(unitSystem);  
+      (void) free(key);
       return -1;
     }
   }
@@ -220,6 +242,19 @@ get_time_info(time_vect_struct *time_s, double **timeval, char **time_units, cha
   istat = ncclose(ncinid);
   if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
 
+  /* Keep time information in metadata cache */
+  cache = meta_cache_add(filename, key);
+  if (cache != NULL) {
+    cache->n1 = *ntime;
+    cache->val1 = meta_cache_dup(*timeval, *ntime);
+    cache->time_units = strdup(*time_units);
+    cache->cal_type = strdup(*cal_type);
+    cache->time_s = (time_vect_struct *) malloc(sizeof(time_vect_struct));
+    if (cache->time_s == NULL) alloc_error(__FILE__, __LINE__);
+    meta_cache_copy_time(cache->time_s, time_s, *ntime);
+  }
+  (void) free(key);
+
   /* Success status */
   return 0;
 }
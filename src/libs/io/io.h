@@ -161,6 +161,31 @@ typedef struct {
   double *seconds; /**< Seconds of the minute 0-59. */
 } time_vect_struct;
 
+/** Maximum number of entries in the NetCDF metadata cache. */
+#define META_CACHE_MAX 64
+
+/** NetCDF metadata cache entry, keyed by filename and metadata request. The cache is for single-thread use only. **/
+typedef struct {
+  char *filename; /**< NetCDF filename. */
+  char *key; /**< Metadata request identifier: kind and variable names. */
+  time_t mtime; /**< File modification time when cached. */
+  off_t size; /**< File size when cached. */
+  int n1; /**< First dimension length: time, longitude or X. */
+  int n2; /**< Second dimension length: latitude or Y, or flag of time values fixed by read_netcdf_dims_3d. */
+  double *val1; /**< Time, longitude or X values. */
+  double *val2; /**< Latitude or Y values. */
+  char *time_units; /**< Time units (udunits). */
+  char *cal_type; /**< Calendar-type (udunits). */
+  time_vect_struct *time_s; /**< Time information in a time structure. */
+  info_field_struct *info_field; /**< Variable information. */
+  proj_struct *proj; /**< Horizontal projection of the variable. */
+} meta_cache_struct;
+
+/** Counter of bytes read from NetCDF files. */
+#define IO_STATS_READ 0
+/** Counter of bytes written to NetCDF files. */
+#define IO_STATS_WRITTEN 1
+
 /* NetCDF-related includes */
 #include <zlib.h>
 #include <hdf5.h>
@@ -187,6 +212,8 @@ int read_netcdf_var_3d(double **buf, info_field_struct *info_field, proj_struct
                        char *dimxname, char *dimyname, char *timename, int *nlon, int *nlat, int *ntime, int outinfo);
 int read_netcdf_var_3d_2d(double **buf, info_field_struct *info_field, proj_struct *proj, char *filename, char *varname,
                           char *dimxname, char *dimyname, char *timename, int t, int *nlon, int *nlat, int *ntime, int outinfo);
+int read_netcdf_var_3d_chunk(double **buf, char *filename, char *varname, char *dimxname, char *dimyname, char *timename,
+                             int tstart, int tcount, int *nlon, int *nlat, int *ntime, int outinfo);
 int read_netcdf_var_2d(double **buf, info_field_struct *info_field, proj_struct *proj, char *filename, char *varname,
                        char *dimxname, char *dimyname, int *nlon, int *nlat, int outinfo);
 int read_netcdf_var_1d(double **buf, info_field_struct *info_field, char *filename, char *varname,
@@ -199,6 +226,9 @@ int write_netcdf_var_3d_2d(double *buf, double *timein, double fillvalue, char *
                            char *varname, char *longname, char *units, char *height,
                            char *gridname, char *lonname, char *latname, char *timename,
                            int t, int newfile, int format, int compression_level, int nlon, int nlat, int ntime, int outinfo);
+int write_netcdf_eof(double *eof, double *sing, double fillvalue, double *lon, double *lat, char *filename,
+                     char *eofvarname, char *singvarname, char *coords, char *lonname, char *latname,
+                     char *dimxname, char *dimyname, char *eofname, int nlon, int nlat, int neof);
 int write_netcdf_dims_3d(double *lon, double *lat, double *x, double *y, double *alt, double *timein, char *cal_type, char *time_units,
                          int nlon, int nlat, int ntime, char *timestep, char *gridname, char *coords,
                          char *grid_mapping_name, double latin1, double latin2,
@@ -219,5 +249,14 @@ int get_time_info(time_vect_struct *time_s, double **timeval, char **time_units,
                   char *varname, int outinfo);
 int compute_time_info(time_vect_struct *time_s, double *timeval, char *time_units, char *cal_type, int ntime);
 void handle_netcdf_error(int status, char *srcfilename, int lineno);
+int prefetch_file(char *filename);
+meta_cache_struct *meta_cache_find(char *filename, char *key);
+meta_cache_struct *meta_cache_add(char *filename, char *key);
+double *meta_cache_dup(double *buf, int n);
+void meta_cache_copy_time(time_vect_struct *time_out, time_vect_struct *time_in, int ntime);
+void meta_cache_free(void);
+void io_stats_add(int kind, size_t *count, int ndims, size_t size);
+void io_stats_get(unsigned long long *nread, unsigned long long *nwritten);
+void io_stats_reset(void);
 
 #endif
@@ -0,0 +1,114 @@
+/* ***************************************************** */
+/* io_stats Counters of NetCDF data volume.              */
+/* io_stats.c                                            */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file io_stats.c
+    \brief Counters of data volume read from and written to NetCDF files.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <io.h>
+
+#include <pthread.h>
+
+/* Bytes of data values read from and written to NetCDF files by the process */
+static unsigned long long io_stats_bytes[2] = { 0, 0 };
+/* Lock protecting the counters when reading or writing from several threads */
+static pthread_mutex_t io_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** Add the size of a data block read from or written to a NetCDF file to the counters. */
+void
+io_stats_add(int kind, size_t *count, int ndims, size_t size) {
+  /**
+     @param[in]  kind       IO_STATS_READ or IO_STATS_WRITTEN.
+     @param[in]  count      Number of elements along each dimension of the block.
+     @param[in]  ndims      Number of dimensions of the block (0 for a single value).
+     @param[in]  size       Size in bytes of one element.
+  */
+
+  unsigned long long nbytes = (unsigned long long) size; /* Size of the block in bytes */
+  int i; /* Loop counter for dimensions */
+
+  for (i=0; i<ndims; i++)
+    nbytes *= (unsigned long long) count[i];
+
+  (void) pthread_mutex_lock(&io_stats_lock);
+  io_stats_bytes[kind] += nbytes;
+  (void) pthread_mutex_unlock(&io_stats_lock);
+}
+
+/** Get the number of bytes read from and written to NetCDF files since the start of the process or the last reset. */
+void
+io_stats_get(unsigned long long *nread, unsigned long long *nwritten) {
+  /**
+     @param[out]  nread      Bytes read.
+     @param[out]  nwritten   Bytes written.
+  */
+
+  (void) pthread_mutex_lock(&io_stats_lock);
+  *nread = io_stats_bytes[IO_STATS_READ];
+  *nwritten = io_stats_bytes[IO_STATS_WRITTEN];
+  (void) pthread_mutex_unlock(&io_stats_lock);
+}
+
+/** Reset the counters of bytes read from and written to NetCDF files. */
+void
+io_stats_reset(void) {
+
+  (void) pthread_mutex_lock(&io_stats_lock);
+  io_stats_bytes[IO_STATS_READ] = 0;
+  io_stats_bytes[IO_STATS_WRITTEN] = 0;
+  (void) pthread_mutex_unlock(&io_stats_lock);
+}
@@ -0,0 +1,254 @@
+/* ***************************************************** */
+/* meta_cache Cache of NetCDF file metadata.             */
+/* meta_cache.c                                          */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file meta_cache.c
+    \brief Cache of NetCDF file metadata, keyed by filename.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <io.h>
+
+/* Metadata cache entries, shared by all NetCDF reading functions of the process.
+   The cache is not locked: like the NetCDF library calls it goes with, it must only be used from one thread at a time.
+   Entries returned by meta_cache_find and meta_cache_add are only valid until the next call to the cache. */
+static meta_cache_struct *meta_cache = NULL;
+/* Next entry to replace when the cache is full */
+static int meta_cache_next = 0;
+
+static void meta_cache_clear(meta_cache_struct *entry);
+
+/** Free the content of a metadata cache entry. */
+static void
+meta_cache_clear(meta_cache_struct *entry) {
+  /**
+     @param[in,out]  entry      Cache entry.
+  */
+
+  if (entry->filename != NULL) (void) free(entry->filename);
+  if (entry->key != NULL) (void) free(entry->key);
+  if (entry->val1 != NULL) (void) free(entry->val1);
+  if (entry->val2 != NULL) (void) free(entry->val2);
+  if (entry->time_units != NULL) (void) free(entry->time_units);
+  if (entry->cal_type != NULL) (void) free(entry->cal_type);
+  if (entry->time_s != NULL) {
+    (void) free(entry->time_s->year);
+    (void) free(entry->time_s->month);
+    (void) free(entry->time_s->day);
+    (void) free(entry->time_s->hour);
+    (void) free(entry->time_s->minutes);
+    (void) free(entry->time_s->seconds);
+    (void) free(entry->time_s);
+  }
+  if (entry->info_field != NULL) {
+    (void) free(entry->info_field->coordinates);
+    (void) free(entry->info_field->grid_mapping);
+    (void) free(entry->info_field->units);
+    (void) free(entry->info_field->height);
+    (void) free(entry->info_field->long_name);
+    (void) free(entry->info_field);
+  }
+  if (entry->proj != NULL) {
+    (void) free(entry->proj->name);
+    (void) free(entry->proj->grid_mapping_name);
+    (void) free(entry->proj);
+  }
+  (void) memset(entry, 0, sizeof(meta_cache_struct));
+}
+
+/** Find metadata of a NetCDF file in the cache. Entries of files modified since they were cached are discarded.
+    Not thread-safe: NetCDF files must be read from one thread at a time. */
+meta_cache_struct *
+meta_cache_find(char *filename, char *key) {
+  /**
+     @param[in]  filename   NetCDF filename.
+     @param[in]  key        Metadata request identifier.
+
+     \return           Cache entry, or NULL if not found.
+  */
+
+  struct stat filestat; /* File status */
+  int e; /* Loop counter for entries */
+
+  if (meta_cache == NULL)
+    return NULL;
+
+  if (stat(filename, &filestat) != 0)
+    return NULL;
+
+  for (e=0; e<META_CACHE_MAX; e++)
+    if (meta_cache[e].filename != NULL && !strcmp(meta_cache[e].filename, filename) && !strcmp(meta_cache[e].key, key)) {
+      if (meta_cache[e].mtime == filestat.st_mtime && meta_cache[e].size == filestat.st_size) {
+#if DEBUG >= 7
+        (void) fprintf(stdout, "%s: Using cached metadata %s for file %s.\n", __FILE__, key, filename);
+#endif
+        return &(meta_cache[e]);
+      }
+      /* File has changed */
+      meta_cache_clear(&(meta_cache[e]));
+      return NULL;
+    }
+
+  return NULL;
+}
+
+/** Add a new empty entry in the metadata cache, to be filled by the caller before any other call to the cache.
+    Not thread-safe: NetCDF files must be read from one thread at a time. */
+meta_cache_struct *
+meta_cache_add(char *filename, char *key) {
+  /**
+     @param[in]  filename   NetCDF filename.
+     @param[in]  key        Metadata request identifier.
+
+     \return           Cache entry, or NULL if the file cannot be cached.
+  */
+
+  struct stat filestat; /* File status */
+  meta_cache_struct *entry = NULL; /* Cache entry */
+  int e; /* Loop counter for entries */
+
+  if (stat(filename, &filestat) != 0)
+    return NULL;
+
+  if (meta_cache == NULL) {
+    meta_cache = (meta_cache_struct *) calloc(META_CACHE_MAX, sizeof(meta_cache_struct));
+    if (meta_cache == NULL) alloc_error(__FILE__, __LINE__);
+  }
+
+  /* Reuse the entry of the same request, or a free one, else replace the oldest */
+  for (e=0; e<META_CACHE_MAX && entry == NULL; e++)
+    if (meta_cache[e].filename != NULL && !strcmp(meta_cache[e].filename, filename) && !strcmp(meta_cache[e].key, key))
+      entry = &(meta_cache[e]);
+  for (e=0; e<META_CACHE_MAX && entry == NULL; e++)
+    if (meta_cache[e].filename == NULL)
+      entry = &(meta_cache[e]);
+  if (entry == NULL) {
+    entry = &(meta_cache[meta_cache_next]);
+    meta_cache_next = (meta_cache_next + 1) % META_CACHE_MAX;
+  }
+
+  meta_cache_clear(entry);
+  entry->filename = strdup(filename);
+  entry->key = strdup(key);
+  entry->mtime = filestat.st_mtime;
+  entry->size = filestat.st_size;
+
+  return entry;
+}
+
+/** Duplicate a double buffer. */
+double *
+meta_cache_dup(double *buf, int n) {
+  /**
+     @param[in]  buf        Input buffer.
+     @param[in]  n          Number of elements.
+
+     \return           Newly allocated copy.
+  */
+
+  double *bufout = NULL; /* Output buffer */
+
+  bufout = (double *) malloc(n * sizeof(double));
+  if (bufout == NULL) alloc_error(__FILE__, __LINE__);
+  (void) memcpy(bufout, buf, n * sizeof(double));
+
+  return bufout;
+}
+
+/** Copy a time structure, allocating output vectors. */
+void
+meta_cache_copy_time(time_vect_struct *time_out, time_vect_struct *time_in, int ntime) {
+  /**
+     @param[out]  time_out   Output time structure.
+     @param[in]   time_in    Input time structure.
+     @param[in]   ntime      Time dimension.
+  */
+
+  time_out->year = (int *) malloc(ntime * sizeof(int));
+  if (time_out->year == NULL) alloc_error(__FILE__, __LINE__);
+  time_out->month = (int *) malloc(ntime * sizeof(int));
+  if (time_out->month == NULL) alloc_error(__FILE__, __LINE__);
+  time_out->day = (int *) malloc(ntime * sizeof(int));
+  if (time_out->day == NULL) alloc_error(__FILE__, __LINE__);
+  time_out->hour = (int *) malloc(ntime * sizeof(int));
+  if (time_out->hour == NULL) alloc_error(__FILE__, __LINE__);
+  time_out->minutes = (int *) malloc(ntime * sizeof(int));
+  if (time_out->minutes == NULL) alloc_error(__FILE__, __LINE__);
+  time_out->seconds = (double *) malloc(ntime * sizeof(double));
+  if (time_out->seconds == NULL) alloc_error(__FILE__, __LINE__);
+
+  (void) memcpy(time_out->year, time_in->year, ntime * sizeof(int));
+  (void) memcpy(time_out->month, time_in->month, ntime * sizeof(int));
+  (void) memcpy(time_out->day, time_in->day, ntime * sizeof(int));
+  (void) memcpy(time_out->hour, time_in->hour, ntime * sizeof(int));
+  (void) memcpy(time_out->minutes, time_in->minutes, ntime * sizeof(int));
+  (void) memcpy(time_out->seconds, time_in->seconds, ntime * sizeof(double));
+}
+
+/** Free all metadata cache entries. */
+void
+meta_cache_free(void) {
+
+  int e; /* Loop counter for entries */
+
+  if (meta_cache == NULL)
+    return;
+
+  for (e=0; e<META_CACHE_MAX; e++)
+    meta_cache_clear(&(meta_cache[e]));
+  (void) free(meta_cache);
+  meta_cache = NULL;
+  meta_cache_next = 0;
+}
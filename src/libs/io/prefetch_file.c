@@ -0,0 +1,99 @@
+/* ***************************************************** */
+/* prefetch_file Ask the kernel to read ahead            */
+/* a whole input file.                                   */
+/* prefetch_file.c                                       */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file prefetch_file.c
+    \brief Ask the kernel to read ahead a whole input file.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <io.h>
+
+/** Ask the kernel to read ahead a whole input file, without blocking. */
+int
+prefetch_file(char *filename)
+{
+  /**
+     @param[in]  filename   Input filename.
+
+     \return           Status: 0 if read-ahead was requested, -1 otherwise.
+  */
+
+#if defined(HAVE_FCNTL_H) && defined(HAVE_UNISTD_H) && defined(POSIX_FADV_WILLNEED)
+  int fd; /* File descriptor */
+  int istat; /* Diagnostic status */
+
+  /* The hint is only advisory: a missing file is silently ignored, it will be reported when really opened */
+  fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    return -1;
+
+  /* Pages are read asynchronously into the page cache and stay there after closing the descriptor */
+  istat = posix_fadvise(fd, (off_t) 0, (off_t) 0, POSIX_FADV_WILLNEED);
+  (void) close(fd);
+
+#if DEBUG >= 7
+  (void) fprintf(stdout, "%s: Prefetching file %s.\n", __FILE__, filename);
+#endif
+
+  if (istat != 0)
+    return -1;
+
+  return 0;
+#else
+  return -1;
+#endif
+}
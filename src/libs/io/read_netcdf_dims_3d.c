@@ -114,6 +114,42 @@ read_netcdf_dims_3d(double **lon, double **lat, double **timeval, char **cal_typ
   int t; /* Time loop counter */
   int ndims; /* Number of dimensions of latitude and longitude variables, 1 or 2 for 1D and 2D respectively */
 
+  meta_cache_struct *cache = NULL; /* Metadata cache entry */
+  meta_cache_struct *cache_time = NULL; /* Metadata cache entry of time dimension */
+  char *key = NULL; /* Metadata cache request identifier */
+  char *key_time = NULL; /* Metadata cache request identifier of time dimension */
+
+  /* Serve request from metadata cache if dimensions of this file were already read
+     and global attributes are not needed, so that the file is not opened again */
+  key = (char *) malloc((strlen(coords)+strlen(gridname)+strlen(lonname)+strlen(latname)+
+                         strlen(dimxname)+strlen(dimyname)+13) * sizeof(char));
+  if (key == NULL) alloc_error(__FILE__, __LINE__);
+  (void) sprintf(key, "dims3d %s %s %s %s %s %s", coords, gridname, lonname, latname, dimxname, dimyname);
+  key_time = (char *) malloc((strlen(timename)+13) * sizeof(char));
+  if (key_time == NULL) alloc_error(__FILE__, __LINE__);
+  (void) sprintf(key_time, "dims3d_time %s", timename);
+  if (info->title != NULL) {
+    cache = meta_cache_find(filename, key);
+    cache_time = meta_cache_find(filename, key_time);
+    if (cache != NULL && cache_time != NULL) {
+      *nlon = cache->n1;
+      *nlat = cache->n2;
+      (*lon) = meta_cache_dup(cache->val1, (*nlon) * (*nlat));
+      (*lat) = meta_cache_dup(cache->val2, (*nlon) * (*nlat));
+      *ntime = cache_time->n1;
+      (*timeval) = meta_cache_dup(cache_time->val1, *ntime);
+      (*time_units) = strdup(cache_time->time_units);
+      (*cal_type) = strdup(cache_time->cal_type);
+      fixtime = cache_time->n2;
+      (void) free(key);
+      (void) free(key_time);
+      if (fixtime == FALSE)
+        return 0;
+      else
+        return 1;
+    }
+  }
+
   /* Read data in NetCDF file */
 
   /* Open NetCDF file for reading */
@@ -196,6 +232,8 @@ read_netcdf_dims_3d(double **lon, double **lat, double **timeval, char **cal_typ
     (void) fprintf(stderr, "Error NetCDF type and/or dimensions %d != 1.\n", varndims);
     istat = ncclose(ncinid);
     if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+    (void) free(key);
+    (void) free(key_time);
     return -1;
   }
 
@@ -209,6 +247,8 @@ read_netcdf_dims_3d(double **lon, double **lat, double **timeval, char **cal_typ
     (void) fprintf(stderr, "Error NetCDF type and/or dimensions %d != %d.\n", varndims, ndims);
     istat = ncclose(ncinid);
     if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+    (void) free(key);
+    (void) free(key_time);
     return -1;
   }
 
@@ -222,6 +262,8 @@ read_netcdf_dims_3d(double **lon, double **lat, double **timeval, char **cal_typ
     (void) fprintf(stderr, "Error NetCDF type and/or dimensions %d != %d.\n", varndims, ndims);
     istat = ncclose(ncinid);
     if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+    (void) free(key);
+    (void) free(key_time);
     return -1;
   }
 
@@ -359,6 +401,25 @@ read_netcdf_dims_3d(double **lon, double **lat, double **timeval, char **cal_typ
   istat = ncclose(ncinid);
   if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
 
+  /* Keep dimensions in metadata cache */
+  cache = meta_cache_add(filename, key);
+  if (cache != NULL) {
+    cache->n1 = *nlon;
+    cache->n2 = *nlat;
+    cache->val1 = meta_cache_dup(*lon, (*nlon) * (*nlat));
+    cache->val2 = meta_cache_dup(*lat, (*nlon) * (*nlat));
+  }
+  cache_time = meta_cache_add(filename, key_time);
+  if (cache_time != NULL) {
+    cache_time->n1 = *ntime;
+    cache_time->n2 = fixtime;
+    cache_time->val1 = meta_cache_dup(*timeval, *ntime);
+    cache_time->time_units = strdup(*time_units);
+    cache_time->cal_type = strdup(*cal_type);
+  }
+  (void) free(key);
+  (void) free(key_time);
+
   if (fixtime == FALSE)
     /* Success status */
     return 0;
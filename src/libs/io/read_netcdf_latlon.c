@@ -106,6 +106,26 @@ read_netcdf_latlon(double **lon, double **lat, int *nlon, int *nlat, char *dimco
   int ndims_xy; /* Number of dimensions of X and Y dimensions, 1 or 2 for 1D and 2D respectively */
   int npts; /* Number of points for list of latitude + longitude points */
 
+  meta_cache_struct *cache = NULL; /* Metadata cache entry */
+  char *key = NULL; /* Metadata cache request identifier */
+
+  /* Serve request from metadata cache if coordinates of this file were already read */
+  key = (char *) malloc((strlen(dimcoords)+strlen(coords)+strlen(gridname)+strlen(lonname)+strlen(latname)+
+                         strlen(dimxname)+strlen(dimyname)+14) * sizeof(char));
+  if (key == NULL) alloc_error(__FILE__, __LINE__);
+  (void) sprintf(key, "latlon %s %s %s %s %s %s %s", dimcoords, coords, gridname, lonname, latname, dimxname, dimyname);
+  cache = meta_cache_find(filename, key);
+  if (cache != NULL) {
+    *nlon = cache->n1;
+    *nlat = cache->n2;
+    /* List of points has nlat set to zero */
+    npts = ( (*nlat) == 0 ) ? (*nlon) : ((*nlon) * (*nlat));
+    (*lon) = meta_cache_dup(cache->val1, npts);
+    (*lat) = meta_cache_dup(cache->val2, npts);
+    (void) free(key);
+    return 0;
+  }
+
   /* Read data in NetCDF file */
 
   /* Open NetCDF file for reading */
@@ -185,6 +205,7 @@ read_netcdf_latlon(double **lon, double **lat, int *nlon, int *nlat, char *dimco
     (void) fprintf(stderr, "Error NetCDF type and/or dimensions %d != %d.\n", varndims, ndims);
     istat = ncclose(ncinid);
     if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+    (void) free(key);
     return -1;
   }
 
@@ -198,6 +219,7 @@ read_netcdf_latlon(double **lon, double **lat, int *nlon, int *nlat, char *dimco
     (void) fprintf(stderr, "Error NetCDF type and/or dimensions %d != %d.\n", varndims, ndims);
     istat = ncclose(ncinid);
     if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+    (void) free(key);
     return -1;
   }
 
@@ -309,6 +331,17 @@ read_netcdf_latlon(double **lon, double **lat, int *nlon, int *nlat, char *dimco
   istat = ncclose(ncinid);
   if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
 
+  /* Keep coordinates in metadata cache */
+  cache = meta_cache_add(filename, key);
+  if (cache != NULL) {
+    npts = ( (*nlat) == 0 ) ? (*nlon) : ((*nlon) * (*nlat));
+    cache->n1 = *nlon;
+    cache->n2 = *nlat;
+    cache->val1 = meta_cache_dup(*lon, npts);
+    cache->val2 = meta_cache_dup(*lat, npts);
+  }
+  (void) free(key);
+
   /* Success status */
   return 0;
 }
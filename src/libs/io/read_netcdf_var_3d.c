@@ -427,6 +427,7 @@ read_netcdf_var_3d(double **buf, info_field_struct *info_field, proj_struct *pro
   /* Read values from netCDF variable */
   istat = nc_get_vara_double(ncinid, varinid, start, count, *buf);
   if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  (void) io_stats_add(IO_STATS_READ, count, varndims, sizeof(double));
 
   /* Close the input netCDF file. */
   istat = ncclose(ncinid);
@@ -112,9 +112,14 @@ read_netcdf_var_3d_2d(double **buf, info_field_struct *info_field, proj_struct *
   int npts = 0; /* Number of points for 1D variables */
   char *grid_mapping = NULL;
 
+  meta_cache_struct *cache = NULL; /* Metadata cache entry */
+  char *key = NULL; /* Metadata cache request identifier */
+
   /* Allocate memory */
   tmpstr = (char *) malloc(MAXPATH * sizeof(char));
   if (tmpstr == NULL) alloc_error(__FILE__, __LINE__);
+  key = (char *) malloc(MAXPATH * sizeof(char));
+  if (key == NULL) alloc_error(__FILE__, __LINE__);
 
   /* Read data in NetCDF file */
 
@@ -133,6 +138,7 @@ read_netcdf_var_3d_2d(double **buf, info_field_struct *info_field, proj_struct *
   /* Verify timestep provided */
   if (t < 0 || t > ((*ntime)-1)) {
     (void) free(tmpstr);
+    (void) free(key);
     istat = ncclose(ncinid);
     (void) fprintf(stderr, "%s: Invalid timestep provided: %d. Maximum value is %d\n", __FILE__, t, *ntime);
     return -1;
@@ -170,6 +176,7 @@ read_netcdf_var_3d_2d(double **buf, info_field_struct *info_field, proj_struct *
   if (varndims != 3 && varndims != 2) {
     (void) fprintf(stderr, "%s: Error NetCDF type and/or dimensions nlon %d nlat %d.\n", __FILE__, *nlon, *nlat);
     (void) free(tmpstr);
+    (void) free(key);
     istat = ncclose(ncinid);
     if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
     return -1;
@@ -187,8 +194,20 @@ read_netcdf_var_3d_2d(double **buf, info_field_struct *info_field, proj_struct *
     *nlat = 0;
   }
 
-  /* If info_field si not NULL, get some information about the read variable */
+  /* If info_field si not NULL, get some information about the read variable, from metadata cache if already read */
   if (info_field != NULL) {
+    (void) sprintf(key, "field %s", varname);
+    cache = meta_cache_find(filename, key);
+  }
+  if (info_field != NULL && cache != NULL) {
+    info_field->fillvalue = cache->info_field->fillvalue;
+    info_field->coordinates = strdup(cache->info_field->coordinates);
+    info_field->grid_mapping = strdup(cache->info_field->grid_mapping);
+    info_field->units = strdup(cache->info_field->units);
+    info_field->height = strdup(cache->info_field->height);
+    info_field->long_name = strdup(cache->info_field->long_name);
+  }
+  else if (info_field != NULL) {
     /* Get missing value */
     if (vartype_main == NC_FLOAT) {
       istat = nc_get_att_float(ncinid, varinid, "missing_value", &valf);
@@ -290,10 +309,45 @@ read_netcdf_var_3d_2d(double **buf, info_field_struct *info_field, proj_struct *
     }
     else
       info_field->long_name = strdup(varname);
+
+    /* Keep variable information in metadata cache */
+    cache = meta_cache_add(filename, key);
+    if (cache != NULL) {
+      cache->info_field = (info_field_struct *) malloc(sizeof(info_field_struct));
+      if (cache->info_field == NULL) alloc_error(__FILE__, __LINE__);
+      cache->info_field->fillvalue = info_field->fillvalue;
+      cache->info_field->coordinates = strdup(info_field->coordinates);
+      cache->info_field->grid_mapping = strdup(info_field->grid_mapping);
+      cache->info_field->units = strdup(info_field->units);
+      cache->info_field->height = strdup(info_field->height);
+      cache->info_field->long_name = strdup(info_field->long_name);
+    }
   }
 
-  /* if proj is not NULL, retrieve informations about the horizontal projection parameters */
+  /* if proj is not NULL, retrieve informations about the horizontal projection parameters, from metadata cache if already read */
   if (proj != NULL) {
+    /* Projection parameters depend on the grid mapping and on the projection name provided on input */
+    (void) sprintf(key, "proj %s %s %s", varname, (info_field == NULL) ? "unknown" : info_field->grid_mapping,
+                   (proj->name == NULL) ? "(null)" : proj->name);
+    cache = meta_cache_find(filename, key);
+  }
+  if (proj != NULL && cache != NULL) {
+    if (proj->name != NULL)
+      (void) free(proj->name);
+    if (proj->grid_mapping_name != NULL)
+      (void) free(proj->grid_mapping_name);
+    proj->name = (cache->proj->name == NULL) ? NULL : strdup(cache->proj->name);
+    proj->grid_mapping_name = (cache->proj->grid_mapping_name == NULL) ? NULL : strdup(cache->proj->grid_mapping_name);
+    proj->latin1 = cache->proj->latin1;
+    proj->latin2 = cache->proj->latin2;
+    proj->lonc = cache->proj->lonc;
+    proj->lat0 = cache->proj->lat0;
+    proj->false_easting = cache->proj->false_easting;
+    proj->false_northing = cache->proj->false_northing;
+    proj->latpole = cache->proj->latpole;
+    proj->lonpole = cache->proj->lonpole;
+  }
+  else if (proj != NULL) {
     if (info_field == NULL)
       grid_mapping = strdup("unknown");
     else
@@ -400,6 +454,18 @@ read_netcdf_var_3d_2d(double **buf, info_field_struct *info_field, proj_struct *
       proj->false_northing = 0.0;
     }
     (void) free(grid_mapping);
+
+    /* Keep projection parameters in metadata cache */
+    cache = meta_cache_add(filename, key);
+    if (cache != NULL) {
+      cache->proj = (proj_struct *) malloc(sizeof(proj_struct));
+      if (cache->proj == NULL) alloc_error(__FILE__, __LINE__);
+      (void) memcpy(cache->proj, proj, sizeof(proj_struct));
+      cache->proj->coords = NULL;
+      cache->proj->eof_coords = NULL;
+      cache->proj->name = (proj->name == NULL) ? NULL : strdup(proj->name);
+      cache->proj->grid_mapping_name = (proj->grid_mapping_name == NULL) ? NULL : strdup(proj->grid_mapping_name);
+    }
   }
 
   if (varndims == 3) {
@@ -430,6 +496,7 @@ read_netcdf_var_3d_2d(double **buf, info_field_struct *info_field, proj_struct *
   /* Read values from netCDF variable */
   istat = nc_get_vara_double(ncinid, varinid, start, count, *buf);
   if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  (void) io_stats_add(IO_STATS_READ, count, varndims, sizeof(double));
 
   /* Close the input netCDF file. */
   istat = ncclose(ncinid);
@@ -437,6 +504,7 @@ read_netcdf_var_3d_2d(double **buf, info_field_struct *info_field, proj_struct *
 
   /* Free memory */
   (void) free(tmpstr);
+  (void) free(key);
 
   /* Success status */
   return 0;
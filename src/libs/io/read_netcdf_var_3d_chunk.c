@@ -0,0 +1,181 @@
+/* ***************************************************** */
+/* read_netcdf_var_3d_chunk Read a block of              */
+/* consecutive timesteps of a 3D NetCDF                  */
+/* variable.                                             */
+/* read_netcdf_var_3d_chunk.c                            */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file read_netcdf_var_3d_chunk.c
+    \brief Read a block of consecutive timesteps of a 3D NetCDF variable.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <io.h>
+
+/** Read a block of consecutive timesteps of a 3D variable in a NetCDF file. Variable attributes are not read:
+    use read_netcdf_var_3d_2d once to retrieve them. */
+int
+read_netcdf_var_3d_chunk(double **buf, char *filename, char *varname, char *dimxname, char *dimyname, char *timename,
+                         int tstart, int tcount, int *nlon, int *nlat, int *ntime, int outinfo) {
+  /**
+     @param[out]  buf        3D variable block (nlon x nlat x tcount)
+     @param[in]   filename   NetCDF input filename
+     @param[in]   varname    NetCDF variable name
+     @param[in]   dimxname   Longitude dimension name
+     @param[in]   dimyname   Latitude dimension name
+     @param[in]   timename   Time dimension name
+     @param[in]   tstart     First time index to retrieve
+     @param[in]   tcount     Number of timesteps to retrieve
+     @param[out]  nlon       Longitude dimension length
+     @param[out]  nlat       Latitude dimension length
+     @param[out]  ntime      Time dimension length of the whole variable
+     @param[in]   outinfo    TRUE if we want information output, FALSE if not
+     
+     \return           Status.
+  */
+
+  int istat; /* Diagnostic status */
+
+  size_t dimval; /* Variable used to retrieve dimension length */
+
+  int ncinid; /* NetCDF input file handle ID */
+  int varinid; /* NetCDF variable ID */
+  nc_type vartype_main; /* Type of the variable (NC_FLOAT, NC_DOUBLE, etc.) */
+  int varndims; /* Number of dimensions of variable */
+  int vardimids[NC_MAX_VAR_DIMS]; /* Variable dimension ids */
+  int timediminid; /* Time dimension ID */
+  int londiminid; /* Longitude dimension ID */
+  int latdiminid; /* Latitude dimension ID */
+
+  size_t start[3]; /* Start position to read */
+  size_t count[3]; /* Number of elements to read */
+
+  /* Open NetCDF file for reading */
+  istat = nc_open(filename, NC_NOWRITE, &ncinid);  /* open for reading */
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+
+  /* Get dimensions length */
+  istat = nc_inq_dimid(ncinid, timename, &timediminid);  /* get ID for time dimension */
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  istat = nc_inq_dimlen(ncinid, timediminid, &dimval); /* get time length */
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  *ntime = (int) dimval;
+  /* Verify timesteps provided */
+  if (tstart < 0 || tcount < 1 || (tstart+tcount) > (*ntime)) {
+    istat = ncclose(ncinid);
+    (void) fprintf(stderr, "%s: Invalid timesteps provided: %d to %d. Maximum value is %d\n", __FILE__, tstart, tstart+tcount-1,
+                   (*ntime)-1);
+    return -1;
+  }
+
+  istat = nc_inq_dimid(ncinid, dimyname, &latdiminid);  /* get ID for lat dimension */
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  istat = nc_inq_dimlen(ncinid, latdiminid, &dimval); /* get lat length */
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  *nlat = (int) dimval;
+
+  istat = nc_inq_dimid(ncinid, dimxname, &londiminid);  /* get ID for lon dimension */
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  istat = nc_inq_dimlen(ncinid, londiminid, &dimval); /* get lon length */
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  *nlon = (int) dimval;
+
+  /* Get main variable ID */
+  istat = nc_inq_varid(ncinid, varname, &varinid);
+  if (istat != NC_NOERR) {
+    (void) fprintf(stderr, "%s: Error with variable %s in file %s\n", __FILE__, varname, filename);
+    handle_netcdf_error(istat, __FILE__, __LINE__);
+  }
+
+  /* Get variable information */
+  istat = nc_inq_var(ncinid, varinid, (char *) NULL, &vartype_main, &varndims, vardimids, (int *) NULL);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+
+  /* Set start and count: variable is either 3D or 2D (list of points) */
+  start[0] = (size_t) tstart;
+  start[1] = 0;
+  start[2] = 0;
+  count[0] = (size_t) tcount;
+  if (varndims == 3) {
+    count[1] = (size_t) (*nlat);
+    count[2] = (size_t) (*nlon);
+  }
+  else if (varndims == 2 && (*nlat) == (*nlon)) {
+    count[1] = (size_t) (*nlon);
+    count[2] = 0;
+    *nlat = 1;
+  }
+  else {
+    (void) fprintf(stderr, "%s: Error NetCDF type and/or dimensions nlon %d nlat %d.\n", __FILE__, *nlon, *nlat);
+    istat = ncclose(ncinid);
+    if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+    return -1;
+  }
+
+  /* Allocate memory and read values from netCDF variable */
+  (*buf) = (double *) malloc((*nlon) * (*nlat) * tcount * sizeof(double));
+  if ((*buf) == NULL) alloc_error(__FILE__, __LINE__);
+  if (outinfo == TRUE)
+    printf("%s: READ %s %s time=%d-%d %d.\n", __FILE__, varname, filename, tstart, tstart+tcount-1, *ntime);
+  istat = nc_get_vara_double(ncinid, varinid, start, count, *buf);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  (void) io_stats_add(IO_STATS_READ, count, varndims, sizeof(double));
+
+  /* Close the input netCDF file. */
+  istat = ncclose(ncinid);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+
+  /* Success status */
+  return 0;
+}
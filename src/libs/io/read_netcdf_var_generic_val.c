@@ -187,6 +187,7 @@ read_netcdf_var_generic_val(double *buf, info_field_struct *info_field, char *fi
   /* Read values from netCDF variable */
   istat = nc_get_var1_double(ncinid, varinid, idx, buf);
   if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  (void) io_stats_add(IO_STATS_READ, NULL, 0, sizeof(double));
 
   /* Close the input netCDF file. */
   istat = ncclose(ncinid);
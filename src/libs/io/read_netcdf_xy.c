@@ -98,6 +98,26 @@ read_netcdf_xy(double **x, double **y, int *nx, int *ny, char *xname, char *ynam
 
   static short int error_report = 0;
 
+  meta_cache_struct *cache = NULL; /* Metadata cache entry */
+  char *key = NULL; /* Metadata cache request identifier */
+
+  /* Serve request from metadata cache if coordinates of this file were already read */
+  key = (char *) malloc((strlen(xname)+strlen(yname)+strlen(dimxname)+strlen(dimyname)+8) * sizeof(char));
+  if (key == NULL) alloc_error(__FILE__, __LINE__);
+  (void) sprintf(key, "xy %s %s %s %s", xname, yname, dimxname, dimyname);
+  cache = meta_cache_find(filename, key);
+  if (cache != NULL) {
+    (void) free(key);
+    /* Files without X and Y coordinate variables are remembered too */
+    if (cache->val1 == NULL)
+      return -1;
+    *nx = cache->n1;
+    *ny = cache->n2;
+    (*x) = meta_cache_dup(cache->val1, *nx);
+    (*y) = meta_cache_dup(cache->val2, *ny);
+    return 0;
+  }
+
   /* Read data in NetCDF file */
 
   /* Open NetCDF file for reading */
@@ -134,6 +154,8 @@ read_netcdf_xy(double **x, double **y, int *nx, int *ny, char *xname, char *ynam
     }
     istat = ncclose(ncinid);
     if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+    (void) meta_cache_add(filename, key);
+    (void) free(key);
     return -1;
   }
 
@@ -150,6 +172,8 @@ read_netcdf_xy(double **x, double **y, int *nx, int *ny, char *xname, char *ynam
     }
     istat = ncclose(ncinid);
     if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+    (void) meta_cache_add(filename, key);
+    (void) free(key);
     return -1;
   }
 
@@ -185,6 +209,16 @@ read_netcdf_xy(double **x, double **y, int *nx, int *ny, char *xname, char *ynam
   istat = ncclose(ncinid);
   if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
 
+  /* Keep coordinates in metadata cache */
+  cache = meta_cache_add(filename, key);
+  if (cache != NULL) {
+    cache->n1 = *nx;
+    cache->n2 = *ny;
+    cache->val1 = meta_cache_dup(*x, *nx);
+    cache->val2 = meta_cache_dup(*y, *ny);
+  }
+  (void) free(key);
+
   /* Success status */
   return 0;
 }
@@ -0,0 +1,226 @@
+/* ***************************************************** */
+/* write_netcdf_eof Write EOF and singular               */
+/* values in a NetCDF file.                              */
+/* write_netcdf_eof.c                                    */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file write_netcdf_eof.c
+    \brief Write EOF and singular values in a NetCDF file.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <io.h>
+
+/** Write EOF and singular values in a NetCDF output file, in the format read back by read_netcdf_dims_eof and read_netcdf_var_3d. */
+int
+write_netcdf_eof(double *eof, double *sing, double fillvalue, double *lon, double *lat, char *filename,
+                 char *eofvarname, char *singvarname, char *coords, char *lonname, char *latname,
+                 char *dimxname, char *dimyname, char *eofname, int nlon, int nlat, int neof) {
+  /**
+     @param[in]  eof               EOF 3D field (nlon x nlat x neof)
+     @param[in]  sing              Singular values (neof)
+     @param[in]  fillvalue         Missing value
+     @param[in]  lon               Longitude 2D field
+     @param[in]  lat               Latitude 2D field
+     @param[in]  filename          Output NetCDF filename (already created with create_netcdf)
+     @param[in]  eofvarname        EOF variable name in the NetCDF file
+     @param[in]  singvarname       Singular values variable name in the NetCDF file
+     @param[in]  coords            Coordinates arrangement of latitude and longitude data: either 1D or 2D
+     @param[in]  lonname           Longitude variable name in the NetCDF file
+     @param[in]  latname           Latitude variable name in the NetCDF file
+     @param[in]  dimxname          X dimension name in the NetCDF file
+     @param[in]  dimyname          Y dimension name in the NetCDF file
+     @param[in]  eofname           EOF dimension name in the NetCDF file
+     @param[in]  nlon              Longitude dimension
+     @param[in]  nlat              Latitude dimension
+     @param[in]  neof              EOF dimension
+     
+     \return                       Status.
+  */
+
+  int istat; /* Diagnostic status */
+
+  int ncoutid; /* NetCDF output file handle ID */
+  int eofdimoutid; /* NetCDF EOF dimension output ID */
+  int xdimoutid; /* NetCDF X dimension output ID */
+  int ydimoutid; /* NetCDF Y dimension output ID */
+  int lonoutid; /* NetCDF longitude variable output ID */
+  int latoutid; /* NetCDF latitude variable output ID */
+  int eofoutid; /* NetCDF EOF variable output ID */
+  int singoutid; /* NetCDF singular values variable output ID */
+  int vardimids[NC_MAX_VAR_DIMS]; /* NetCDF dimension IDs */
+
+  size_t start[3]; /* Start element when writing */
+  size_t count[3]; /* Count of elements to write */
+
+  double *tmpd = NULL; /* Temporary buffer for 1D coordinates */
+  char *tmpstr = NULL; /* Temporary string */
+
+  int i; /* Loop counter */
+  int j; /* Loop counter */
+
+  /** Open already existing output file **/
+  istat = nc_open(filename, NC_WRITE, &ncoutid);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+
+  /* Go into NetCDF define mode */
+  istat = nc_redef(ncoutid);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+
+  /* Set dimensions */
+  istat = nc_def_dim(ncoutid, eofname, neof, &eofdimoutid);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  istat = nc_def_dim(ncoutid, dimxname, nlon, &xdimoutid);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  istat = nc_def_dim(ncoutid, dimyname, nlat, &ydimoutid);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+
+  /* Define dimensions variables */
+  if ( !strcmp(coords, "1D") ) {
+    vardimids[0] = xdimoutid;
+    istat = nc_def_var(ncoutid, lonname, NC_DOUBLE, 1, vardimids, &lonoutid);
+    if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+    vardimids[0] = ydimoutid;
+    istat = nc_def_var(ncoutid, latname, NC_DOUBLE, 1, vardimids, &latoutid);
+    if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  }
+  else {
+    vardimids[0] = ydimoutid;
+    vardimids[1] = xdimoutid;
+    istat = nc_def_var(ncoutid, lonname, NC_DOUBLE, 2, vardimids, &lonoutid);
+    if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+    istat = nc_def_var(ncoutid, latname, NC_DOUBLE, 2, vardimids, &latoutid);
+    if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  }
+  tmpstr = "degrees_east";
+  istat = nc_put_att_text(ncoutid, lonoutid, "units", strlen(tmpstr), tmpstr);
+  tmpstr = "longitude";
+  istat = nc_put_att_text(ncoutid, lonoutid, "standard_name", strlen(tmpstr), tmpstr);
+  tmpstr = "degrees_north";
+  istat = nc_put_att_text(ncoutid, latoutid, "units", strlen(tmpstr), tmpstr);
+  tmpstr = "latitude";
+  istat = nc_put_att_text(ncoutid, latoutid, "standard_name", strlen(tmpstr), tmpstr);
+
+  /* Define EOF and singular values variables */
+  vardimids[0] = eofdimoutid;
+  vardimids[1] = ydimoutid;
+  vardimids[2] = xdimoutid;
+  istat = nc_def_var(ncoutid, eofvarname, NC_DOUBLE, 3, vardimids, &eofoutid);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  istat = nc_put_att_double(ncoutid, eofoutid, "_FillValue", NC_DOUBLE, 1, &fillvalue);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  istat = nc_put_att_double(ncoutid, eofoutid, "missing_value", NC_DOUBLE, 1, &fillvalue);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  tmpstr = "Empirical Orthogonal Functions";
+  istat = nc_put_att_text(ncoutid, eofoutid, "long_name", strlen(tmpstr), tmpstr);
+  tmpstr = "1";
+  istat = nc_put_att_text(ncoutid, eofoutid, "units", strlen(tmpstr), tmpstr);
+
+  vardimids[0] = eofdimoutid;
+  istat = nc_def_var(ncoutid, singvarname, NC_DOUBLE, 1, vardimids, &singoutid);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  tmpstr = "Singular values";
+  istat = nc_put_att_text(ncoutid, singoutid, "long_name", strlen(tmpstr), tmpstr);
+
+  /* End definition mode */
+  istat = nc_enddef(ncoutid);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+
+  /* Write coordinates */
+  start[0] = 0;
+  start[1] = 0;
+  start[2] = 0;
+  if ( !strcmp(coords, "1D") ) {
+    tmpd = (double *) malloc(((nlon > nlat) ? nlon : nlat) * sizeof(double));
+    if (tmpd == NULL) alloc_error(__FILE__, __LINE__);
+    for (i=0; i<nlon; i++)
+      tmpd[i] = lon[i];
+    count[0] = (size_t) nlon;
+    istat = nc_put_vara_double(ncoutid, lonoutid, start, count, tmpd);
+    if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+    for (j=0; j<nlat; j++)
+      tmpd[j] = lat[j*nlon];
+    count[0] = (size_t) nlat;
+    istat = nc_put_vara_double(ncoutid, latoutid, start, count, tmpd);
+    if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+    (void) free(tmpd);
+  }
+  else {
+    count[0] = (size_t) nlat;
+    count[1] = (size_t) nlon;
+    istat = nc_put_vara_double(ncoutid, lonoutid, start, count, lon);
+    if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+    istat = nc_put_vara_double(ncoutid, latoutid, start, count, lat);
+    if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  }
+
+  /* Write EOF and singular values */
+  (void) fprintf(stdout, "%s: WRITE %s %s %s\n", __FILE__, eofvarname, singvarname, filename);
+  count[0] = (size_t) neof;
+  count[1] = (size_t) nlat;
+  count[2] = (size_t) nlon;
+  istat = nc_put_vara_double(ncoutid, eofoutid, start, count, eof);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  istat = nc_put_vara_double(ncoutid, singoutid, start, count, sing);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  (void) io_stats_add(IO_STATS_WRITTEN, count, 3, sizeof(double));
+  (void) io_stats_add(IO_STATS_WRITTEN, count, 1, sizeof(double));
+
+  /* Close the output netCDF file. */
+  istat = ncclose(ncoutid);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+
+  /* Diagnostic status */
+  return 0;
+}
@@ -277,6 +277,7 @@ write_netcdf_var_3d_2d(double *buf, double *timein, double fillvalue, char *file
     printf("%s: WRITE %s %s\n", __FILE__, varname, filename);
   istat = nc_put_vara_double(ncoutid, varoutid, start, count, buf);
   if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  (void) io_stats_add(IO_STATS_WRITTEN, count, ( !strcmp(gridname, "list") ) ? 2 : 3, sizeof(double));
 
   /* Close the output netCDF file. */
   istat = ncclose(ncoutid);
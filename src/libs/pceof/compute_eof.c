@@ -0,0 +1,253 @@
+/* ***************************************************** */
+/* Compute EOF and singular values of a                  */
+/* 2D-time field.                                        */
+/* compute_eof.c                                         */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/*! \file compute_eof.c
+    \brief Compute EOF and singular values of a 2D-time field.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <pceof.h>
+
+/** Subroutine to compute EOFs and singular values of a 2D-time field using a truncated SVD. */
+int
+compute_eof(double *eof, double *sing, double *bufin, double missing_value, int method, int ni, int nj, int ntime, int neof)
+{
+  /**
+     @param[out]     eof               EOF of input field 3D (ni x nj x neof), with a norm equal to the singular value, missing_value on invalid points
+     @param[out]     sing              Singular values (neof), scaled as the standard deviation of the corresponding principal component
+     @param[in]      bufin             Input field 3D (ni x nj x ntime), usually anomalies
+     @param[in]      missing_value     Missing value for bufin
+     @param[in]      method            EOF_SVD for a full SVD (at most EOF_SVD_MAX_DIM valid points or timesteps), EOF_SVD_RANDOM for a randomized truncated SVD
+     @param[in]      ni                Horizontal dimension
+     @param[in]      nj                Horizontal dimension
+     @param[in]      ntime             Temporal dimension
+     @param[in]      neof              EOF dimension
+
+     \return         Status.
+  */
+
+  gsl_matrix *amat = NULL; /* Centered data matrix (npts x ntime) */
+  gsl_matrix *tmat = NULL; /* Transposed data matrix (ntime x npts) */
+  gsl_matrix *vmat = NULL; /* Right singular vectors */
+  gsl_matrix *evec = NULL; /* Matrix whose leading columns are the EOFs on valid points (npts x >= neof) */
+  gsl_matrix *omega = NULL; /* Random test matrix (ntime x nrand) */
+  gsl_matrix *ymat = NULL; /* Range sample of data matrix (npts x nrand) */
+  gsl_matrix *zmat = NULL; /* Range sample of transposed data matrix (ntime x nrand) */
+  gsl_vector *sval = NULL; /* Singular values */
+  gsl_vector *work = NULL; /* Workspace for SVD */
+  gsl_rng *rng = NULL; /* Random number generator */
+
+  int *pts = NULL; /* Grid point index of each valid point */
+  int npts; /* Number of points valid at all times */
+  int nrand; /* Number of random vectors for randomized SVD */
+
+  double mean; /* Time mean at one point */
+  double sum; /* Temporary sum */
+  double sign; /* Sign of EOF */
+  double tot_var = 0.0; /* Total variance of the field */
+
+  int eofi; /* Loop counter */
+  int i; /* Loop counter */
+  int p; /* Loop counter */
+  int t; /* Loop counter */
+  int iter; /* Loop counter */
+
+  /* Select gridpoints which are valid at all times */
+  pts = (int *) malloc(ni*nj * sizeof(int));
+  if (pts == NULL) alloc_error(__FILE__, __LINE__);
+  npts = 0;
+  for (i=0; i<ni*nj; i++) {
+    for (t=0; t<ntime; t++)
+      if (bufin[i+t*ni*nj] == missing_value)
+        break;
+    if (t == ntime)
+      pts[npts++] = i;
+  }
+
+  if (ntime < 2 || neof > npts || neof > ntime) {
+    (void) fprintf(stderr, "%s: FATAL ERROR: Cannot compute %d EOFs with %d valid points and %d timesteps.\n", __FILE__,
+                   neof, npts, ntime);
+    (void) free(pts);
+    return -1;
+  }
+
+  if (method != EOF_SVD_RANDOM && npts > EOF_SVD_MAX_DIM && ntime > EOF_SVD_MAX_DIM) {
+    (void) fprintf(stderr, "%s: FATAL ERROR: Full SVD of %d valid points and %d timesteps needs a %d x %d matrix: above the limit of %d. Use the randomized SVD.\n",
+                   __FILE__, npts, ntime, (npts < ntime) ? npts : ntime, (npts < ntime) ? npts : ntime, EOF_SVD_MAX_DIM);
+    (void) free(pts);
+    return -1;
+  }
+
+  /* Remove time mean at each point */
+  amat = gsl_matrix_alloc((size_t) npts, (size_t) ntime);
+  if (amat == NULL) alloc_error(__FILE__, __LINE__);
+  for (p=0; p<npts; p++) {
+    mean = 0.0;
+    for (t=0; t<ntime; t++)
+      mean += bufin[pts[p]+t*ni*nj];
+    mean = mean / (double) ntime;
+    for (t=0; t<ntime; t++) {
+      amat->data[t+p*amat->tda] = bufin[pts[p]+t*ni*nj] - mean;
+      tot_var += amat->data[t+p*amat->tda] * amat->data[t+p*amat->tda];
+    }
+  }
+  tot_var = tot_var / (double) (ntime-1);
+
+  if (method == EOF_SVD_RANDOM) {
+    /** Randomized truncated SVD (Halko et al., 2011) **/
+    nrand = neof + EOF_RSVD_OVERSAMPLE;
+    if (nrand > npts) nrand = npts;
+    if (nrand > ntime) nrand = ntime;
+
+    omega = gsl_matrix_alloc((size_t) ntime, (size_t) nrand);
+    if (omega == NULL) alloc_error(__FILE__, __LINE__);
+    ymat = gsl_matrix_alloc((size_t) npts, (size_t) nrand);
+    if (ymat == NULL) alloc_error(__FILE__, __LINE__);
+    zmat = gsl_matrix_alloc((size_t) ntime, (size_t) nrand);
+    if (zmat == NULL) alloc_error(__FILE__, __LINE__);
+
+    /* Gaussian test matrix, with a fixed seed for reproducible results */
+    rng = gsl_rng_alloc(gsl_rng_mt19937);
+    if (rng == NULL) alloc_error(__FILE__, __LINE__);
+    gsl_rng_set(rng, EOF_RSVD_SEED);
+    for (t=0; t<ntime*nrand; t++)
+      omega->data[t] = gsl_ran_gaussian(rng, 1.0);
+    gsl_rng_free(rng);
+
+    /* Sample the range of the data matrix, with power iterations to sharpen the spectrum */
+    (void) gsl_blas_dgemm(CblasNoTrans, CblasNoTrans, 1.0, amat, omega, 0.0, ymat);
+    gsl_matrix_free(omega);
+    for (iter=0; iter<EOF_RSVD_POWER_ITER; iter++) {
+      (void) orthonormalize_columns(ymat->data, npts, nrand);
+      (void) gsl_blas_dgemm(CblasTrans, CblasNoTrans, 1.0, amat, ymat, 0.0, zmat);
+      (void) orthonormalize_columns(zmat->data, ntime, nrand);
+      (void) gsl_blas_dgemm(CblasNoTrans, CblasNoTrans, 1.0, amat, zmat, 0.0, ymat);
+    }
+    (void) orthonormalize_columns(ymat->data, npts, nrand);
+
+    /* SVD of the small projected matrix: A^T Q = U S V^T, hence A ~= (Q V) S U^T */
+    (void) gsl_blas_dgemm(CblasTrans, CblasNoTrans, 1.0, amat, ymat, 0.0, zmat);
+    vmat = gsl_matrix_alloc((size_t) nrand, (size_t) nrand);
+    if (vmat == NULL) alloc_error(__FILE__, __LINE__);
+    sval = gsl_vector_alloc((size_t) nrand);
+    if (sval == NULL) alloc_error(__FILE__, __LINE__);
+    work = gsl_vector_alloc((size_t) nrand);
+    if (work == NULL) alloc_error(__FILE__, __LINE__);
+    (void) gsl_linalg_SV_decomp(zmat, vmat, sval, work);
+
+    evec = gsl_matrix_alloc((size_t) npts, (size_t) nrand);
+    if (evec == NULL) alloc_error(__FILE__, __LINE__);
+    (void) gsl_blas_dgemm(CblasNoTrans, CblasNoTrans, 1.0, ymat, vmat, 0.0, evec);
+
+    gsl_matrix_free(ymat);
+    gsl_matrix_free(zmat);
+    gsl_matrix_free(vmat);
+    gsl_matrix_free(amat);
+  }
+  else if (npts >= ntime) {
+    /** Full SVD of the data matrix: EOFs are the left singular vectors **/
+    vmat = gsl_matrix_alloc((size_t) ntime, (size_t) ntime);
+    if (vmat == NULL) alloc_error(__FILE__, __LINE__);
+    sval = gsl_vector_alloc((size_t) ntime);
+    if (sval == NULL) alloc_error(__FILE__, __LINE__);
+    work = gsl_vector_alloc((size_t) ntime);
+    if (work == NULL) alloc_error(__FILE__, __LINE__);
+    (void) gsl_linalg_SV_decomp(amat, vmat, sval, work);
+    gsl_matrix_free(vmat);
+    evec = amat;
+  }
+  else {
+    /** Full SVD of the transposed data matrix: EOFs are the right singular vectors **/
+    tmat = gsl_matrix_alloc((size_t) ntime, (size_t) npts);
+    if (tmat == NULL) alloc_error(__FILE__, __LINE__);
+    for (p=0; p<npts; p++)
+      for (t=0; t<ntime; t++)
+        tmat->data[p+t*tmat->tda] = amat->data[t+p*amat->tda];
+    gsl_matrix_free(amat);
+    vmat = gsl_matrix_alloc((size_t) npts, (size_t) npts);
+    if (vmat == NULL) alloc_error(__FILE__, __LINE__);
+    sval = gsl_vector_alloc((size_t) npts);
+    if (sval == NULL) alloc_error(__FILE__, __LINE__);
+    work = gsl_vector_alloc((size_t) npts);
+    if (work == NULL) alloc_error(__FILE__, __LINE__);
+    (void) gsl_linalg_SV_decomp(tmat, vmat, sval, work);
+    gsl_matrix_free(tmat);
+    evec = vmat;
+  }
+
+  /* Store leading EOFs and singular values */
+  for (i=0; i<ni*nj*neof; i++)
+    eof[i] = missing_value;
+  for (eofi=0; eofi<neof; eofi++) {
+    /* Singular value as the standard deviation of the principal component */
+    sing[eofi] = gsl_vector_get(sval, (size_t) eofi) / sqrt((double) (ntime-1));
+    /* The sign of an EOF is arbitrary: choose it so that the sum of the EOF is positive */
+    sum = 0.0;
+    for (p=0; p<npts; p++)
+      sum += evec->data[eofi+p*evec->tda];
+    if (sum < 0.0)
+      sign = -1.0;
+    else
+      sign = 1.0;
+    /* EOF norm is the singular value, as expected when projecting a field onto EOFs (see pack_eof_proj) */
+    for (p=0; p<npts; p++)
+      eof[pts[p]+eofi*ni*nj] = sign * sing[eofi] * evec->data[eofi+p*evec->tda];
+    (void) fprintf(stdout, "%s: EOF #%d: singular value %lf, %% of variance explained: %lf\n", __FILE__, eofi, sing[eofi],
+                   sing[eofi] * sing[eofi] / tot_var * 100.0);
+  }
+
+  /* Free memory */
+  gsl_matrix_free(evec);
+  gsl_vector_free(sval);
+  gsl_vector_free(work);
+  (void) free(pts);
+
+  /* Success status */
+  return 0;
+}
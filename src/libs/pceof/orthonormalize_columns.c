@@ -0,0 +1,90 @@
+/* ***************************************************** */
+/* Orthonormalize the columns of a 2D matrix             */
+/* orthonormalize_columns.c                              */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/*! \file orthonormalize_columns.c
+    \brief Orthonormalize the columns of a 2D matrix using modified Gram-Schmidt.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <pceof.h>
+
+/** Orthonormalize the columns of a row-major 2D matrix using modified Gram-Schmidt. */
+void
+orthonormalize_columns(double *buf, int nrow, int ncol) {
+  /**
+     @param[in,out]  buf   2D matrix (nrow x ncol), row-major. Columns are replaced by an orthonormal basis of their span.
+     @param[in]      nrow  Number of rows
+     @param[in]      ncol  Number of columns
+  */
+
+  double norm; /* Norm of current column */
+  double proj; /* Projection of current column on a previous one */
+
+  int i; /* Loop counter */
+  int k; /* Loop counter */
+  int kk; /* Loop counter */
+
+  for (k=0; k<ncol; k++) {
+    /* Remove components along previous orthonormal columns */
+    for (kk=0; kk<k; kk++) {
+      proj = 0.0;
+      for (i=0; i<nrow; i++)
+        proj += buf[kk+i*ncol] * buf[k+i*ncol];
+      for (i=0; i<nrow; i++)
+        buf[k+i*ncol] -= proj * buf[kk+i*ncol];
+    }
+    /* Normalize */
+    norm = 0.0;
+    for (i=0; i<nrow; i++)
+      norm += buf[k+i*ncol] * buf[k+i*ncol];
+    norm = sqrt(norm);
+    if (norm > 0.0)
+      for (i=0; i<nrow; i++)
+        buf[k+i*ncol] /= norm;
+  }
+}
@@ -0,0 +1,139 @@
+/* ***************************************************** */
+/* Normalize EOFs and pack them on valid                 */
+/* points for projection.                                */
+/* pack_eof_proj.c                                       */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/*! \file pack_eof_proj.c
+    \brief Normalize EOFs and pack them on valid points for projection.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <pceof.h>
+
+/** Normalize EOFs and pack them in a (npts x neof) matrix of projection coefficients on the points where at least one EOF is valid. */
+int
+pack_eof_proj(double **eofmat, int **pts, int *npts, double *bufeof, double *singular_value,
+              double missing_value_eof, double scale, int ni, int nj, int neof)
+{
+  /**
+     @param[out]     eofmat            Packed (npts x neof) matrix of normalized EOF values, scaled by scale
+     @param[out]     pts               Grid point index of each packed point
+     @param[out]     npts              Number of packed points
+     @param[in]      bufeof            EOF of input field 3D (ni x nj x neof)
+     @param[in]      singular_value    Singular value for EOF
+     @param[in]      missing_value_eof Missing value for bufeof
+     @param[in]      scale             Scaling for units to apply before projecting onto EOF
+     @param[in]      ni                Horizontal dimension
+     @param[in]      nj                Horizontal dimension
+     @param[in]      neof              EOF dimension
+
+     \return         Status.
+  */
+
+  double norm; /* Normalization factor. */
+  double sum_verif_norm; /* Sum to verify normalization. */
+  double val; /* Double temporary value */
+
+  int eof; /* Loop counter */
+  int i; /* Loop counter */
+  int p; /* Loop counter */
+
+  /* Allocate memory */
+  (*pts) = (int *) malloc(ni*nj * sizeof(int));
+  if ((*pts) == NULL) alloc_error(__FILE__, __LINE__);
+
+  /* Select gridpoints where at least one EOF is valid */
+  (*npts) = 0;
+  for (i=0; i<ni*nj; i++)
+    for (eof=0; eof<neof; eof++)
+      if (bufeof[i+eof*ni*nj] != missing_value_eof) {
+        (*pts)[(*npts)++] = i;
+        break;
+      }
+
+  (*eofmat) = (double *) calloc((*npts)*neof, sizeof(double));
+  if ((*eofmat) == NULL && (*npts) > 0) alloc_error(__FILE__, __LINE__);
+
+  /* Loop over all EOFs */
+  /* Normalize each EOF and pack it in column eof of eofmat */
+  for (eof=0; eof<neof; eof++) {
+
+    /* Compute the sum of the squared values normalized by the singular value */
+    norm = 0.0;
+    for (p=0; p<(*npts); p++)
+      if (bufeof[(*pts)[p]+eof*ni*nj] != missing_value_eof) {
+        val = bufeof[(*pts)[p]+eof*ni*nj] / singular_value[eof];
+        norm += (val * val);
+      }
+    
+    /* Compute true value */
+    sum_verif_norm = 0.0;
+    for (p=0; p<(*npts); p++)
+      if (bufeof[(*pts)[p]+eof*ni*nj] != missing_value_eof) {
+        val = bufeof[(*pts)[p]+eof*ni*nj] / ( sqrt(norm) * singular_value[eof] );
+        sum_verif_norm += (val * val);
+        /* Projection coefficient: scale / sqrt(norm) * true value */
+        (*eofmat)[eof+p*neof] = scale / sqrt(norm) * val;
+      }
+
+    /* Verify that the norm is equal to 1.0 */
+    (void) fprintf(stdout, "%s: Verifying the sqrt(norm)=%lf (should be equal to 1) for EOF #%d: %lf\n", __FILE__, sqrt(norm),
+                   eof, sum_verif_norm);
+    if (fabs(sum_verif_norm) < 0.01) {
+      (void) fprintf(stderr, "%s: FATAL ERROR: Re-norming does not equal 1.0 : %lf.\nAborting\n", __FILE__, sum_verif_norm);
+      /* Free memory */
+      (void) free(*eofmat);
+      (void) free(*pts);
+      (*eofmat) = NULL;
+      (*pts) = NULL;
+      return -1;
+    }
+  }
+
+  /* Success status */
+  return 0;
+}
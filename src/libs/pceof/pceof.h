@@ -98,7 +98,28 @@ LICENSE END */
 /** Convert Degrees to Radian. */
 #define DEGTORAD M_PI/180.0
 
+/** Number of timesteps projected together in one matrix product. */
+#define PROJ_BLOCK_TIME 512
+
+/** Compute EOFs using a full SVD. */
+#define EOF_SVD 1
+/** Largest min(valid points, timesteps) accepted by the full SVD, which needs a square matrix of that dimension: use EOF_SVD_RANDOM above. */
+#define EOF_SVD_MAX_DIM 4000
+/** Compute EOFs using a randomized truncated SVD. */
+#define EOF_SVD_RANDOM 2
+/** Number of extra random vectors used by the randomized SVD. */
+#define EOF_RSVD_OVERSAMPLE 10
+/** Number of power iterations used by the randomized SVD. */
+#define EOF_RSVD_POWER_ITER 2
+/** Random number generator seed used by the randomized SVD. */
+#define EOF_RSVD_SEED 20080101
+
 #include <gsl/gsl_statistics.h>
+#include <gsl/gsl_matrix.h>
+#include <gsl/gsl_blas.h>
+#include <gsl/gsl_linalg.h>
+#include <gsl/gsl_rng.h>
+#include <gsl/gsl_randist.h>
 
 /* Local dependent includes */
 #include <misc.h>
@@ -107,5 +128,11 @@ LICENSE END */
 void normalize_pc(double *norm_all, double *first_variance, double *buf_renorm, double *bufin, int neof, int ntime);
 int project_field_eof(double *bufout, double *bufin, double *bufeof, double *singular_value,
                       double missing_value_eof, double *lon, double *lat, double scale, int ni, int nj, int ntime, int neof);
+int pack_eof_proj(double **eofmat, int **pts, int *npts, double *bufeof, double *singular_value,
+                  double missing_value_eof, double scale, int ni, int nj, int neof);
+void project_packed_eof(double *bufout, double *bufin, double *eofmat, int *pts, int npts, int ni, int nj, int ntime, int neof);
+int verify_proj_eof_variance(double *bufout, double *bufin, double *singular_value, int ntime, int neof);
+int compute_eof(double *eof, double *sing, double *bufin, double missing_value, int method, int ni, int nj, int ntime, int neof);
+void orthonormalize_columns(double *buf, int nrow, int ncol);
 
 #endif
@@ -0,0 +1,114 @@
+/* ***************************************************** */
+/* Project a field onto packed EOFs.                     */
+/* project_packed_eof.c                                  */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/*! \file project_packed_eof.c
+    \brief Project a field onto packed EOFs.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <pceof.h>
+
+/** Project timesteps of a field onto EOFs packed by pack_eof_proj, without any diagnostic, so that it can be called on successive chunks of a field. */
+void
+project_packed_eof(double *bufout, double *bufin, double *eofmat, int *pts, int npts, int ni, int nj, int ntime, int neof)
+{
+  /**
+     @param[out]     bufout            Output 2D (neof x ntime) projected bufin field
+     @param[in]      bufin             Input field 3D (ni x nj x ntime)
+     @param[in]      eofmat            Packed (npts x neof) matrix of normalized EOF values
+     @param[in]      pts               Grid point index of each packed point
+     @param[in]      npts              Number of packed points
+     @param[in]      ni                Horizontal dimension
+     @param[in]      nj                Horizontal dimension
+     @param[in]      ntime             Temporal dimension
+     @param[in]      neof              EOF dimension
+  */
+
+  double *bufblk = NULL; /* Packed [ntblk x npts] block of input field */
+  double *outblk = NULL; /* [ntblk x neof] block of projected field */
+  int ntblk; /* Number of timesteps in current block */
+  int nblk; /* Maximum number of timesteps in a block */
+  gsl_matrix_view mat_in; /* Matrix view of bufblk */
+  gsl_matrix_view mat_eof; /* Matrix view of eofmat */
+  gsl_matrix_view mat_out; /* Matrix view of outblk */
+
+  int eof; /* Loop counter */
+  int t; /* Loop counter */
+  int tt; /* Loop counter */
+  int p; /* Loop counter */
+
+  if (npts > 0 && ntime > 0) {
+    /* Process time in blocks: bufout[ntblk x neof] = bufblk[ntblk x npts] * eofmat[npts x neof] */
+    nblk = (ntime < PROJ_BLOCK_TIME) ? ntime : PROJ_BLOCK_TIME;
+    bufblk = (double *) malloc(nblk*npts * sizeof(double));
+    if (bufblk == NULL) alloc_error(__FILE__, __LINE__);
+    outblk = (double *) malloc(nblk*neof * sizeof(double));
+    if (outblk == NULL) alloc_error(__FILE__, __LINE__);
+    mat_eof = gsl_matrix_view_array(eofmat, (size_t) npts, (size_t) neof);
+
+    for (t=0; t<ntime; t+=nblk) {
+      ntblk = (t+nblk <= ntime) ? nblk : (ntime-t);
+      /* Pack valid points of this time block */
+      for (tt=0; tt<ntblk; tt++)
+        for (p=0; p<npts; p++)
+          bufblk[p+tt*npts] = bufin[pts[p]+(t+tt)*ni*nj];
+      mat_in = gsl_matrix_view_array(bufblk, (size_t) ntblk, (size_t) npts);
+      mat_out = gsl_matrix_view_array(outblk, (size_t) ntblk, (size_t) neof);
+      (void) gsl_blas_dgemm(CblasNoTrans, CblasNoTrans, 1.0, &mat_in.matrix, &mat_eof.matrix, 0.0, &mat_out.matrix);
+      /* Unpack into (neof x ntime) output */
+      for (tt=0; tt<ntblk; tt++)
+        for (eof=0; eof<neof; eof++)
+          bufout[(t+tt)+eof*ntime] = outblk[eof+tt*neof];
+    }
+    (void) free(bufblk);
+    (void) free(outblk);
+  }
+  else
+    for (t=0; t<ntime*neof; t++)
+      bufout[t] = 0.0;
+}
@@ -0,0 +1,103 @@
+/* ***************************************************** */
+/* Verify the variance of a field projected              */
+/* onto EOFs.                                            */
+/* verify_proj_eof_variance.c                            */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/*! \file verify_proj_eof_variance.c
+    \brief Verify the variance of a field projected onto EOFs.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <pceof.h>
+
+/** Verify that the variance of a field projected onto EOFs is of the same order as the singular values. */
+int
+verify_proj_eof_variance(double *bufout, double *bufin, double *singular_value, int ntime, int neof)
+{
+  /**
+     @param[in]      bufout            Projected field 2D (neof x ntime)
+     @param[in]      bufin             Input field 3D (ni x nj x ntime) before projection, or NULL when it is not available
+     @param[in]      singular_value    Singular value for EOF
+     @param[in]      ntime             Temporal dimension
+     @param[in]      neof              EOF dimension
+
+     \return         Status.
+  */
+
+  double variance_bufin; /* Variance of input buffer */
+  double tot_variance_bufin = 0.0; /* Total Variance of input buffer */
+  double variance_bufout; /* Variance of output buffer */
+  double tot_variance_bufout = 0.0; /* Total Variance of output buffer */
+
+  int eof; /* Loop counter */
+
+  /* Verify variance of field */
+  for (eof=0; eof<neof; eof++) {
+    variance_bufout = gsl_stats_variance(&(bufout[eof*ntime]), 1, ntime);
+    tot_variance_bufout += variance_bufout;
+    if (bufin != NULL) {
+      variance_bufin = gsl_stats_variance(&(bufin[eof*ntime]), 1, ntime);
+      tot_variance_bufin += variance_bufin;
+    }
+
+    /* Should be of the same order */
+    (void) fprintf(stdout, "%s: Verifying square-root of variance (should be the same order): %lf %lf\n", __FILE__,
+                   sqrt(variance_bufout), singular_value[eof]);
+    (void) fprintf(stdout, "%s: %lf\n", __FILE__, sqrt(variance_bufout) / singular_value[eof]);
+    if ( (sqrt(variance_bufout) / singular_value[eof]) >= 10.0) {
+      (void) fprintf(stderr, "%s: FATAL ERROR: Problem in scaling factor! Variance is not of the same order. Verify configuration file scaling factor.\nAborting\n", __FILE__);
+      return -1;
+    }
+  }
+
+  if (bufin != NULL)
+    (void) fprintf(stdout, "%s: Comparing total variance of field before %lf and after %lf projection onto EOF: %% of variance remaining: %lf\n",
+                   __FILE__, tot_variance_bufin, tot_variance_bufout, tot_variance_bufout / tot_variance_bufin * 100.0);
+
+  /* Success status */
+  return 0;
+}
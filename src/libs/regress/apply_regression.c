@@ -53,16 +53,18 @@ LICENSE END */
 
 
 #include <regress.h>
+#include <misc.h>
 
-/** Compute a field using regression coefficients and the field values. */
+/** Compute a field using regression coefficients and the field values, as a matrix product of the distances
+    [ntime x nreg] by the regression coefficients [nreg x npts] over blocks of time, plus the regression constants. */
 void
 apply_regression(double *buf, double *reg, double *cst, double *dist, double *sup_dist, int npts, int ntime,
                  int nclust, int nreg) {
   /**
-     @param[out]  buf        2D field
-     @param[in]   reg        Regression coefficients
+     @param[out]  buf        2D field (npts X ntime)
+     @param[in]   reg        Regression coefficients (npts X nreg)
      @param[in]   cst        Regression constant
-     @param[in]   dist       Values of input vector
+     @param[in]   dist       Values of input vector (ntime X nclust)
      @param[in]   sup_dist   If there is one supplemental regression coefficient, use a supplemental vector
      @param[in]   npts       Points dimension
      @param[in]   ntime      Time dimension
@@ -70,37 +72,52 @@ apply_regression(double *buf, double *reg, double *cst, double *dist, double *su
      @param[in]   nreg       Regression dimension
    */
 
+  gsl_matrix_view mat_dist; /* Matrix view of distances of one time block */
+  gsl_matrix_view mat_reg; /* Matrix view of regression coefficients */
+  gsl_matrix_view mat_buf; /* Matrix view of output field of one time block */
+
+  double *distblk = NULL; /* Distances of one time block, time-major */
+  int nterm; /* Number of regression terms used */
+  int nblk; /* Number of timesteps in a full block */
+  int ntblk; /* Number of timesteps in current block */
   int nt; /* Time loop counter */
+  int tt; /* Time loop counter within block */
   int pts; /* Points loop counter */
   int clust; /* Cluster loop counter */
 
-  /* Loop over all regression points */
-  for (pts=0; pts<npts; pts++) {
-    /* Loop over all times */
-    for (nt=0; nt<ntime; nt++) {
-      /* Initialize value */
-      buf[pts+nt*npts] = 0.0;
-      /* Loop over all clusters and add each value after regression is applied */
-      for (clust=0; clust<nclust; clust++) {
-        buf[pts+nt*npts] += (dist[nt+clust*ntime] * reg[pts+clust*npts]);
-
-        //        if (pts == 0 && nt == (ntime-5))
-        //          printf("%d %lf %lf %lf\n",clust,buf[pts+nt*npts],(dist[nt+clust*ntime]),(reg[pts+clust*npts]));
-      }
-      /* Extra regression coefficient with a second supplemental vector */
-      if (nclust == (nreg-1)) {
-        buf[pts+nt*npts] += (sup_dist[nt] * reg[pts+(nreg-1)*npts]);
-      }      
-      
-      /* Add regression constant */
-      buf[pts+nt*npts] += cst[pts];
-
-      //     if (pts == 0 && nt == (ntime-5))
-      //       printf("%lf %lf\n",buf[pts+nt*npts],cst[pts]);
+  if (npts <= 0 || ntime <= 0)
+    return;
+
+  /* Extra regression coefficient with a second supplemental vector */
+  if (nclust == (nreg-1))
+    nterm = nreg;
+  else
+    nterm = nclust;
+
+  nblk = (ntime < REGRESS_BLOCK_TIME) ? ntime : REGRESS_BLOCK_TIME;
+  distblk = (double *) malloc(nblk*nterm * sizeof(double));
+  if (distblk == NULL) alloc_error(__FILE__, __LINE__);
+  mat_reg = gsl_matrix_view_array(reg, (size_t) nterm, (size_t) npts);
+
+  for (nt=0; nt<ntime; nt+=nblk) {
+    ntblk = (nt+nblk <= ntime) ? nblk : (ntime-nt);
+    /* Pack distances of this time block */
+    for (tt=0; tt<ntblk; tt++) {
+      for (clust=0; clust<nclust; clust++)
+        distblk[clust+tt*nterm] = dist[(nt+tt)+clust*ntime];
+      if (nterm > nclust)
+        distblk[nclust+tt*nterm] = sup_dist[nt+tt];
     }
+    /* buf[ntblk x npts] = distblk[ntblk x nterm] * reg[nterm x npts], written in place in the output field */
+    mat_dist = gsl_matrix_view_array(distblk, (size_t) ntblk, (size_t) nterm);
+    mat_buf = gsl_matrix_view_array(&(buf[nt*npts]), (size_t) ntblk, (size_t) npts);
+    (void) gsl_blas_dgemm(CblasNoTrans, CblasNoTrans, 1.0, &mat_dist.matrix, &mat_reg.matrix, 0.0, &mat_buf.matrix);
+
+    /* Add regression constant */
+    for (tt=0; tt<ntblk; tt++)
+      for (pts=0; pts<npts; pts++)
+        buf[pts+(nt+tt)*npts] += cst[pts];
   }
-  //  nt = ntime-1;
-  //  pts = 0;
-  //  for (clust=0; clust<nclust; clust++)
-  //    printf("REGRESS %d %lf %lf %lf %lf\n",clust,buf[pts+nt*npts],dist[nt+clust*ntime],reg[pts+clust*npts],cst[pts]);
+
+  (void) free(distblk);
 }
@@ -91,14 +91,10 @@ regress(double *coef, double *x, double *y, double *cte, double *yreg, double *y
 
   int istat; /* Diagnostic status */
   int term; /* Loop counter for variables dimension */
-  int vterm;
-  int cterm;
   int pts; /* Loop counter for vector dimension */
 
   size_t stride = 1; /* Stride for GSL functions */
 
-  double vchisq; /* Temporary value for chi^2 for VIF */
-  double *ytmp; /* Temporary vector for y for VIF */
   double ystd; /* Standard deviation of fitted function */
 
   /* Allocate memory and create matrices and vectors */
@@ -226,75 +222,9 @@ regress(double *coef, double *x, double *y, double *cte, double *yreg, double *y
 #if DEBUG >= 7
   (void) fprintf(stdout, "%s: VIF calculation\n", __FILE__);
 #endif
-  xx = gsl_matrix_alloc(npts, nterm);
-  yy = gsl_vector_alloc(npts);
-
-  ccoef = gsl_vector_alloc(nterm);
-  cov = gsl_matrix_alloc(nterm, nterm);
-
-  ytmp = (double *) malloc(npts * sizeof(double));
-  if (ytmp == NULL) alloc_error(__FILE__, __LINE__);
-  
-  /* Loop over parameters */
-  for (vterm=0; vterm<nterm; vterm++) {
-
-    (void) gsl_matrix_set_zero(xx);
-    (void) gsl_matrix_set_zero(cov);
-
-    (void) gsl_vector_set_zero(yy);
-    (void) gsl_vector_set_zero(ccoef);
-
-    /* Create X matrix */
-    cterm = 0;
-    for (term=0; term<nterm; term++) {
-      if (term != vterm) {
-        for (pts=0; pts<npts; pts++)
-          (void) gsl_matrix_set(xx, pts, cterm+1, x[pts+term*npts]);
-        cterm++;
-      }
-    }
-    
-    /* Create first column of matrix for regression constant */
-    for (pts=0; pts<npts; pts++)
-      (void) gsl_matrix_set(xx, pts, 0, 1.0);  
-    
-    /* Create Y vector for all vector dimension, using the vterm X values */
-    for (pts=0; pts<npts; pts++) {
-      ytmp[pts] = x[pts+vterm*npts];
-      (void) gsl_vector_set(yy, pts, ytmp[pts]);
-    }
-    
-    /* Allocate workspace */
-    work = gsl_multifit_linear_alloc(npts, nterm);
-
-    /* Perform linear regression just to get chi^2 */
-    istat = gsl_multifit_linear(xx, yy, ccoef, cov, &vchisq, work);
-    if (istat != GSL_SUCCESS) {
-      (void) fprintf(stderr, "%s: Line %d: Error %d in multifitting algorithm!\n", __FILE__, __LINE__, istat);
-      (void) gsl_multifit_linear_free(work);
-      (void) gsl_matrix_free(xx);
-      (void) gsl_matrix_free(cov);
-      (void) gsl_vector_free(yy);
-      (void) gsl_vector_free(ccoef);
-      (void) free(ytmp);
-      return istat;
-    }
-    
-    /* Free workspace */
-    (void) gsl_multifit_linear_free(work);
-
-    /* Compute R^2 = 1 - \chi^2 / TSS */
-    /* and finally VIF = 1.0 / (1.0 - R^2) */
-    vif[vterm] = 1.0 / (1.0 - (1.0 - ( vchisq / gsl_stats_tss(ytmp, stride, (size_t) pts) ) ));
-  }
-    
-  /* Dealloc matrices and vectors memory */
-  (void) gsl_matrix_free(xx);
-  (void) gsl_matrix_free(cov);
-  (void) gsl_vector_free(yy);
-  (void) gsl_vector_free(ccoef);
-  
-  (void) free(ytmp);
+  istat = regress_vif(vif, x, nterm, npts);
+  if (istat != 0)
+    return istat;
 
   /* Success status */
   return 0;
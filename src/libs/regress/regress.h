@@ -80,11 +80,18 @@ LICENSE END */
 #include <gsl/gsl_matrix.h>
 #include <gsl/gsl_vector.h>
 #include <gsl/gsl_multifit.h>
+#include <gsl/gsl_blas.h>
 #include <gsl/gsl_statistics_double.h>
 
+/** Number of timesteps computed together in one matrix product in apply_regression. */
+#define REGRESS_BLOCK_TIME 512
+
 /* Prototypes */
 int regress(double *coef, double *x, double *y, double *cte, double *yreg, double *yerr,
             double *chisq, double *rsq, double *vif, double *autocor, int nterm, int npts);
+int regress_multi(double *coef, double *x, double *y, double *cte, double *yreg, double *yerr,
+                  double *chisq, double *rsq, double *vif, double *autocor, int nterm, int npts, int nresp);
+int regress_vif(double *vif, double *x, int nterm, int npts);
 void apply_regression(double *buf, double *reg, double *cst, double *dist, double *sup_dist, int npts, int ntime, int nclust, int nreg);
 
 #endif
@@ -0,0 +1,186 @@
+/* ***************************************************** */
+/* Compute regression coefficients with a                */
+/* regression constant for several Y vectors             */
+/* sharing the same X vectors.                           */
+/* regress_multi.c                                       */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/*! \file regress_multi.c
+    \brief Compute regression coefficients with a regression constant for several Y vectors sharing the same X vectors.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <regress.h>
+#include <misc.h>
+
+/** Compute regression coefficients with a regression constant for nresp Y vectors sharing the same X vectors,
+    having nterm variables (usually parameters) and npts dimension (usually time).
+    The X matrix is factorized (SVD) only once and each Y vector is solved with that factorization,
+    giving the same results as calling regress() for each Y vector. */
+int
+regress_multi(double *coef, double *x, double *y, double *cte, double *yreg, double *yerr,
+              double *chisq, double *rsq, double *vif, double *autocor, int nterm, int npts, int nresp) {
+  /**
+     @param[out]  coef      Regression coefficients (nresp X nterm)
+     @param[in]   x         X vectors (nterm X npts) npts is usually time, nterm the number of parameters
+     @param[in]   y         Y vectors (npts X nresp) npts is usually time, nresp the number of Y vectors
+     @param[out]  cte       Regression constant (nresp)
+     @param[out]  yreg      Y vectors reconstructed with regression (nresp X npts)
+     @param[out]  yerr      Y error vectors when reconstructing Y vectors with regression (nresp X npts)
+     @param[out]  chisq     Chi-square diagnostic (nresp)
+     @param[out]  rsq       Coefficient of determination diagnostic R^2 = 1 - \chi^2 / TSS (nresp)
+     @param[out]  vif       Variance Inflation Factor for each parameter (nterm), which only depends on X vectors
+     @param[out]  autocor   Autocorrelation of residuals (Durbin-Watson test) (nresp)
+     @param[in]   nterm     Variables dimension
+     @param[in]   npts      Vector dimension
+     @param[in]   nresp     Number of Y vectors
+
+     \return      Status
+  */
+  
+  gsl_matrix *xx; /* X matrix */
+
+  gsl_multifit_linear_workspace *work; /* Workspace */
+
+  gsl_vector *yy; /* Y vector */
+  gsl_vector *ccoef; /* Coefficients vector */
+
+  int istat; /* Diagnostic status */
+  int term; /* Loop counter for variables dimension */
+  int pts; /* Loop counter for vector dimension */
+  int resp; /* Loop counter for Y vectors */
+
+  size_t stride = 1; /* Stride for GSL functions */
+
+  double rnorm; /* Residual norm */
+  double snorm; /* Solution norm */
+  double val; /* Reconstructed value */
+
+  /* Allocate memory and create matrices and vectors */
+  xx = gsl_matrix_alloc(npts, nterm+1);
+  yy = gsl_vector_alloc(npts);
+  ccoef = gsl_vector_alloc(nterm+1);
+
+  /* Create X matrix */
+  for (term=0; term<nterm; term++)
+    for (pts=0; pts<npts; pts++)
+      (void) gsl_matrix_set(xx, pts, term+1, x[pts+term*npts]);
+
+  /* Create first column of matrix for regression constant */
+  for (pts=0; pts<npts; pts++)
+    (void) gsl_matrix_set(xx, pts, 0, 1.0);  
+
+  /* Allocate workspace */
+  work = gsl_multifit_linear_alloc(npts, nterm+1);
+
+  /* Factorize X matrix once, with column balancing as in gsl_multifit_linear */
+  istat = gsl_multifit_linear_bsvd(xx, work);
+  if (istat != GSL_SUCCESS) {
+    (void) fprintf(stderr, "%s: Line %d: Error %d in multifitting SVD decomposition!\n", __FILE__, __LINE__, istat);
+    (void) gsl_multifit_linear_free(work);
+    (void) gsl_matrix_free(xx);
+    (void) gsl_vector_free(yy);
+    (void) gsl_vector_free(ccoef);
+    return istat;
+  }
+
+  for (resp=0; resp<nresp; resp++) {
+
+    /* Create Y vector for all vector dimension */
+    for (pts=0; pts<npts; pts++)
+      (void) gsl_vector_set(yy, pts, y[pts+resp*npts]);
+
+    /* Solve linear regression using the factorization */
+    istat = gsl_multifit_linear_solve(0.0, xx, yy, ccoef, &rnorm, &snorm, work);
+    if (istat != GSL_SUCCESS) {
+      (void) fprintf(stderr, "%s: Line %d: Error %d in multifitting algorithm!\n", __FILE__, __LINE__, istat);
+      (void) gsl_multifit_linear_free(work);
+      (void) gsl_matrix_free(xx);
+      (void) gsl_vector_free(yy);
+      (void) gsl_vector_free(ccoef);
+      return istat;
+    }
+    chisq[resp] = rnorm * rnorm;
+
+    /* Retrieve regression coefficients */
+    for (term=0; term<nterm; term++)
+      coef[resp+term*nresp] = gsl_vector_get(ccoef, term+1);
+    /* Retrieve regression constant */
+    cte[resp] = gsl_vector_get(ccoef, 0);
+
+    /* Compute R^2 = 1 - \chi^2 / TSS */
+    rsq[resp] = 1.0 - ( chisq[resp] / gsl_stats_tss(&(y[resp*npts]), stride, (size_t) npts) );
+
+    /* Reconstruct vector using regression coefficients, and compute residuals */
+    for (pts=0; pts<npts; pts++) {
+      val = 0.0;
+      for (term=0; term<=nterm; term++)
+        val += gsl_matrix_get(xx, pts, term) * gsl_vector_get(ccoef, term);
+      yreg[resp+pts*nresp] = val;
+      yerr[resp+pts*nresp] = y[pts+resp*npts] - val;
+    }
+  }
+
+  /* Compute autocorrelation of residuals (Durbin-Watson) */
+  for (resp=0; resp<nresp; resp++)
+    autocor[resp] = gsl_stats_lag1_autocorrelation(&(yerr[resp]), (size_t) nresp, (size_t) npts);
+
+  /* Dealloc matrices and vectors memory */
+  (void) gsl_multifit_linear_free(work);
+  (void) gsl_matrix_free(xx);
+  (void) gsl_vector_free(yy);
+  (void) gsl_vector_free(ccoef);
+
+  /** Regression diagnostics **/
+  
+  /* VIF */
+  istat = regress_vif(vif, x, nterm, npts);
+  if (istat != 0)
+    return istat;
+
+  /* Success status */
+  return 0;
+}
@@ -0,0 +1,121 @@
+/* ***************************************************** */
+/* get_file_list Expand a filename pattern               */
+/* into a sorted list of files.                          */
+/* get_file_list.c                                       */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file get_file_list.c
+    \brief Expand a filename pattern into a sorted list of files.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <utils.h>
+
+/** Expand a filename pattern (shell wildcards) into a sorted list of existing files. */
+int
+get_file_list(char ***filelist, int *nfiles, char *pattern) {
+  /**
+     @param[out]  filelist   List of filenames, sorted alphabetically.
+     @param[out]  nfiles     Number of filenames in list.
+     @param[in]   pattern    Filename, or filename pattern with shell wildcards.
+     
+     \return           Status.
+  */
+
+#ifdef HAVE_GLOB_H
+  glob_t globbuf; /* Pattern matching results */
+  int istat; /* Diagnostic status */
+  int flags = 0; /* Pattern matching flags */
+  int f; /* Loop counter for files */
+
+#ifdef GLOB_BRACE
+  flags = GLOB_BRACE;
+#endif
+
+  /* Plain filenames are kept as is: missing files will be reported when opened */
+  if (strpbrk(pattern, "*?[{") == NULL) {
+    *nfiles = 1;
+    (*filelist) = (char **) malloc(sizeof(char *));
+    if ((*filelist) == NULL) alloc_error(__FILE__, __LINE__);
+    (*filelist)[0] = strdup(pattern);
+    return 0;
+  }
+
+  istat = glob(pattern, flags, NULL, &globbuf);
+  if (istat != 0 || globbuf.gl_pathc == 0) {
+    (void) fprintf(stderr, "%s: No file matching pattern %s.\n", __FILE__, pattern);
+    globfree(&globbuf);
+    *nfiles = 0;
+    (*filelist) = NULL;
+    return -1;
+  }
+
+  *nfiles = (int) globbuf.gl_pathc;
+  (*filelist) = (char **) malloc((*nfiles) * sizeof(char *));
+  if ((*filelist) == NULL) alloc_error(__FILE__, __LINE__);
+  for (f=0; f<(*nfiles); f++)
+    (*filelist)[f] = strdup(globbuf.gl_pathv[f]);
+
+  globfree(&globbuf);
+#else
+  /* Without pattern matching support, only a single filename can be used */
+  *nfiles = 1;
+  (*filelist) = (char **) malloc(sizeof(char *));
+  if ((*filelist) == NULL) alloc_error(__FILE__, __LINE__);
+  (*filelist)[0] = strdup(pattern);
+#endif
+
+  /* Success status */
+  return 0;
+}
@@ -0,0 +1,100 @@
+/* ***************************************************** */
+/* hash_file Update a hash with the identity             */
+/* of files matching a filename pattern.                 */
+/* hash_file.c                                           */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file hash_file.c
+    \brief Update a hash with the name, size and modification time of files.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <utils.h>
+
+/** Update a hash with the name, size and modification time of a file, or of all files matching a filename pattern.
+    Missing files are identified only by their name. */
+unsigned long long
+hash_file(unsigned long long hash, char *filename) {
+  /**
+     @param[in]  hash      Current hash value.
+     @param[in]  filename  Filename, or filename pattern with shell wildcards.
+     
+     \return               Updated hash value.
+  */
+
+  char **filelist = NULL; /* List of files */
+  int nfiles = 0; /* Number of files */
+  struct stat st; /* File information */
+  long long int size; /* File size */
+  long long int mtime; /* File modification time */
+  int f; /* Loop counter for files */
+
+  hash = hash_bytes(hash, filename, strlen(filename)+1);
+
+  if (get_file_list(&filelist, &nfiles, filename) != 0)
+    return hash;
+  for (f=0; f<nfiles; f++) {
+    hash = hash_bytes(hash, filelist[f], strlen(filelist[f])+1);
+    if (stat(filelist[f], &st) == 0) {
+      size = (long long int) st.st_size;
+      mtime = (long long int) st.st_mtime;
+      hash = hash_bytes(hash, &size, sizeof(size));
+      hash = hash_bytes(hash, &mtime, sizeof(mtime));
+    }
+    (void) free(filelist[f]);
+  }
+  (void) free(filelist);
+
+  return hash;
+}
@@ -87,6 +87,9 @@ LICENSE END */
 #ifdef HAVE_ERRNO_H
 #include <errno.h>
 #endif
+#ifdef HAVE_GLOB_H
+#include <glob.h>
+#endif
 
 #include <gsl/gsl_statistics.h>
 
@@ -101,6 +104,9 @@ LICENSE END */
 /** FALSE value macro is 0. */
 #define FALSE 0
 
+/** Initial value of a FNV-1a 64-bit hash. */
+#define HASH_INIT 14695981039346656037ULL
+
 /** Easy time structure. */
 typedef struct {
   int year;  /**< Year (4-digits). */
@@ -161,5 +167,8 @@ int find_str_value(char *str, char **str_vect, int nelem);
 void alt_to_press(double *pres, double *alt, int ni, int nj);
 void spechum_to_hr(double *hr, double *tas, double *hus, double *pmsl, double fillvalue, int ni, int nj);
 void calc_etp_mf(double *etp, double *tas, double *hus, double *rsds, double *rlds, double *uvas, double *pmsl, double fillvalue, int ni, int nj);
+int get_file_list(char ***filelist, int *nfiles, char *pattern);
+unsigned long long hash_bytes(unsigned long long hash, const void *buf, size_t n);
+unsigned long long hash_file(unsigned long long hash, char *filename);
 
 #endif
@@ -202,6 +202,48 @@ load_conf(data_struct *data, char *fileconf) {
   if (val != NULL)
     (void) xmlFree(val);
 
+  /** performance_report: JSON report of time, memory and NetCDF data volume of downscaling stages **/
+  data->conf->perf_report = NULL;
+  (void) sprintf(path, "/configuration/%s[@name=\"%s\"]", "setting", "performance_report");
+  val = xml_get_setting(conf, path);
+  if (val != NULL) {
+    data->conf->perf_report = (char *) malloc((xmlStrlen(val)+1) * sizeof(char));
+    if (data->conf->perf_report == NULL) alloc_error(__FILE__, __LINE__);
+    (void) strcpy(data->conf->perf_report, (char *) val);
+    (void) fprintf(stdout, "%s: performance_report = %s\n", __FILE__, data->conf->perf_report);
+    (void) xmlFree(val);
+  }
+
+  /** performance_attribute: also write the performance report as a global attribute of output files **/
+  (void) sprintf(path, "/configuration/%s[@name=\"%s\"]", "setting", "performance_attribute");
+  val = xml_get_setting(conf, path);
+  if (val != NULL) 
+    data->conf->perf_attribute = (int) strtol((char *) val, (char **)NULL, 10);
+  else
+    data->conf->perf_attribute = FALSE;
+  if (data->conf->perf_attribute != FALSE && data->conf->perf_attribute != TRUE) {
+    (void) fprintf(stderr, "%s: Invalid performance_attribute value %s in configuration file. Aborting.\n", __FILE__, val);
+    return -1;
+  }
+  (void) fprintf(stdout, "%s: performance_attribute = %d\n", __FILE__, data->conf->perf_attribute);
+  if (val != NULL) 
+    (void) xmlFree(val);
+
+  /** prefetch_obs: read ahead whole observation files of the next analog dates when writing output **/
+  (void) sprintf(path, "/configuration/%s[@name=\"%s\"]", "setting", "prefetch_obs");
+  val = xml_get_setting(conf, path);
+  if (val != NULL) 
+    data->conf->prefetch_obs = (int) strtol((char *) val, (char **)NULL, 10);
+  else
+    data->conf->prefetch_obs = FALSE;
+  if (data->conf->prefetch_obs != FALSE && data->conf->prefetch_obs != TRUE) {
+    (void) fprintf(stderr, "%s: Invalid prefetch_obs value %s in configuration file. Aborting.\n", __FILE__, val);
+    return -1;
+  }
+  (void) fprintf(stdout, "%s: prefetch_obs = %d\n", __FILE__, data->conf->prefetch_obs);
+  if (val != NULL) 
+    (void) xmlFree(val);
+
   /** format: NetCDF-4 or NetCDF-3 for output files **/
   (void) sprintf(path, "/configuration/%s[@name=\"%s\"]", "setting", "format");
   val = xml_get_setting(conf, path);
@@ -320,11 +362,25 @@ load_conf(data_struct *data, char *fileconf) {
   if (val != NULL)
     (void) xmlFree(val);
 
+  /** stream_chunk **/
+  (void) sprintf(path, "/configuration/%s[@name=\"%s\"]", "setting", "stream_chunk");
+  val = xml_get_setting(conf, path);
+  if (val != NULL)
+    data->conf->stream_chunk = (int) xmlXPathCastStringToNumber(val);
+  else
+    data->conf->stream_chunk = 0;
+  if (data->conf->stream_chunk < 0)
+    data->conf->stream_chunk = 0;
+  (void) fprintf(stdout, "%s: stream_chunk = %d\n", __FILE__, data->conf->stream_chunk);
+  if (val != NULL)
+    (void) xmlFree(val);
+
   /** clim_filter_type **/
   (void) sprintf(path, "/configuration/%s[@name=\"%s\"]", "setting", "clim_filter_type");
   val = xml_get_setting(conf, path);
-  if ( !xmlStrcmp(val, (xmlChar *) "hanning") )
-    data->conf->clim_filter_type = strdup("hanning");
+  if ( !xmlStrcmp(val, (xmlChar *) "hanning") || !xmlStrcmp(val, (xmlChar *) "hamming") ||
+       !xmlStrcmp(val, (xmlChar *) "blackman") || !xmlStrcmp(val, (xmlChar *) "rectangular") )
+    data->conf->clim_filter_type = strdup((char *) val);
   else {
     (void) fprintf(stderr, "%s: Invalid clim_filter_type value %s in configuration file. Aborting.\n", __FILE__, val);
     (void) abort();
@@ -357,6 +413,21 @@ load_conf(data_struct *data, char *fileconf) {
   if (val != NULL)
     (void) xmlFree(val);
 
+  /** classif_init **/
+  (void) sprintf(path, "/configuration/%s[@name=\"%s\"]", "setting", "classif_init");
+  val = xml_get_setting(conf, path);
+  if (val == NULL || !xmlStrcmp(val, (xmlChar *) "random") )
+    data->conf->classif_init = strdup("random");
+  else if ( !xmlStrcmp(val, (xmlChar *) "kmeans++") )
+    data->conf->classif_init = strdup("kmeans++");
+  else {
+    (void) fprintf(stderr, "%s: Invalid classif_init value %s in configuration file. Aborting.\n", __FILE__, val);
+    (void) abort();
+  }
+  (void) fprintf(stdout, "%s: classif_init = %s\n", __FILE__, data->conf->classif_init);
+  if (val != NULL)
+    (void) xmlFree(val);
+
   /** npartitions **/
   (void) sprintf(path, "/configuration/%s[@name=\"%s\"]", "setting", "number_of_partitions");
   val = xml_get_setting(conf, path);
@@ -379,6 +450,44 @@ load_conf(data_struct *data, char *fileconf) {
   if (val != NULL)
     (void) xmlFree(val);    
 
+  /** classif_tolerance **/
+  (void) sprintf(path, "/configuration/%s[@name=\"%s\"]", "setting", "classif_tolerance");
+  val = xml_get_setting(conf, path);
+  if (val != NULL)
+    data->conf->classif_tolerance = xmlXPathCastStringToNumber(val);
+  else
+    data->conf->classif_tolerance = 0.0;
+  (void) fprintf(stdout, "%s: Classification center shift tolerance = %lf\n", __FILE__, data->conf->classif_tolerance);
+  if (val != NULL)
+    (void) xmlFree(val);    
+
+  /** classif_seed **/
+  (void) sprintf(path, "/configuration/%s[@name=\"%s\"]", "setting", "classif_seed");
+  val = xml_get_setting(conf, path);
+  if (val != NULL)
+    data->conf->classif_seed = (unsigned long int) xmlXPathCastStringToNumber(val);
+  else
+    data->conf->classif_seed = 1;
+  /* A seed of 0 means a different seed for each run */
+  if (data->conf->classif_seed == 0)
+    data->conf->classif_seed = (unsigned long int) time(NULL);
+  (void) fprintf(stdout, "%s: Classification master seed = %lu\n", __FILE__, data->conf->classif_seed);
+  if (val != NULL)
+    (void) xmlFree(val);    
+
+  /** number_of_threads **/
+  (void) sprintf(path, "/configuration/%s[@name=\"%s\"]", "setting", "number_of_threads");
+  val = xml_get_setting(conf, path);
+  if (val != NULL)
+    data->conf->nthreads = xmlXPathCastStringToNumber(val);
+  else
+    data->conf->nthreads = 1;
+  if (data->conf->nthreads < 1)
+    data->conf->nthreads = 1;
+  (void) fprintf(stdout, "%s: Number of threads = %d\n", __FILE__, data->conf->nthreads);
+  if (val != NULL)
+    (void) xmlFree(val);    
+
   /** use_downscaled_year **/
   (void) sprintf(path, "/configuration/%s[@name=\"%s\"]", "setting", "use_downscaled_year");
   val = xml_get_setting(conf, path);
@@ -1651,6 +1760,24 @@ load_conf(data_struct *data, char *fileconf) {
   if (val != NULL) 
     (void) xmlFree(val);
 
+  /** learning_incremental **/
+  (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s", "setting", "learning", "learning_incremental");
+  val = xml_get_setting(conf, path);
+  if (val != NULL) 
+    data->learning->learning_incremental = (int) strtol((char *) val, (char **)NULL, 10);
+  else
+    data->learning->learning_incremental = FALSE;
+  if (data->learning->learning_incremental != FALSE && data->learning->learning_incremental != TRUE) {
+    (void) fprintf(stderr, "%s: Invalid learning_incremental value %s in configuration file. Aborting.\n", __FILE__, val);
+    return -1;
+  }
+  if (data->learning->learning_provided == TRUE)
+    /* Nothing to warm-start when learning data is read from files */
+    data->learning->learning_incremental = FALSE;
+  (void) fprintf(stdout, "%s: learning_incremental=%d\n", __FILE__, data->learning->learning_incremental);
+  if (val != NULL) 
+    (void) xmlFree(val);
+
   /** number of EOFs one parameter **/
   (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s", "setting", "learning", "number_of_eofs");
   val = xml_get_setting(conf, path);
@@ -1685,6 +1812,30 @@ load_conf(data_struct *data, char *fileconf) {
       (void) xmlFree(val);    
   }
 
+  /** eof_compute **/
+  data->learning->eof_compute = FALSE;
+  data->learning->filename_rea_field = NULL;
+  data->learning->nomvar_rea_field = NULL;
+  data->learning->nomvar_obs_field = NULL;
+  data->learning->rea_eof_ls = NULL;
+  data->learning->rea_lon = NULL;
+  data->learning->rea_lat = NULL;
+  if (data->learning->learning_provided == FALSE) {
+    (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s", "setting", "learning", "eof_compute");
+    val = xml_get_setting(conf, path);
+    if (val != NULL)
+      data->learning->eof_compute = (int) strtol((char *) val, (char **)NULL, 10);
+    if (data->learning->eof_compute != FALSE && data->learning->eof_compute != EOF_SVD &&
+        data->learning->eof_compute != EOF_SVD_RANDOM) {
+      (void) fprintf(stderr, "%s: Invalid learning eof_compute value %s in configuration file. Must be 0 (read), %d (SVD) or %d (randomized SVD). Aborting.\n",
+                     __FILE__, val, EOF_SVD, EOF_SVD_RANDOM);
+      return -1;
+    }
+    if (val != NULL)
+      (void) xmlFree(val);
+  }
+  (void) fprintf(stdout, "%s: Learning eof_compute = %d\n", __FILE__, data->learning->eof_compute);
+
   /* If learning data is saved, additional parameters are needed */
   if (data->learning->learning_save == TRUE) {
 
@@ -1737,8 +1888,8 @@ load_conf(data_struct *data, char *fileconf) {
     }
   }
 
-  /* If learning data is provided, additional parameters are needed */
-  if (data->learning->learning_provided == TRUE) {
+  /* If learning data is provided or clusters are warm-started, previous weights are needed */
+  if (data->learning->learning_provided == TRUE || data->learning->learning_incremental == TRUE) {
 
     /** filename_open_weight **/
     (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s", "setting", "learning", "filename_open_weight");
@@ -1755,6 +1906,10 @@ load_conf(data_struct *data, char *fileconf) {
       (void) xmlFree(val);
       return -1;
     }
+  }
+
+  /* If learning data is provided, additional parameters are needed */
+  if (data->learning->learning_provided == TRUE) {
 
     /** filename_open_learn **/
     (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s", "setting", "learning", "filename_open_learn");
@@ -1801,35 +1956,107 @@ load_conf(data_struct *data, char *fileconf) {
     if (data->learning->rea->time_s == NULL) alloc_error(__FILE__, __LINE__);
 
     /** filename_obs_eof **/
-    (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s", "setting", "learning", "filename_obs_eof");
-    val = xml_get_setting(conf, path);
-    if (val != NULL) {
-      data->learning->obs->filename_eof = (char *) malloc((xmlStrlen(val)+1) * sizeof(char));
-      if (data->learning->obs->filename_eof == NULL) alloc_error(__FILE__, __LINE__);
-      (void) strcpy(data->learning->obs->filename_eof, (char *) val);
-      (void) fprintf(stdout, "%s: Learning filename_obs_eof = %s\n", __FILE__, data->learning->obs->filename_eof);
-      (void) xmlFree(val);
-    }
-    else {
-      (void) fprintf(stderr, "%s: Missing learning filename_obs_eof setting. Aborting.\n", __FILE__);
-      (void) xmlFree(val);
-      return -1;
+    data->learning->obs->filename_eof = NULL;
+    if (data->learning->eof_compute == FALSE) {
+      (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s", "setting", "learning", "filename_obs_eof");
+      val = xml_get_setting(conf, path);
+      if (val != NULL) {
+        data->learning->obs->filename_eof = (char *) malloc((xmlStrlen(val)+1) * sizeof(char));
+        if (data->learning->obs->filename_eof == NULL) alloc_error(__FILE__, __LINE__);
+        (void) strcpy(data->learning->obs->filename_eof, (char *) val);
+        (void) fprintf(stdout, "%s: Learning filename_obs_eof = %s\n", __FILE__, data->learning->obs->filename_eof);
+        (void) xmlFree(val);
+      }
+      else {
+        (void) fprintf(stderr, "%s: Missing learning filename_obs_eof setting. Aborting.\n", __FILE__);
+        (void) xmlFree(val);
+        return -1;
+      }
     }
 
     /** filename_rea_eof **/
-    (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s", "setting", "learning", "filename_rea_eof");
-    val = xml_get_setting(conf, path);
-    if (val != NULL) {
-      data->learning->rea->filename_eof = (char *) malloc((xmlStrlen(val)+1) * sizeof(char));
-      if (data->learning->rea->filename_eof == NULL) alloc_error(__FILE__, __LINE__);
-      (void) strcpy(data->learning->rea->filename_eof, (char *) val);
-      (void) fprintf(stdout, "%s: Learning filename_rea_eof = %s\n", __FILE__, data->learning->rea->filename_eof);
-      (void) xmlFree(val);
+    data->learning->rea->filename_eof = NULL;
+    if (data->learning->eof_compute == FALSE) {
+      (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s", "setting", "learning", "filename_rea_eof");
+      val = xml_get_setting(conf, path);
+      if (val != NULL) {
+        data->learning->rea->filename_eof = (char *) malloc((xmlStrlen(val)+1) * sizeof(char));
+        if (data->learning->rea->filename_eof == NULL) alloc_error(__FILE__, __LINE__);
+        (void) strcpy(data->learning->rea->filename_eof, (char *) val);
+        (void) fprintf(stdout, "%s: Learning filename_rea_eof = %s\n", __FILE__, data->learning->rea->filename_eof);
+        (void) xmlFree(val);
+      }
+      else {
+        (void) fprintf(stderr, "%s: Missing learning filename_rea_eof setting. Aborting.\n", __FILE__);
+        (void) xmlFree(val);
+        return -1;
+      }
     }
     else {
-      (void) fprintf(stderr, "%s: Missing learning filename_rea_eof setting. Aborting.\n", __FILE__);
-      (void) xmlFree(val);
-      return -1;
+      /** filename_rea_field **/
+      (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s", "setting", "learning", "filename_rea_field");
+      val = xml_get_setting(conf, path);
+      if (val != NULL) {
+        data->learning->filename_rea_field = (char *) malloc((xmlStrlen(val)+1) * sizeof(char));
+        if (data->learning->filename_rea_field == NULL) alloc_error(__FILE__, __LINE__);
+        (void) strcpy(data->learning->filename_rea_field, (char *) val);
+        (void) fprintf(stdout, "%s: Learning filename_rea_field = %s\n", __FILE__, data->learning->filename_rea_field);
+        (void) xmlFree(val);
+      }
+      else {
+        (void) fprintf(stderr, "%s: Missing learning filename_rea_field setting. Aborting.\n", __FILE__);
+        return -1;
+      }
+
+      /** nomvar_rea_field **/
+      (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s", "setting", "learning", "nomvar_rea_field");
+      val = xml_get_setting(conf, path);
+      if (val != NULL) {
+        data->learning->nomvar_rea_field = (char *) malloc((xmlStrlen(val)+1) * sizeof(char));
+        if (data->learning->nomvar_rea_field == NULL) alloc_error(__FILE__, __LINE__);
+        (void) strcpy(data->learning->nomvar_rea_field, (char *) val);
+        (void) xmlFree(val);
+      }
+      else
+        data->learning->nomvar_rea_field = strdup("psl");
+      (void) fprintf(stdout, "%s: Learning nomvar_rea_field = %s\n", __FILE__, data->learning->nomvar_rea_field);
+
+      /** nomvar_obs_field **/
+      (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s", "setting", "learning", "nomvar_obs_field");
+      val = xml_get_setting(conf, path);
+      if (val != NULL) {
+        data->learning->nomvar_obs_field = (char *) malloc((xmlStrlen(val)+1) * sizeof(char));
+        if (data->learning->nomvar_obs_field == NULL) alloc_error(__FILE__, __LINE__);
+        (void) strcpy(data->learning->nomvar_obs_field, (char *) val);
+        (void) xmlFree(val);
+      }
+      else
+        data->learning->nomvar_obs_field = strdup("prr");
+      (void) fprintf(stdout, "%s: Learning nomvar_obs_field = %s\n", __FILE__, data->learning->nomvar_obs_field);
+
+      /** year_begin **/
+      (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s", "setting", "learning", "year_begin");
+      val = xml_get_setting(conf, path);
+      if (val != NULL) {
+        data->learning->year_begin = xmlXPathCastStringToNumber(val);
+        (void) xmlFree(val);
+      }
+      else {
+        (void) fprintf(stderr, "%s: Missing learning year_begin setting. Aborting.\n", __FILE__);
+        return -1;
+      }
+      /** year_end **/
+      (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s", "setting", "learning", "year_end");
+      val = xml_get_setting(conf, path);
+      if (val != NULL) {
+        data->learning->year_end = xmlXPathCastStringToNumber(val);
+        (void) xmlFree(val);
+      }
+      else {
+        (void) fprintf(stderr, "%s: Missing learning year_end setting. Aborting.\n", __FILE__);
+        return -1;
+      }
+      (void) fprintf(stdout, "%s: Learning period for EOFs = %d to %d\n", __FILE__, data->learning->year_begin, data->learning->year_end);
     }
 
     /** filename_rea_sup **/
@@ -2615,8 +2842,14 @@ load_conf(data_struct *data, char *fileconf) {
         
         data->field[i].data[j].field_ls = NULL;
         data->field[i].data[j].field_eof_ls = NULL;
+        data->field[i].data[j].clim_ls = NULL;
         data->field[i].data[j].eof_data->eof_ls = NULL;
         data->field[i].data[j].eof_data->sing_ls = NULL;
+        data->field[i].data[j].eof_info->info->units = NULL;
+        data->field[i].data[j].eof_info->info->height = NULL;
+        data->field[i].data[j].eof_info->info->coordinates = NULL;
+        data->field[i].data[j].eof_info->info->grid_mapping = NULL;
+        data->field[i].data[j].eof_info->info->long_name = NULL;
         data->field[i].data[j].down->mean_dist = NULL;
         data->field[i].data[j].down->var_dist = NULL;
       }
@@ -2910,20 +3143,70 @@ load_conf(data_struct *data, char *fileconf) {
           else
             data->field[cat].data[i].eof_info->eof_coords = strdup("2D");
           
-          /** eof_openfilename **/
-          (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s[@id=\"%d\"]", "setting", catstr, "eof_openfilename", i+1);
+          /** eof_compute **/
+          (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s[@id=\"%d\"]", "setting", catstr, "eof_compute", i+1);
           val = xml_get_setting(conf, path);
-          if (val != NULL) {
-            data->field[cat].data[i].eof_info->eof_filein_ls = (char *) malloc((xmlStrlen(val)+1) * sizeof(char));
-            if (data->field[cat].data[i].eof_info->eof_filein_ls == NULL) alloc_error(__FILE__, __LINE__);
-            (void) strcpy(data->field[cat].data[i].eof_info->eof_filein_ls, (char *) val);
-            (void) fprintf(stdout, "%s: EOF/Singular values input filename #%d = %s\n", __FILE__, i+1,
-                           data->field[cat].data[i].eof_info->eof_filein_ls);
+          if (val != NULL)
+            data->field[cat].data[i].eof_info->eof_compute = (int) strtol((char *) val, (char **)NULL, 10);
+          else
+            data->field[cat].data[i].eof_info->eof_compute = FALSE;
+          if (data->field[cat].data[i].eof_info->eof_compute != FALSE && data->field[cat].data[i].eof_info->eof_compute != TRUE) {
+            (void) fprintf(stderr, "%s: Invalid eof_compute value %s in configuration file. Must be 0 (read) or 1 (use EOFs computed by the learning). Aborting.\n",
+                           __FILE__, val);
+            return -1;
+          }
+          (void) fprintf(stdout, "%s: eof_compute = %d\n", __FILE__, data->field[cat].data[i].eof_info->eof_compute);
+          if (val != NULL)
             (void) xmlFree(val);
+
+          /** eof_openfilename **/
+          data->field[cat].data[i].eof_info->eof_filein_ls = NULL;
+          if (data->field[cat].data[i].eof_info->eof_compute == FALSE) {
+            (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s[@id=\"%d\"]", "setting", catstr, "eof_openfilename", i+1);
+            val = xml_get_setting(conf, path);
+            if (val != NULL) {
+              data->field[cat].data[i].eof_info->eof_filein_ls = (char *) malloc((xmlStrlen(val)+1) * sizeof(char));
+              if (data->field[cat].data[i].eof_info->eof_filein_ls == NULL) alloc_error(__FILE__, __LINE__);
+              (void) strcpy(data->field[cat].data[i].eof_info->eof_filein_ls, (char *) val);
+              (void) fprintf(stdout, "%s: EOF/Singular values input filename #%d = %s\n", __FILE__, i+1,
+                             data->field[cat].data[i].eof_info->eof_filein_ls);
+              (void) xmlFree(val);
+            }
+            else {
+              (void) fprintf(stderr, "%s: Missing eof_openfilename setting. Aborting.\n", __FILE__);
+              return -1;
+            }
           }
-          else {
-            (void) fprintf(stderr, "%s: Missing eof_openfilename setting. Aborting.\n", __FILE__);
-            return -1;
+
+          /** eof_save **/
+          data->field[cat].data[i].eof_info->eof_save = FALSE;
+          data->field[cat].data[i].eof_info->eof_fileout_ls = NULL;
+          if (data->field[cat].data[i].eof_info->eof_compute != FALSE) {
+            (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s[@id=\"%d\"]", "setting", catstr, "eof_save", i+1);
+            val = xml_get_setting(conf, path);
+            if (val != NULL) {
+              if ( !xmlStrcmp(val, (xmlChar *) "1") )
+                data->field[cat].data[i].eof_info->eof_save = TRUE;
+              (void) fprintf(stdout, "%s: eof_save #%d = %d\n", __FILE__, i+1, data->field[cat].data[i].eof_info->eof_save);
+              (void) xmlFree(val);
+            }
+            /* If we want to save computed EOF in output file */
+            if (data->field[cat].data[i].eof_info->eof_save == TRUE) {
+              (void) sprintf(path, "/configuration/%s[@name=\"%s\"]/%s[@id=\"%d\"]", "setting", catstr, "eof_savefilename", i+1);
+              val = xml_get_setting(conf, path);
+              if (val != NULL) {
+                data->field[cat].data[i].eof_info->eof_fileout_ls = (char *) malloc((xmlStrlen(val)+1) * sizeof(char));
+                if (data->field[cat].data[i].eof_info->eof_fileout_ls == NULL) alloc_error(__FILE__, __LINE__);
+                (void) strcpy(data->field[cat].data[i].eof_info->eof_fileout_ls, (char *) val);
+                (void) fprintf(stdout, "%s: EOF/Singular values output filename #%d = %s\n", __FILE__, i+1,
+                               data->field[cat].data[i].eof_info->eof_fileout_ls);
+                (void) xmlFree(val);
+              }
+              else {
+                (void) fprintf(stderr, "%s: Missing eof_savefilename setting %s. Aborting.\n", __FILE__, catstrt);
+                return -1;
+              }
+            }
           }
 
           /** eof_scale **/
@@ -2988,6 +3271,34 @@ load_conf(data_struct *data, char *fileconf) {
     (void) free(catstrt);
   }
 
+  /* Control and model large-scale fields must be projected the same way */
+  for (i=0; i<data->field[FIELD_LS].n_ls && i<data->field[CTRL_FIELD_LS].n_ls; i++)
+    if (data->field[FIELD_LS].data[i].eof_info->eof_project != data->field[CTRL_FIELD_LS].data[i].eof_info->eof_project ||
+        (data->field[FIELD_LS].data[i].eof_info->eof_project == TRUE &&
+         (data->field[FIELD_LS].data[i].eof_info->eof_compute != data->field[CTRL_FIELD_LS].data[i].eof_info->eof_compute ||
+          data->field[FIELD_LS].data[i].eof_info->neof_ls != data->field[CTRL_FIELD_LS].data[i].eof_info->neof_ls))) {
+      (void) fprintf(stderr, "%s: Large-scale field #%d: eof_project, eof_compute and number_of_eofs must be the same for the model and control-run fields. Aborting.\n",
+                     __FILE__, i+1);
+      return -1;
+    }
+
+  /* The learning principal components and clusters are expressed in the EOF basis of the reanalysis field of the learning:
+     large-scale fields must be projected onto the EOFs computed by the learning when it computes them, and only then */
+  for (cat=FIELD_LS; cat<=CTRL_FIELD_LS; cat++)
+    for (i=0; i<data->field[cat].n_ls; i++)
+      if (data->field[cat].data[i].eof_info->eof_project == TRUE) {
+        if (data->field[cat].data[i].eof_info->eof_compute == TRUE && data->learning->eof_compute == FALSE) {
+          (void) fprintf(stderr, "%s: Large-scale field #%d: eof_compute = 1 needs the learning to compute EOFs (learning_provided = 0 and learning eof_compute != 0). Use eof_compute = 0 with eof_openfilename. Aborting.\n",
+                         __FILE__, i+1);
+          return -1;
+        }
+        if (data->field[cat].data[i].eof_info->eof_compute == FALSE && data->learning->eof_compute != FALSE) {
+          (void) fprintf(stderr, "%s: Large-scale field #%d: eof_compute = 1 is needed when the learning computes EOFs, so that the field is projected onto the same EOFs. Aborting.\n",
+                         __FILE__, i+1);
+          return -1;
+        }
+      }
+
 
   /**** CONTROL-RUN PERIOD CONFIGURATION ****/
 
@@ -3411,28 +3722,56 @@ load_conf(data_struct *data, char *fileconf) {
   (void) fprintf(stdout, "%s: analog data output_only=%d\n", __FILE__, data->conf->output_only);
   if (val != NULL) 
     (void) xmlFree(val);
-  if (data->conf->output_only == TRUE) {
-    if (data->learning->learning_provided == FALSE) {
-      (void) fprintf(stderr, "%s: WARNING: Desactivating learning process because option for output only has been set!\n", __FILE__);
-      data->learning->learning_provided = TRUE;
-    }
-    if (data->learning->learning_save == TRUE) {
-      (void) fprintf(stderr, "%s: WARNING: Desactivating learning save process because option for output only has been set!\n", __FILE__);
-      data->learning->learning_save = FALSE;
-    }
-    if (data->conf->learning_maskfile->use_mask == TRUE) {
-      (void) fprintf(stderr, "%s: WARNING: Desactivating use_mask for learning because option for output only has been set!\n", __FILE__);
-      data->conf->learning_maskfile->use_mask = FALSE;
-    }
-    if (data->reg->reg_save == TRUE) {
-      (void) fprintf(stderr, "%s: WARNING: Desactivating regression save process because option for output only has been set!\n", __FILE__);
-      data->reg->reg_save = FALSE;
+
+  /** checkpoint_path **/
+  data->conf->checkpoint_path = NULL;
+  data->conf->checkpoint_hash = NULL;
+  data->conf->checkpoint_stage = CHECKPOINT_NONE;
+  for (cat=0; cat<NCAT; cat++)
+    data->conf->checkpoint_year[cat] = -1;
+  (void) sprintf(path, "/configuration/%s[@name=\"%s\"]", "setting", "checkpoint_path");
+  val = xml_get_setting(conf, path);
+  if (val != NULL) {
+    if (data->conf->output_only == TRUE)
+      (void) fprintf(stderr, "%s: WARNING: Checkpoints are not used because option for output only has been set!\n", __FILE__);
+    else {
+      data->conf->checkpoint_path = (char *) malloc((xmlStrlen(val)+1) * sizeof(char));
+      if (data->conf->checkpoint_path == NULL) alloc_error(__FILE__, __LINE__);
+      (void) strcpy(data->conf->checkpoint_path, (char *) val);
+      (void) fprintf(stdout, "%s: checkpoint_path = %s\n", __FILE__, data->conf->checkpoint_path);
+      /* Find where a previous interrupted run with the same configuration and input files stopped */
+      istat = checkpoint_hash(data);
+      if (istat != 0) return istat;
+      istat = read_checkpoint_state(data);
+      if (istat != 0) return istat;
     }
-    if (data->secondary_mask->use_mask == TRUE) {
-      (void) fprintf(stderr, "%s: WARNING: Desactivating use_mask for secondary large-scale fields because option for output only has been set!\n", __FILE__);
-      data->secondary_mask->use_mask = FALSE;
+    (void) xmlFree(val);
+  }
+
+  /** cache_path **/
+  data->conf->cache_path = NULL;
+  (void) sprintf(path, "/configuration/%s[@name=\"%s\"]", "setting", "cache_path");
+  val = xml_get_setting(conf, path);
+  if (val != NULL) {
+    if (data->conf->output_only == TRUE)
+      (void) fprintf(stderr, "%s: WARNING: Cache is not used because option for output only has been set!\n", __FILE__);
+    else {
+      data->conf->cache_path = (char *) malloc((xmlStrlen(val)+1) * sizeof(char));
+      if (data->conf->cache_path == NULL) alloc_error(__FILE__, __LINE__);
+      (void) strcpy(data->conf->cache_path, (char *) val);
+      (void) fprintf(stdout, "%s: cache_path = %s\n", __FILE__, data->conf->cache_path);
+      if (mkdir(data->conf->cache_path, 0755) != 0 && errno != EEXIST) {
+        (void) fprintf(stderr, "%s: Cannot create cache directory %s: %s\n", __FILE__, data->conf->cache_path, strerror(errno));
+        return -1;
+      }
+      /* Keys of cached intermediate products for this configuration and these input files */
+      istat = cache_hash(data);
+      if (istat != 0) return istat;
     }
+    (void) xmlFree(val);
   }
+  if (data->conf->output_only == TRUE)
+    (void) set_output_only(data);
 
   /** output **/
   (void) sprintf(path, "/configuration/%s[@name=\"%s\"]", "setting", "output_downscaling_data");
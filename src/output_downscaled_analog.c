@@ -61,7 +61,8 @@ output_downscaled_analog(analog_day_struct analog_days, double *delta, int outpu
                          double deltat, int file_format, int file_compression, int file_compression_level,
                          int debug,
                          info_struct *info, var_struct *obs_var, period_struct *period,
-                         double *time_ls, int ntime) {
+                         double *time_ls, int ntime, int year_done, char *year_file, char *checkpoint_hash,
+                         int perf_attribute, int prefetch_obs) {
   /**
      @param[in]   analog_days            Analog days time indexes and dates with corresponding dates being downscaled.
      @param[in]   delta                  Temperature difference to apply to analog day data
@@ -80,6 +81,11 @@ output_downscaled_analog(analog_day_struct analog_days, double *delta, int outpu
      @param[in]   period                 Period structure for downscaling output
      @param[in]   time_ls                Time values
      @param[in]   ntime                  Number of times dimension
+     @param[in]   year_done              Last output year completely written by a previous interrupted run (-1 if none)
+     @param[in]   year_file              Checkpoint filename recording the last output year completely written (NULL if not used)
+     @param[in]   checkpoint_hash        Hash of configuration and input files validating checkpoint files
+     @param[in]   perf_attribute         Write the performance report of downscaling stages as a global attribute of output files (TRUE or FALSE)
+     @param[in]   prefetch_obs           Read ahead the whole observation files of the next analog date in other files (TRUE or FALSE)
   */
   
   char **infile = NULL; /* Input filename */
@@ -116,10 +122,13 @@ output_downscaled_analog(analog_day_struct analog_days, double *delta, int outpu
   info_field_struct **info_tmp = NULL; /* Temporary field information structure */
   proj_struct *proj_tmp = NULL; /* Temporary field projection structure */
 
-  int tmpi; /* Temporay integer value */
   double curtas; /* Current temperature value */
   double newcurtas; /* New current temperature value */
   char *format = NULL; /* Temporay format string */
+  char **prefile = NULL; /* Input filenames of the next analog date to prefetch */
+  char *lastprefile = NULL; /* Last prefetched input filename */
+  int tprefetch = 0; /* Time index of the next analog date to prefetch */
+  int year_last = -1; /* Output year currently being written */
 
   int varid_tas; /* Variable index ID */
   int varid_tasmax; /* Variable index ID */
@@ -149,6 +158,7 @@ output_downscaled_analog(analog_day_struct analog_days, double *delta, int outpu
   int f; /* Loop counter for files */
   int i; /* Loop counter */
   int j; /* Loop counter */
+  int perf; /* Performance measurement stage */
 
   double curtime;
 
@@ -211,6 +221,19 @@ output_downscaled_analog(analog_day_struct analog_days, double *delta, int outpu
   }
   format = (char *) malloc(MAXPATH * sizeof(char));
   if (format == NULL) alloc_error(__FILE__, __LINE__);
+  prefile = (char **) malloc(obs_var->nobs_var * sizeof(char *));
+  if (prefile == NULL) alloc_error(__FILE__, __LINE__);
+  for (var=0; var<obs_var->nobs_var; var++) {
+    prefile[var] = (char *) malloc(MAXPATH * sizeof(char));
+    if (prefile[var] == NULL) alloc_error(__FILE__, __LINE__);
+  }
+  lastprefile = (char *) malloc(MAXPATH * sizeof(char));
+  if (lastprefile == NULL) alloc_error(__FILE__, __LINE__);
+  (void) strcpy(lastprefile, "");
+
+  /* Input filename format */
+  (void) strcpy(format, "%s/%s/");
+  (void) strcat(format, obs_var->template);
 
   if (output_month_begin == 1)
     output_month_end = 12;
@@ -280,6 +303,16 @@ output_downscaled_analog(analog_day_struct analog_days, double *delta, int outpu
         year2 = year1 + 1;
       else
         year2 = year1;
+
+      /* Output years completely written by a previous interrupted run are skipped */
+      if (year1 <= year_done)
+        continue;
+      /* A new output year begins: the previous one is completely written */
+      if (year1 != year_last) {
+        if (year_last != -1 && year_file != NULL)
+          (void) write_checkpoint_state(year_file, checkpoint_hash, "year", year_last);
+        year_last = year1;
+      }
       /* Process each variable and create output filenames, and output files if necessary */
       for (var=0; var<obs_var->nobs_var; var++) {
         /* Example: evapn_1d_19790801_19800731.nc */
@@ -387,49 +420,28 @@ output_downscaled_analog(analog_day_struct analog_days, double *delta, int outpu
       }
           
       /* Create input filename for reading data */
-      (void) strcpy(format, "%s/%s/");
-      (void) strcat(format, obs_var->template);
-      if (obs_var->month_begin != 1) {
-        /* Months in observation files *does not* begin in January: must have 2 years in filename */
-        if (analog_days.month[t] < obs_var->month_begin)
-          year1 = analog_days.year[t] - 1;
-        else
-          year1 = analog_days.year[t];
-        year2 = year1 + 1;
-        if (obs_var->year_digits == 4)
-          /* Process each variable and create input filenames */
-          for (var=0; var<obs_var->nobs_var; var++)
-            (void) sprintf(infile[var], format, obs_var->path, obs_var->frequency,
-                           obs_var->acronym[var], year1, year2);
-        else {
-          tmpi = year1 / 100;
-          year1 = year1 - (tmpi*100);
-          tmpi = year2 / 100;
-          year2 = year2 - (tmpi*100);
-          /* Process each variable and create input filenames */
-          for (var=0; var<obs_var->nobs_var; var++)
-            (void) sprintf(infile[var], format, obs_var->path, obs_var->frequency,
-                           obs_var->acronym[var], year1, year2);
+      (void) build_obs_filenames(infile, format, obs_var, analog_days.year[t], analog_days.month[t]);
+
+      /* Analog dates to output are known in advance: once the current input files are reached, */
+      /* find the next analog date located in other files and ask the kernel to read them ahead. */
+      /* Whole files are read while only one timestep is needed: only worth it on slow storage. */
+      if (prefetch_obs == TRUE && t >= tprefetch) {
+        tprefetch = t + 1;
+        while (tprefetch < ntime) {
+          if (time_ls[tprefetch] >= period_begin && time_ls[tprefetch] <= period_end) {
+            (void) build_obs_filenames(prefile, format, obs_var, analog_days.year[tprefetch], analog_days.month[tprefetch]);
+            if ( strcmp(prefile[0], infile[0]) )
+              break;
+          }
+          tprefetch++;
         }
-      }
-      else {
-        /* Months in observation files begins in January: must have 1 year in filename */
-        year1 = analog_days.year[t];
-        if (obs_var->year_digits == 4)
-          /* Process each variable and create input filenames */
+        if (tprefetch < ntime && strcmp(prefile[0], lastprefile) ) {
           for (var=0; var<obs_var->nobs_var; var++)
-            (void) sprintf(infile[var], format, obs_var->path, obs_var->frequency,
-                           obs_var->acronym[var], year1);
-        else {
-          tmpi = year1 / 100;
-          year1 = year1 - (tmpi*100);
-          /* Process each variable and create input filenames */
-          for (var=0; var<obs_var->nobs_var; var++) 
-            (void) sprintf(infile[var], format, obs_var->path, obs_var->frequency,
-                           obs_var->acronym[var], year1);
+            (void) prefetch_file(prefile[var]);
+          (void) strcpy(lastprefile, prefile[0]);
         }
       }
-      
+
       /* Get time information for first input observation file and assume all files are alike */
       time_s = (time_vect_struct *) malloc(sizeof(time_vect_struct));
       if (time_s == NULL) alloc_error(__FILE__, __LINE__);
@@ -517,6 +529,7 @@ output_downscaled_analog(analog_day_struct analog_days, double *delta, int outpu
           proj_tmp->grid_mapping_name = NULL;
           
           /* Process each variable and read data */
+          perf = perf_begin("read_observations");
           for (var=0; var<obs_var->nobs_var; var++) {
             info_tmp[var] = (info_field_struct *) malloc(sizeof(info_field_struct));
             if (info_tmp[var] == NULL) alloc_error(__FILE__, __LINE__);
@@ -560,6 +573,7 @@ output_downscaled_analog(analog_day_struct analog_days, double *delta, int outpu
               info_tmp[var]->long_name = strdup(obs_var->name[var]);
             }              
           }
+          (void) perf_end(perf);
 
           if (obs_var->proj->name == NULL) {
             /* Retrieve observation grid parameters if not done already */
@@ -860,6 +874,7 @@ output_downscaled_analog(analog_day_struct analog_days, double *delta, int outpu
             curtime = time_ls[t];
 
           /* Process each variable */
+          perf = perf_begin("write_output");
           for (var=0; var<obs_var->nobs_var; var++) {
             if (buf[var] != NULL && !strcmp(obs_var->output[var], "yes")) {
               if ( !strcmp(info->timestep, obs_var->frequency) ) {
@@ -969,6 +984,7 @@ output_downscaled_analog(analog_day_struct analog_days, double *delta, int outpu
             (void) free(info_tmp[var]->long_name);
             (void) free(info_tmp[var]);
           }
+          (void) perf_end(perf);
 
           /* Free allocated memory */
           (void) free(proj_tmp->name);
@@ -1056,6 +1072,16 @@ output_downscaled_analog(analog_day_struct analog_days, double *delta, int outpu
     }
   }
   
+  /* Last output year is completely written */
+  if (year_last != -1 && year_file != NULL)
+    (void) write_checkpoint_state(year_file, checkpoint_hash, "year", year_last);
+
+  /* Record performance of downscaling stages so far in output files */
+  if (perf_attribute == TRUE)
+    for (var=0; var<obs_var->nobs_var; var++)
+      for (f=0; f<noutf[var]; f++)
+        (void) write_perf_attribute(outfiles[var][f]);
+
   /* Free allocated memory */
   for (var=0; var<obs_var->nobs_var; var++) {
     for (f=0; f<noutf[var]; f++)
@@ -1083,6 +1109,10 @@ output_downscaled_analog(analog_day_struct analog_days, double *delta, int outpu
   (void) free(infile);
   (void) free(outfile);
   (void) free(format);
+  for (var=0; var<obs_var->nobs_var; var++)
+    (void) free(prefile[var]);
+  (void) free(prefile);
+  (void) free(lastprefile);
   
   (void) ut_free(dataunits);
   (void) ut_free_system(unitSystem);  
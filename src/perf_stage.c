@@ -0,0 +1,259 @@
+/* ***************************************************** */
+/* perf_stage Performance of downscaling stages.         */
+/* perf_stage.c                                          */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file perf_stage.c
+    \brief Performance measurements of downscaling stages: time, memory and NetCDF data volume.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+/** Maximum length of the report line of one stage. */
+#define PERF_LINE 400
+
+/* Stages measured since the start of the process or the last reset */
+static perf_stage_struct *perf_stage = NULL;
+/* Number of stages */
+static int perf_nstages = 0;
+/* Stage currently running, enclosing the stages begun next (-1 if none) */
+static int perf_current = -1;
+/* If the origin of the measurements has been set */
+static int perf_started = FALSE;
+/* Wall-clock time at the origin of the measurements */
+static double perf_wall0 = 0.0;
+/* CPU time at the origin of the measurements */
+static double perf_cpu0 = 0.0;
+
+static void perf_sample(double *wall, double *cpu, long *maxrss);
+
+/** Sample wall-clock time, CPU time and peak resident set size of the process. */
+static void
+perf_sample(double *wall, double *cpu, long *maxrss) {
+  /**
+     @param[out]  wall       Wall-clock time in seconds.
+     @param[out]  cpu        User and system CPU time of all threads in seconds.
+     @param[out]  maxrss     Peak resident set size in kilobytes (0 if not available).
+  */
+
+#ifdef HAVE_SYS_TIME_H
+  struct timeval tv; /* Time of day */
+#endif
+#ifdef HAVE_SYS_RESOURCE_H
+  struct rusage usage; /* Resource usage of the process */
+#endif
+
+#ifdef HAVE_SYS_TIME_H
+  (void) gettimeofday(&tv, NULL);
+  *wall = (double) tv.tv_sec + (double) tv.tv_usec * 1.0e-6;
+#else
+  *wall = (double) time(NULL);
+#endif
+
+#ifdef HAVE_SYS_RESOURCE_H
+  (void) getrusage(RUSAGE_SELF, &usage);
+  *cpu = (double) usage.ru_utime.tv_sec + (double) usage.ru_utime.tv_usec * 1.0e-6 +
+    (double) usage.ru_stime.tv_sec + (double) usage.ru_stime.tv_usec * 1.0e-6;
+  *maxrss = (long) usage.ru_maxrss;
+#else
+  *cpu = (double) clock() / (double) CLOCKS_PER_SEC;
+  *maxrss = 0;
+#endif
+}
+
+/** Begin measuring a stage. A stage begun while another one is running is nested in it, and measuring again a stage
+    with the same name in the same enclosing stage accumulates the measurements. */
+int
+perf_begin(char *name) {
+  /**
+     @param[in]  name       Stage name.
+
+     \return                Stage index, to give to perf_end.
+  */
+
+  int stage; /* Stage index */
+
+  if (perf_started == FALSE)
+    (void) perf_reset();
+
+  for (stage=0; stage<perf_nstages; stage++)
+    if (perf_stage[stage].parent == perf_current && !strcmp(perf_stage[stage].name, name))
+      break;
+
+  if (stage == perf_nstages) {
+    perf_stage = (perf_stage_struct *) realloc(perf_stage, (perf_nstages+1) * sizeof(perf_stage_struct));
+    if (perf_stage == NULL) alloc_error(__FILE__, __LINE__);
+    perf_stage[stage].name = strdup(name);
+    perf_stage[stage].parent = perf_current;
+    perf_stage[stage].level = (perf_current < 0) ? 0 : perf_stage[perf_current].level + 1;
+    perf_stage[stage].ncalls = 0;
+    perf_stage[stage].wall = 0.0;
+    perf_stage[stage].cpu = 0.0;
+    perf_stage[stage].maxrss = 0;
+    perf_stage[stage].maxrss_incr = 0;
+    perf_stage[stage].nread = 0;
+    perf_stage[stage].nwritten = 0;
+    perf_nstages++;
+  }
+
+  (void) perf_sample(&(perf_stage[stage].wall_begin), &(perf_stage[stage].cpu_begin), &(perf_stage[stage].maxrss_begin));
+  (void) io_stats_get(&(perf_stage[stage].nread_begin), &(perf_stage[stage].nwritten_begin));
+  perf_current = stage;
+
+  return stage;
+}
+
+/** End measuring a stage and accumulate its measurements. */
+void
+perf_end(int stage) {
+  /**
+     @param[in]  stage      Stage index returned by perf_begin.
+  */
+
+  double wall; /* Wall-clock time */
+  double cpu; /* CPU time */
+  long maxrss; /* Peak resident set size */
+  unsigned long long nread; /* Bytes read from NetCDF files */
+  unsigned long long nwritten; /* Bytes written to NetCDF files */
+
+  if (stage < 0 || stage >= perf_nstages)
+    return;
+
+  (void) perf_sample(&wall, &cpu, &maxrss);
+  (void) io_stats_get(&nread, &nwritten);
+
+  perf_stage[stage].ncalls++;
+  perf_stage[stage].wall += wall - perf_stage[stage].wall_begin;
+  perf_stage[stage].cpu += cpu - perf_stage[stage].cpu_begin;
+  perf_stage[stage].maxrss = maxrss;
+  perf_stage[stage].maxrss_incr += maxrss - perf_stage[stage].maxrss_begin;
+  perf_stage[stage].nread += nread - perf_stage[stage].nread_begin;
+  perf_stage[stage].nwritten += nwritten - perf_stage[stage].nwritten_begin;
+
+  perf_current = perf_stage[stage].parent;
+}
+
+/** Build the performance report of the stages measured so far, in JSON format. */
+char *
+perf_report(void) {
+  /**
+     \return                Report text, to free by the caller.
+  */
+
+  char *report = NULL; /* Report text */
+  size_t len = 0; /* Length of report text */
+  double wall; /* Wall-clock time */
+  double cpu; /* CPU time */
+  long maxrss; /* Peak resident set size */
+  unsigned long long nread; /* Bytes read from NetCDF files */
+  unsigned long long nwritten; /* Bytes written to NetCDF files */
+  int stage; /* Loop counter for stages */
+
+  if (perf_started == FALSE)
+    (void) perf_reset();
+
+  (void) perf_sample(&wall, &cpu, &maxrss);
+  (void) io_stats_get(&nread, &nwritten);
+
+  report = (char *) malloc((perf_nstages+4) * PERF_LINE * sizeof(char));
+  if (report == NULL) alloc_error(__FILE__, __LINE__);
+
+  len += sprintf(report+len, "{\n  \"program\": \"%s\",\n  \"version\": \"%s\",\n", PACKAGE_NAME, PACKAGE_VERSION);
+  len += sprintf(report+len, "  \"total\": { \"wall_s\": %.6f, \"cpu_s\": %.6f, \"max_rss_kb\": %ld, "
+                 "\"bytes_read\": %llu, \"bytes_written\": %llu },\n",
+                 wall - perf_wall0, cpu - perf_cpu0, maxrss, nread, nwritten);
+  len += sprintf(report+len, "  \"stages\": [");
+  for (stage=0; stage<perf_nstages; stage++) {
+    len += sprintf(report+len, "%s\n    { \"name\": \"%.100s\", ", (stage == 0) ? "" : ",", perf_stage[stage].name);
+    if (perf_stage[stage].parent < 0)
+      len += sprintf(report+len, "\"parent\": null, ");
+    else
+      len += sprintf(report+len, "\"parent\": \"%.100s\", ", perf_stage[perf_stage[stage].parent].name);
+    len += sprintf(report+len, "\"level\": %d, \"calls\": %d, \"wall_s\": %.6f, \"cpu_s\": %.6f, "
+                   "\"max_rss_kb\": %ld, \"max_rss_increase_kb\": %ld, \"bytes_read\": %llu, \"bytes_written\": %llu }",
+                   perf_stage[stage].level, perf_stage[stage].ncalls, perf_stage[stage].wall, perf_stage[stage].cpu,
+                   perf_stage[stage].maxrss, perf_stage[stage].maxrss_incr, perf_stage[stage].nread, perf_stage[stage].nwritten);
+  }
+  len += sprintf(report+len, "\n  ]\n}\n");
+
+  return report;
+}
+
+/** Reset the performance measurements: forget measured stages and set the origin of the measurements to now. */
+void
+perf_reset(void) {
+
+  long maxrss; /* Peak resident set size */
+
+  (void) perf_free();
+  (void) perf_sample(&perf_wall0, &perf_cpu0, &maxrss);
+  (void) io_stats_reset();
+  perf_started = TRUE;
+}
+
+/** Free memory of performance measurements. */
+void
+perf_free(void) {
+
+  int stage; /* Loop counter for stages */
+
+  for (stage=0; stage<perf_nstages; stage++)
+    (void) free(perf_stage[stage].name);
+  if (perf_stage != NULL)
+    (void) free(perf_stage);
+  perf_stage = NULL;
+  perf_nstages = 0;
+  perf_current = -1;
+}
@@ -0,0 +1,258 @@
+/* ***************************************************** */
+/* project_large_scale_field_stream Project a            */
+/* large-scale field on EOF reading it by                */
+/* time chunks.                                          */
+/* project_large_scale_field_stream.c                    */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file project_large_scale_field_stream.c
+    \brief Project a large-scale field on EOF reading it by time chunks.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+/** Project a large-scale field onto EOF, reading input files by chunks of stream_chunk timesteps
+    and removing the control-run climatology chunk by chunk, so that the whole field is never kept in memory. */
+int
+project_large_scale_field_stream(data_struct *data, int cat, int i) {
+  /**
+     @param[in]  data  MASTER data structure.
+     @param[in]  cat   Large-scale field category.
+     @param[in]  i     Large-scale field index.
+     
+     \return           Status.
+  */
+
+  int istat; /* Diagnostic status */
+  int t; /* Time loop counter */
+  int j; /* Loop counter for grid points */
+  int f; /* Loop counter for files */
+  int eof; /* Loop counter for EOFs */
+  double *buf = NULL; /* Chunk of field over whole domain */
+  double *bufsub = NULL; /* Chunk of field over subdomain */
+  double *bufnoclim = NULL; /* Chunk of field over subdomain with climatology removed */
+  double *bufproj = NULL; /* Chunk of field projected onto EOF */
+  double *eofmat = NULL; /* Packed matrix of normalized EOF values on valid points */
+  int *pts = NULL; /* Grid point index of each packed point */
+  int npts; /* Number of packed valid points */
+  double *time_ls = NULL; /* Time information buffer of input file */
+  double *lat = NULL; /* Latitude buffer */
+  double *lon = NULL; /* Longitude buffer */
+  double *lat_sub = NULL; /* Latitude buffer for subdomain */
+  double *lon_sub = NULL; /* Longitude buffer for subdomain */
+  char *cal_type = NULL; /* Calendar type (udunits) */
+  char *time_units = NULL; /* Time units (udunits) */
+  char **filelist = NULL; /* List of input files for the field */
+  tstruct *timein_ts = NULL; /* Time info of chunk */
+  int nfiles; /* Number of input files */
+  int nlon; /* Longitude dimension */
+  int nlat; /* Latitude dimension */
+  int ntime; /* Time dimension of input file */
+  int nlon_file; /* Longitude dimension when reading chunk */
+  int nlat_file; /* Latitude dimension when reading chunk */
+  int ntime_file; /* Time dimension when reading chunk */
+  int nlon_sub; /* Longitude dimension of subdomain */
+  int nlat_sub; /* Latitude dimension of subdomain */
+  int tfile; /* First timestep of chunk in input file */
+  int nt; /* Number of timesteps in chunk */
+  int toff = 0; /* First timestep of chunk in whole field */
+  int neof; /* Number of EOFs */
+
+  neof = data->field[cat].data[i].eof_info->neof_ls;
+
+  /* Get list of input files */
+  istat = get_file_list(&filelist, &nfiles, data->field[cat].data[i].filename_ls);
+  if (istat < 0)
+    return istat;
+
+  /* Normalize EOFs once for all chunks */
+  istat = pack_eof_proj(&eofmat, &pts, &npts, data->field[cat].data[i].eof_data->eof_ls, data->field[cat].data[i].eof_data->sing_ls,
+                        data->field[cat].data[i].eof_info->info->fillvalue, data->field[cat].data[i].eof_info->eof_scale,
+                        data->field[cat].nlon_eof_ls, data->field[cat].nlat_eof_ls, neof);
+  if (istat != 0) {
+    for (f=0; f<nfiles; f++)
+      (void) free(filelist[f]);
+    (void) free(filelist);
+    return istat;
+  }
+
+  bufproj = (double *) malloc(neof * data->conf->stream_chunk * sizeof(double));
+  if (bufproj == NULL) alloc_error(__FILE__, __LINE__);
+  timein_ts = (tstruct *) malloc(data->conf->stream_chunk * sizeof(tstruct));
+  if (timein_ts == NULL) alloc_error(__FILE__, __LINE__);
+
+  for (f=0; f<nfiles && istat == 0; f++) {
+
+    /* Retrieve dimensions to extract subdomain */
+    istat = read_netcdf_dims_3d(&lon, &lat, &time_ls, &cal_type, &time_units, &nlon, &nlat, &ntime,
+                                data->info, data->field[cat].proj[i].coords, data->field[cat].proj[i].name,
+                                data->field[cat].data[i].lonname, data->field[cat].data[i].latname,
+                                data->field[cat].data[i].dimxname, data->field[cat].data[i].dimyname,
+                                data->field[cat].data[i].timename,
+                                filelist[f]);
+    (void) free(time_ls);
+    (void) free(cal_type);
+    (void) free(time_units);
+    time_ls = NULL;
+    cal_type = NULL;
+    time_units = NULL;
+    if (istat < 0) break;
+    istat = 0;
+
+    /* Process input file by chunks */
+    for (tfile=0; tfile<ntime && istat == 0; tfile+=nt) {
+      nt = (tfile+data->conf->stream_chunk <= ntime) ? data->conf->stream_chunk : (ntime-tfile);
+      if (toff+nt > data->field[cat].ntime_ls) {
+        (void) fprintf(stderr, "%s: Problems in time dimension! Input files of %s have more times than expected: %d.\n", __FILE__,
+                       data->field[cat].data[i].nomvar_ls, data->field[cat].ntime_ls);
+        istat = -1;
+        break;
+      }
+
+      /* Read chunk */
+      istat = read_netcdf_var_3d_chunk(&buf, filelist[f], data->field[cat].data[i].nomvar_ls,
+                                       data->field[cat].data[i].dimxname, data->field[cat].data[i].dimyname,
+                                       data->field[cat].data[i].timename, tfile, nt, &nlon_file, &nlat_file, &ntime_file, FALSE);
+      if (istat != 0) break;
+
+      /* Extraction of subdomain */
+      (void) extract_subdomain(&bufsub, &lon_sub, &lat_sub, &nlon_sub, &nlat_sub, buf, lon, lat,
+                               data->conf->longitude_min, data->conf->longitude_max, data->conf->latitude_min, data->conf->latitude_max,
+                               nlon, nlat, nt);
+      (void) free(buf);
+      buf = NULL;
+      if (nlon_sub != data->field[cat].nlon_ls || nlat_sub != data->field[cat].nlat_ls) {
+        (void) fprintf(stderr, "%s: Problems in dimensions! nlat=%d nlat_file=%d nlon=%d nlon_file=%d\n",
+                       __FILE__, data->field[cat].nlat_ls, nlat_sub, data->field[cat].nlon_ls, nlon_sub);
+        istat = -1;
+      }
+      for (j=0; j<nlon_sub*nlat_sub && istat == 0; j++)
+        if (fabs(lon_sub[j] - data->field[cat].lon_ls[j]) > COORD_TOLERANCE ||
+            fabs(lat_sub[j] - data->field[cat].lat_ls[j]) > COORD_TOLERANCE) {
+          (void) fprintf(stderr, "%s: ERROR: Input file %s is not on the same grid as the first input file. Files must have the same grid.\n",
+                         __FILE__, filelist[f]);
+          istat = -1;
+        }
+      (void) free(lon_sub);
+      (void) free(lat_sub);
+      if (istat != 0) {
+        (void) free(bufsub);
+        bufsub = NULL;
+        break;
+      }
+
+      /* Remove control-run climatology */
+      if (data->field[cat].data[i].clim_ls != NULL) {
+        istat = get_calendar_ts(timein_ts, data->conf->time_units, &(data->field[cat].time_ls[toff]), nt);
+        if (istat < 0) {
+          (void) free(bufsub);
+          bufsub = NULL;
+          break;
+        }
+        istat = 0;
+        bufnoclim = (double *) malloc(nlon_sub * nlat_sub * nt * sizeof(double));
+        if (bufnoclim == NULL) alloc_error(__FILE__, __LINE__);
+        (void) remove_seasonal_cycle(bufnoclim, data->field[cat].data[i].clim_ls, bufsub, timein_ts,
+                                     data->field[cat].data[i].info->fillvalue,
+                                     data->conf->clim_filter_width, data->conf->clim_filter_type,
+                                     TRUE, nlon_sub, nlat_sub, nt);
+        (void) free(bufsub);
+        bufsub = bufnoclim;
+        bufnoclim = NULL;
+      }
+
+      /* Project chunk onto EOF */
+      (void) project_packed_eof(bufproj, bufsub, eofmat, pts, npts, data->field[cat].nlon_eof_ls, data->field[cat].nlat_eof_ls, nt, neof);
+      (void) free(bufsub);
+      bufsub = NULL;
+
+      /* Copy into (neof x ntime) projected field */
+      for (eof=0; eof<neof; eof++)
+        for (t=0; t<nt; t++)
+          data->field[cat].data[i].field_eof_ls[(toff+t)+eof*data->field[cat].ntime_ls] = bufproj[t+eof*nt];
+      toff += nt;
+    }
+
+    (void) free(lon);
+    (void) free(lat);
+    lon = NULL;
+    lat = NULL;
+  }
+
+  if (istat == 0 && toff != data->field[cat].ntime_ls) {
+    (void) fprintf(stderr, "%s: Problems in time dimension! Projected %d times of %s, expected %d.\n", __FILE__, toff,
+                   data->field[cat].data[i].nomvar_ls, data->field[cat].ntime_ls);
+    istat = -1;
+  }
+
+  /* Verify variance of the whole projected field */
+  if (istat == 0)
+    istat = verify_proj_eof_variance(data->field[cat].data[i].field_eof_ls, NULL, data->field[cat].data[i].eof_data->sing_ls,
+                                     data->field[cat].ntime_ls, neof);
+
+  /* Free memory */
+  (void) free(lon);
+  (void) free(lat);
+  (void) free(bufproj);
+  (void) free(eofmat);
+  (void) free(pts);
+  (void) free(timein_ts);
+  for (f=0; f<nfiles; f++)
+    (void) free(filelist[f]);
+  (void) free(filelist);
+
+  /* Diagnostic status */
+  return istat;
+}
@@ -0,0 +1,95 @@
+/* ***************************************************** */
+/* Read an array from a cache file.                      */
+/* read_cache_array.c                                    */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file read_cache_array.c
+    \brief Read an array from a cache file.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+/** Read an array from a cache file written by write_cache_array. */
+int
+read_cache_array(char *filename, char *key, double *buf, size_t n) {
+  /**
+     @param[in]   filename  Cache filename.
+     @param[in]   key       Key of configuration and input files.
+     @param[out]  buf       Array.
+     @param[in]   n         Expected number of elements.
+     
+     \return                Status: 1 if there is no valid cache file.
+  */
+
+  FILE *infile = NULL; /* Cache file pointer */
+  char filekey[17]; /* Key read from cache file */
+  size_t nfile = 0; /* Number of elements in file */
+  int istat = 0; /* Diagnostic status */
+
+  infile = fopen(filename, "rb");
+  if (infile == NULL)
+    return 1;
+
+  if (fread(filekey, sizeof(char), strlen(key)+1, infile) != strlen(key)+1 || strcmp(filekey, key) ||
+      fread(&nfile, sizeof(size_t), 1, infile) != 1 || nfile != n || fread(buf, sizeof(double), n, infile) != n) {
+    (void) fprintf(stderr, "%s: WARNING: Cache file %s is invalid: it is not used.\n", __FILE__, filename);
+    istat = 1;
+  }
+  else
+    (void) printf("%s: Reading cached data from %s\n", __FILE__, filename);
+  (void) fclose(infile);
+
+  return istat;
+}
@@ -0,0 +1,142 @@
+/* ***************************************************** */
+/* Read checkpoint state files to know where             */
+/* to resume downscaling.                                */
+/* read_checkpoint_state.c                               */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file read_checkpoint_state.c
+    \brief Read checkpoint state files to know where to resume downscaling.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+static int read_checkpoint_value(char *filename, char *hash, char *key, int *value);
+
+/** Read one state value from a checkpoint state file, if the file exists and was written with the same hash. */
+static int
+read_checkpoint_value(char *filename, char *hash, char *key, int *value) {
+  /**
+     @param[in]   filename  Checkpoint state filename.
+     @param[in]   hash      Hash of current configuration and input files.
+     @param[in]   key       Name of the state value.
+     @param[out]  value     State value.
+     
+     \return                TRUE if a valid state value was read, FALSE otherwise.
+  */
+
+  FILE *infile = NULL; /* Checkpoint state file pointer */
+  char filehash[17]; /* Hash read from file */
+  char filekey[101]; /* Name of the state value read from file */
+  int valid = FALSE; /* If state value is valid */
+
+  infile = fopen(filename, "r");
+  if (infile == NULL)
+    return FALSE;
+  if (fscanf(infile, "hash %16s\n%100s %d", filehash, filekey, value) == 3)
+    if ( !strcmp(filehash, hash) && !strcmp(filekey, key) )
+      valid = TRUE;
+  (void) fclose(infile);
+
+  if (valid == FALSE)
+    (void) fprintf(stderr, "%s: WARNING: Checkpoint file %s was written with another configuration or other input files: ignoring it.\n",
+                   __FILE__, filename);
+
+  return valid;
+}
+
+/** Read checkpoint state files to know where to resume downscaling: last completed stage, and last output year
+    completely written for each downscaled category. A missing checkpoint directory means no checkpoint. */
+int
+read_checkpoint_state(data_struct *data) {
+  /**
+     @param[in,out]  data  MASTER data structure.
+     
+     \return               Status.
+  */
+
+  char *filename = NULL; /* Checkpoint filename */
+  int cat; /* Loop counter for field categories */
+
+  data->conf->checkpoint_stage = CHECKPOINT_NONE;
+  for (cat=0; cat<NCAT; cat++)
+    data->conf->checkpoint_year[cat] = -1;
+
+  filename = (char *) malloc(MAXPATH * sizeof(char));
+  if (filename == NULL) alloc_error(__FILE__, __LINE__);
+
+  (void) sprintf(filename, "%s/%s", data->conf->checkpoint_path, "checkpoint.txt");
+  if (read_checkpoint_value(filename, data->conf->checkpoint_hash, "stage", &(data->conf->checkpoint_stage)) == FALSE)
+    data->conf->checkpoint_stage = CHECKPOINT_NONE;
+
+  /* Output years can only have been written once analog days are known */
+  if (data->conf->checkpoint_stage == CHECKPOINT_ANALOG) {
+    (void) sprintf(filename, "%s/%s", data->conf->checkpoint_path, "output_other.txt");
+    if (read_checkpoint_value(filename, data->conf->checkpoint_hash, "year", &(data->conf->checkpoint_year[FIELD_LS])) == FALSE)
+      data->conf->checkpoint_year[FIELD_LS] = -1;
+    (void) sprintf(filename, "%s/%s", data->conf->checkpoint_path, "output_ctrl.txt");
+    if (read_checkpoint_value(filename, data->conf->checkpoint_hash, "year", &(data->conf->checkpoint_year[CTRL_FIELD_LS])) == FALSE)
+      data->conf->checkpoint_year[CTRL_FIELD_LS] = -1;
+  }
+
+  (void) free(filename);
+
+  if (data->conf->checkpoint_stage != CHECKPOINT_NONE)
+    (void) fprintf(stdout, "%s: Resuming downscaling from checkpoint stage %d in %s. Last output years written: %d (control run: %d).\n",
+                   __FILE__, data->conf->checkpoint_stage, data->conf->checkpoint_path,
+                   data->conf->checkpoint_year[FIELD_LS], data->conf->checkpoint_year[CTRL_FIELD_LS]);
+
+  /* Success status */
+  return 0;
+}
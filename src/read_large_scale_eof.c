@@ -92,8 +92,8 @@ read_large_scale_eof(data_struct *data) {
     /* Loop over large-scale fields */
     for (i=0; i<data->field[cat].n_ls; i++) {
 
-      /* Verify that we need to project field onto EOF */
-      if (data->field[cat].data[i].eof_info->eof_project == TRUE) {
+      /* Verify that we need to project field onto EOF, and that EOFs are not computed in compute_large_scale_eof */
+      if (data->field[cat].data[i].eof_info->eof_project == TRUE && data->field[cat].data[i].eof_info->eof_compute == FALSE) {
       
         if (data->field[cat].lon_eof_ls == NULL) {
           /* Read dimensions for EOF */
@@ -62,7 +62,11 @@ LICENSE END */
 
 #include <dsclim.h>
 
-/** Read large-scale fields data from input files. Currently only NetCDF is implemented. */
+/** Read large-scale fields data from input files. Currently only NetCDF is implemented.
+    Each field can be split into several consecutive time periods files, given as a filename pattern:
+    files are processed one at a time and only the subdomain is kept.
+    When streaming is enabled (stream_chunk), model run fields projected onto EOF are not kept in memory: only their
+    coordinates and times are read, and project_large_scale_field_stream reads them by chunks. */
 int
 read_large_scale_fields(data_struct *data) {
   /**
@@ -74,13 +78,22 @@ read_large_scale_fields(data_struct *data) {
   int istat; /* Diagnostic status */
   int i; /* Loop counter */
   int t; /* Time loop counter */
+  int j; /* Loop counter for grid points */
+  int f; /* Loop counter for files */
   int cat; /* Field category loop counter */
   double *buf = NULL; /* Temporary data buffer */
+  double *bufsub = NULL; /* Temporary data buffer for subdomain */
+  double *bufall = NULL; /* Subdomain data buffer for all input files */
   double *time_ls = NULL; /* Temporary time information buffer */
+  double *timeblock = NULL; /* Time information of one input file in output time units */
+  double *timeall = NULL; /* Time information for all input files in output time units */
   double *lat = NULL; /* Temporary latitude buffer for main large-scale fields */
   double *lon = NULL; /* Temporary longitude buffer for main large-scale fields */
-  char **cal_type; /* Calendar type (udunits) */
-  char **time_units; /* Time units (udunits) */
+  double *lat_sub = NULL; /* Temporary latitude buffer for subdomain */
+  double *lon_sub = NULL; /* Temporary longitude buffer for subdomain */
+  char *cal_type = NULL; /* Calendar type (udunits) */
+  char *time_units = NULL; /* Time units (udunits) */
+  char **filelist = NULL; /* List of input files for a field */
   double longitude_min; /* Domain bounding box minimum longitude */
   double longitude_max; /* Domain bounding box maximum longitude */
   double latitude_min; /* Domain bounding box minimum latitude */
@@ -91,20 +104,18 @@ read_large_scale_fields(data_struct *data) {
   int ntime_file; /* Number of times dimension in input file */
   int nlon_file; /* Longitude dimension for main large-scale fields in input file */
   int nlat_file; /* Latitude dimension for main large-scale fields in input file */
+  int nlon_sub; /* Longitude dimension of subdomain */
+  int nlat_sub; /* Latitude dimension of subdomain */
+  int ntime_block; /* Number of times of one input file after calendar adjustment */
+  int ntime_all; /* Number of times for all input files */
+  int nfiles; /* Number of input files for a field */
+  int stream; /* If field data is streamed by chunks later instead of read here */
   
   int year_begin; /* When fixing time units, year to use as start date. */
 
-  cal_type = (char **) malloc(NCAT * sizeof(char *));
-  if (cal_type == NULL) alloc_error(__FILE__, __LINE__);
-  time_units = (char **) malloc(NCAT * sizeof(char *));
-  if (time_units == NULL) alloc_error(__FILE__, __LINE__);
-
   /* Loop over all large-scale field categories */
   for (cat=0; cat<NCAT; cat++) {
 
-    cal_type[cat] = NULL;
-    time_units[cat] = NULL;
-
     /* Select proper domain given large-scale field category */
     if (cat == 0 || cat == 1) {
       longitude_min = data->conf->longitude_min;
@@ -135,21 +146,48 @@ read_large_scale_fields(data_struct *data) {
 
     /* Loop over large-scale fields */
     for (i=0; i<data->field[cat].n_ls; i++) {
-      /* Retrieve dimensions if time buffer is not already set for this field category */
-      if (data->field[cat].time_ls == NULL) {
-        istat = read_netcdf_dims_3d(&lon, &lat, &time_ls, &(cal_type[cat]), &(time_units[cat]), &nlon, &nlat, &ntime,
+
+      /* Get list of input files: either a single file or several files spanning consecutive time periods */
+      istat = get_file_list(&filelist, &nfiles, data->field[cat].data[i].filename_ls);
+      if (istat < 0)
+        return istat;
+
+      if (data->field[cat].data[i].field_ls != NULL) {
+        (void) free(data->field[cat].data[i].field_ls);
+        data->field[cat].data[i].field_ls = NULL;
+      }
+      bufall = NULL;
+      timeall = NULL;
+      ntime_all = 0;
+
+      /* Only model run fields which are projected onto EOF can be streamed */
+      if (cat == FIELD_LS && data->conf->stream_chunk > 0 && data->field[cat].data[i].eof_info->eof_project == TRUE)
+        stream = TRUE;
+      else
+        stream = FALSE;
+
+      /* Process input files one at a time, keeping only the subdomain */
+      for (f=0; f<nfiles; f++) {
+
+        /* Retrieve dimensions and time information */
+        istat = read_netcdf_dims_3d(&lon, &lat, &time_ls, &cal_type, &time_units, &nlon, &nlat, &ntime,
                                     data->info, data->field[cat].proj[i].coords, data->field[cat].proj[i].name,
                                     data->field[cat].data[i].lonname, data->field[cat].data[i].latname,
                                     data->field[cat].data[i].dimxname, data->field[cat].data[i].dimyname,
                                     data->field[cat].data[i].timename,
-                                    data->field[cat].data[i].filename_ls);
+                                    filelist[f]);
         if (istat < 0) {
           /* In case of failure */
           (void) free(lon);
           (void) free(lat);
           (void) free(time_ls);
-          (void) free(time_units[cat]);
-          (void) free(cal_type[cat]);
+          (void) free(time_units);
+          (void) free(cal_type);
+          (void) free(bufall);
+          (void) free(timeall);
+          for (f=0; f<nfiles; f++)
+            (void) free(filelist[f]);
+          (void) free(filelist);
           return istat;
         }
         /* Adjust time units if we want to fix time (set in the configuration file) */
@@ -160,26 +198,45 @@ read_large_scale_fields(data_struct *data) {
             year_begin = data->conf->year_begin_ctrl;
           if (istat != 1) {
             (void) fprintf(stderr, "\n%s: IMPORTANT WARNING: Time variable values all zero!!! Fixing time variable to index value, STARTING at 0...\n\n", __FILE__);
+            /* Index values continue across consecutive input files */
             for (t=0; t<ntime; t++)
-              time_ls[t] = (double) t;
+              time_ls[t] = (double) (t + ntime_all);
           }
           (void) fprintf(stdout, "%s: Fixing time units using start date %d-01-01 12:00:00.\n", __FILE__, year_begin);
-          time_units[cat] = realloc(time_units[cat], 500 * sizeof(char));
-          if (time_units[cat] == NULL) alloc_error(__FILE__, __LINE__);
+          time_units = realloc(time_units, 500 * sizeof(char));
+          if (time_units == NULL) alloc_error(__FILE__, __LINE__);
           /* days since 1950-01-01 12:00:00 */
-          (void) sprintf(time_units[cat], "days since %d-01-01 12:00:00", year_begin);
+          (void) sprintf(time_units, "days since %d-01-01 12:00:00", year_begin);
+        }
+
+        /* Streaming needs a standard calendar: calendar adjustment is not done by chunks */
+        if (stream == TRUE && f == 0 && strcmp(cal_type, "gregorian") && strcmp(cal_type, "standard")) {
+          (void) fprintf(stderr, "%s: WARNING: Cannot stream %s with calendar %s. Reading the whole field.\n", __FILE__,
+                         data->field[cat].data[i].nomvar_ls, cal_type);
+          stream = FALSE;
         }
-      }
 
-      /* For standard calendar data */
-      if ( !strcmp(cal_type[cat], "gregorian") || !strcmp(cal_type[cat], "standard") ) {
-        
         /* Read data */
-        istat = read_netcdf_var_3d(&buf, data->field[cat].data[i].info, &(data->field[cat].proj[i]),
-                                   data->field[cat].data[i].filename_ls,
-                                   data->field[cat].data[i].nomvar_ls,
-                                   data->field[cat].data[i].dimxname, data->field[cat].data[i].dimyname, data->field[cat].data[i].timename,
-                                   &nlon_file, &nlat_file, &ntime_file, TRUE);
+        if (stream == TRUE && f == 0)
+          /* Only first timestep, to retrieve field information and subdomain */
+          istat = read_netcdf_var_3d_2d(&buf, data->field[cat].data[i].info, &(data->field[cat].proj[i]),
+                                        filelist[f],
+                                        data->field[cat].data[i].nomvar_ls,
+                                        data->field[cat].data[i].dimxname, data->field[cat].data[i].dimyname,
+                                        data->field[cat].data[i].timename,
+                                        0, &nlon_file, &nlat_file, &ntime_file, TRUE);
+        else if (stream == TRUE) {
+          /* Nothing to read: only times of following files are needed */
+          nlon_file = nlon;
+          nlat_file = nlat;
+          ntime_file = ntime;
+        }
+        else
+          istat = read_netcdf_var_3d(&buf, data->field[cat].data[i].info, &(data->field[cat].proj[i]),
+                                     filelist[f],
+                                     data->field[cat].data[i].nomvar_ls,
+                                     data->field[cat].data[i].dimxname, data->field[cat].data[i].dimyname, data->field[cat].data[i].timename,
+                                     &nlon_file, &nlat_file, &ntime_file, TRUE);
         if (nlon != nlon_file || nlat != nlat_file || ntime != ntime_file) {
           (void) fprintf(stderr, "%s: Problems in dimensions! nlat=%d nlat_file=%d nlon=%d nlon_file=%d ntime=%d ntime_file=%d\n",
                          __FILE__, nlat, nlat_file, nlon, nlon_file, ntime, ntime_file);
@@ -191,147 +248,182 @@ read_large_scale_fields(data_struct *data) {
           (void) free(lon);
           (void) free(lat);
           (void) free(time_ls);
-          (void) free(time_units[cat]);
-          (void) free(cal_type[cat]);
+          (void) free(time_units);
+          (void) free(cal_type);
+          (void) free(bufall);
+          (void) free(timeall);
+          for (f=0; f<nfiles; f++)
+            (void) free(filelist[f]);
+          (void) free(filelist);
           return istat;
         }
-        
-        /* Extract subdomain of spatial fields */
-        if (data->field[cat].lon_ls != NULL) {
-          (void) free(data->field[cat].lon_ls);
-          data->field[cat].lon_ls = NULL;
-        }
-        if (data->field[cat].lat_ls != NULL) {
-          (void) free(data->field[cat].lat_ls);
-          data->field[cat].lat_ls = NULL;
-        }
-        if (data->field[cat].data[i].field_ls != NULL) {
-          (void) free(data->field[cat].data[i].field_ls);
-          data->field[cat].data[i].field_ls = NULL;
-        }
 
         /* Extraction of subdomain */
-        (void) extract_subdomain(&(data->field[cat].data[i].field_ls), &(data->field[cat].lon_ls), &(data->field[cat].lat_ls),
-                                 &(data->field[cat].nlon_ls), &(data->field[cat].nlat_ls), buf, lon, lat,
-                                 longitude_min, longitude_max, latitude_min, latitude_max, nlon, nlat, ntime);
+        if (stream == FALSE)
+          (void) extract_subdomain(&bufsub, &lon_sub, &lat_sub, &nlon_sub, &nlat_sub, buf, lon, lat,
+                                   longitude_min, longitude_max, latitude_min, latitude_max, nlon, nlat, ntime);
+        else if (f == 0) {
+          (void) extract_subdomain(&bufsub, &lon_sub, &lat_sub, &nlon_sub, &nlat_sub, buf, lon, lat,
+                                   longitude_min, longitude_max, latitude_min, latitude_max, nlon, nlat, 1);
+          (void) free(bufsub);
+          bufsub = NULL;
+        }
         (void) free(buf);
-
-        /* Save number of times dimension */
-        data->field[cat].ntime_ls = ntime;
-
-        /* If time info not already retrieved for this category, get time information and generate time structure */
-        if (data->field[cat].time_ls == NULL) {
-          data->field[cat].time_ls = (double *) malloc(data->field[cat].ntime_ls * sizeof(double));
-          if (data->field[cat].time_ls == NULL) alloc_error(__FILE__, __LINE__);
-          if ( strcmp(time_units[cat], data->conf->time_units) )
-            (void) change_date_origin(data->field[cat].time_ls, data->conf->time_units, time_ls, time_units[cat], ntime);
+        buf = NULL;
+
+        if ( !strcmp(cal_type, "gregorian") || !strcmp(cal_type, "standard") ) {
+          /* For standard calendar data, only adjust time origin */
+          ntime_block = ntime;
+          timeblock = (double *) malloc(ntime_block * sizeof(double));
+          if (timeblock == NULL) alloc_error(__FILE__, __LINE__);
+          if ( strcmp(time_units, data->conf->time_units) )
+            (void) change_date_origin(timeblock, data->conf->time_units, time_ls, time_units, ntime);
           else
-            for (t=0; t<data->field[cat].ntime_ls; t++)
-              data->field[cat].time_ls[t] = time_ls[t];
-          istat = compute_time_info(data->field[cat].time_s, data->field[cat].time_ls, data->conf->time_units, data->conf->cal_type,
-                                    data->field[cat].ntime_ls);
+            for (t=0; t<ntime_block; t++)
+              timeblock[t] = time_ls[t];
+        }
+        else {
+          /* Non-standard calendar type: adjust calendar to standard calendar */
+          istat = data_to_gregorian_cal_d(&buf, &timeblock, &ntime_block,
+                                          bufsub, time_ls, time_units, data->conf->time_units,
+                                          cal_type, nlon_sub, nlat_sub, ntime);
+          (void) free(bufsub);
+          bufsub = buf;
+          buf = NULL;
+          if (istat < 0) {
+            /* In case of failure */
+            (void) free(lon);
+            (void) free(lat);
+            (void) free(lon_sub);
+            (void) free(lat_sub);
+            (void) free(time_ls);
+            (void) free(time_units);
+            (void) free(cal_type);
+            (void) free(bufsub);
+            (void) free(timeblock);
+            (void) free(bufall);
+            (void) free(timeall);
+            for (f=0; f<nfiles; f++)
+              (void) free(filelist[f]);
+            (void) free(filelist);
+            return istat;
+          }
         }
-      }
-      else {
-        /* Non-standard calendar type */
-
-        double *dummy = NULL;
 
-        /* Free memory if previously allocated */
-        if (data->field[cat].lon_ls != NULL) {
-          (void) free(data->field[cat].lon_ls);
-          data->field[cat].lon_ls = NULL;
+        /* Append this time period to previous ones */
+        if (f == 0) {
+          bufall = bufsub;
+          timeall = timeblock;
         }
-        if (data->field[cat].lat_ls != NULL) {
-          (void) free(data->field[cat].lat_ls);
-          data->field[cat].lat_ls = NULL;
+        else {
+          /* Following input files must be on the same grid as the first one, and follow the previous one in time */
+          istat = 0;
+          if (lon_sub != NULL) {
+            if (nlon_sub != data->field[cat].nlon_ls || nlat_sub != data->field[cat].nlat_ls)
+              istat = -1;
+            for (j=0; j<nlon_sub*nlat_sub && istat == 0; j++)
+              if (fabs(lon_sub[j] - data->field[cat].lon_ls[j]) > COORD_TOLERANCE ||
+                  fabs(lat_sub[j] - data->field[cat].lat_ls[j]) > COORD_TOLERANCE)
+                istat = -1;
+            if (istat != 0)
+              (void) fprintf(stderr, "%s: ERROR: Input file %s is not on the same grid as input file %s. Files must have the same grid.\n",
+                             __FILE__, filelist[f], filelist[0]);
+          }
+          if (istat == 0 && timeblock[0] <= timeall[ntime_all-1]) {
+            (void) fprintf(stderr, "%s: ERROR: Input file %s does not follow previous one in time. Files must span consecutive time periods.\n",
+                           __FILE__, filelist[f]);
+            istat = -1;
+          }
+          if (istat != 0) {
+            /* In case of failure */
+            (void) free(lon);
+            (void) free(lat);
+            (void) free(lon_sub);
+            (void) free(lat_sub);
+            (void) free(time_ls);
+            (void) free(time_units);
+            (void) free(cal_type);
+            (void) free(bufsub);
+            (void) free(timeblock);
+            (void) free(bufall);
+            (void) free(timeall);
+            for (f=0; f<nfiles; f++)
+              (void) free(filelist[f]);
+            (void) free(filelist);
+            return istat;
+          }
+          if (stream == FALSE) {
+            bufall = (double *) realloc(bufall, nlon_sub * nlat_sub * (ntime_all+ntime_block) * sizeof(double));
+            if (bufall == NULL) alloc_error(__FILE__, __LINE__);
+            (void) memcpy(&(bufall[nlon_sub * nlat_sub * ntime_all]), bufsub, nlon_sub * nlat_sub * ntime_block * sizeof(double));
+          }
+          timeall = (double *) realloc(timeall, (ntime_all+ntime_block) * sizeof(double));
+          if (timeall == NULL) alloc_error(__FILE__, __LINE__);
+          (void) memcpy(&(timeall[ntime_all]), timeblock, ntime_block * sizeof(double));
+          (void) free(bufsub);
+          (void) free(timeblock);
         }
-        if (data->field[cat].data[i].field_ls != NULL) {
-          (void) free(data->field[cat].data[i].field_ls);
-          data->field[cat].data[i].field_ls = NULL;
+        bufsub = NULL;
+        timeblock = NULL;
+        ntime_all += ntime_block;
+
+        /* Keep subdomain coordinates of the first input file: following files must be on the same grid */
+        if (f == 0) {
+          if (data->field[cat].lon_ls != NULL)
+            (void) free(data->field[cat].lon_ls);
+          if (data->field[cat].lat_ls != NULL)
+            (void) free(data->field[cat].lat_ls);
+          data->field[cat].lon_ls = lon_sub;
+          data->field[cat].lat_ls = lat_sub;
+          data->field[cat].nlon_ls = nlon_sub;
+          data->field[cat].nlat_ls = nlat_sub;
         }
-        /* Read data and fix calendar */
-        istat = read_netcdf_var_3d(&(data->field[cat].data[i].field_ls), data->field[cat].data[i].info,
-                                   &(data->field[cat].proj[i]), data->field[cat].data[i].filename_ls,
-                                   data->field[cat].data[i].nomvar_ls,
-                                   data->field[cat].data[i].dimxname, data->field[cat].data[i].dimyname, data->field[cat].data[i].timename,
-                                   &nlon_file, &nlat_file, &ntime_file, TRUE);
-        if (nlon != nlon_file || nlat != nlat_file || ntime != ntime_file) {
-          (void) fprintf(stderr, "%s: Problems in dimensions! nlat=%d nlat_file=%d nlon=%d nlon_file=%d ntime=%d ntime_file=%d\n",
-                         __FILE__, nlat, nlat_file, nlon, nlon_file, ntime, ntime_file);
-          istat = -1;
-        }
-        if (istat != 0) {
-          /* In case of failure */
-          (void) free(lon);
-          (void) free(lat);
-          (void) free(time_ls);
-          (void) free(time_units[cat]);
-          (void) free(cal_type[cat]);
-          return istat;
+        else {
+          (void) free(lon_sub);
+          (void) free(lat_sub);
         }
+        lon_sub = NULL;
+        lat_sub = NULL;
+
+        /* Free memory */
+        (void) free(lat);
+        lat = NULL;
+        (void) free(lon);
+        lon = NULL;
+        (void) free(time_ls);
+        time_ls = NULL;
+        (void) free(time_units);
+        time_units = NULL;
+        (void) free(cal_type);
+        cal_type = NULL;
+      }
 
-        /* Extract subdomain of spatial fields */
-        (void) extract_subdomain(&buf, &(data->field[cat].lon_ls), &(data->field[cat].lat_ls),
-                                 &(data->field[cat].nlon_ls), &(data->field[cat].nlat_ls), data->field[cat].data[i].field_ls, lon, lat,
-                                 longitude_min, longitude_max, latitude_min, latitude_max, nlon, nlat, ntime);
-        (void) free(data->field[cat].data[i].field_ls);
+      for (f=0; f<nfiles; f++)
+        (void) free(filelist[f]);
+      (void) free(filelist);
+      filelist = NULL;
 
-        /* Adjust calendar to standard calendar */
-        istat = data_to_gregorian_cal_d(&(data->field[cat].data[i].field_ls), &dummy, &(data->field[cat].ntime_ls),
-                                        buf, time_ls, time_units[cat], data->conf->time_units,
-                                        cal_type[cat], data->field[cat].nlon_ls, data->field[cat].nlat_ls, ntime);
-        if (istat < 0) {
-          /* In case of failure */
-          (void) free(lon);
-          (void) free(lat);
-          (void) free(time_ls);
-          (void) free(time_units[cat]);
-          (void) free(cal_type[cat]);
-          (void) free(buf);
-          (void) free(data->field[cat].lon_ls);
-          (void) free(data->field[cat].lat_ls);
-          (void) free(data->field[cat].data[i].field_ls);
-          return istat;
-        }
-        if (data->field[cat].time_ls == NULL) {
-          data->field[cat].time_ls = (double *) malloc(data->field[cat].ntime_ls * sizeof(double));
-          if (data->field[cat].time_ls == NULL) alloc_error(__FILE__, __LINE__);
-          for (t=0; t<data->field[cat].ntime_ls; t++)
-            data->field[cat].time_ls[t] = dummy[t];
-          istat = compute_time_info(data->field[cat].time_s, data->field[cat].time_ls, data->conf->time_units, data->conf->cal_type,
-                                    data->field[cat].ntime_ls);
+      data->field[cat].data[i].field_ls = bufall;
+
+      /* If time info not already retrieved for this category, generate time structure */
+      if (data->field[cat].time_ls == NULL) {
+        data->field[cat].ntime_ls = ntime_all;
+        data->field[cat].time_ls = timeall;
+        istat = compute_time_info(data->field[cat].time_s, data->field[cat].time_ls, data->conf->time_units, data->conf->cal_type,
+                                  data->field[cat].ntime_ls);
+      }
+      else {
+        if (ntime_all != data->field[cat].ntime_ls) {
+          (void) fprintf(stderr, "%s: Problems in time dimension! All fields of the same category must have the same times: ntime=%d ntime_field=%d\n",
+                         __FILE__, data->field[cat].ntime_ls, ntime_all);
+          (void) free(timeall);
+          return -1;
         }
-        (void) free(dummy);
-        (void) free(buf);
+        (void) free(timeall);
       }
     }
-    /* Free memory */
-    if (lat != NULL) {
-      (void) free(lat);
-      lat = NULL;
-    }
-    if (lon != NULL) {
-      (void) free(lon);
-      lon = NULL;
-    }
-    if (time_ls != NULL) {
-      (void) free(time_ls);
-      time_ls = NULL;
-    }
-    if (time_units[cat] != NULL) {
-      (void) free(time_units[cat]);
-      time_units[cat] = NULL;
-    }
-    if (cal_type[cat] != NULL) {
-      (void) free(cal_type[cat]);
-      cal_type[cat] = NULL;
-    }
   }
 
-  (void) free(time_units);
-  (void) free(cal_type);
-
   /* Diagnostic status */
   return 0;
 }
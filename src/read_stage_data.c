@@ -0,0 +1,247 @@
+/* ***************************************************** */
+/* Read data of a completed downscaling stage            */
+/* from a binary file.                                   */
+/* read_stage_data.c                                     */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file read_stage_data.c
+    \brief Read data of a completed downscaling stage from a binary file.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+static void read_stage_array(FILE *infile, void *buf, size_t size, size_t n, int *istat);
+
+/** Read an array preceded by its number of elements from a stage data file.
+    The number of elements must be the expected one. On error, or after a previous error, the array is zeroed. */
+static void
+read_stage_array(FILE *infile, void *buf, size_t size, size_t n, int *istat) {
+  /**
+     @param[in]      infile  Stage data file pointer.
+     @param[out]     buf     Array.
+     @param[in]      size    Size of one element.
+     @param[in]      n       Expected number of elements.
+     @param[in,out]  istat   Diagnostic status: -1 on error.
+  */
+
+  size_t nfile = 0; /* Number of elements in file */
+
+  if (*istat == 0)
+    if (fread(&nfile, sizeof(size_t), 1, infile) != 1 || nfile != n || (n > 0 && fread(buf, size, n, infile) != n))
+      *istat = -1;
+  if (*istat != 0 && n > 0)
+    (void) memset(buf, 0, size * n);
+}
+
+/** Read data of a completed downscaling stage, written by write_stage_data. Memory is allocated as the downscaling
+    stage would have done. When reading classification stage data, the intermediate control-run statistics which
+    are not needed anymore are not restored, and their pointers are set to NULL. On error, the memory allocated for
+    the stage data is freed, so that the stage can be computed instead. */
+int
+read_stage_data(data_struct *data, int stage, int **ntime_sub, char *filename, char *hash) {
+  /**
+     @param[in,out]  data       MASTER data structure.
+     @param[in]      stage      Completed downscaling stage (CHECKPOINT_CLIM, CHECKPOINT_EOF or CHECKPOINT_CLASS).
+     @param[out]     ntime_sub  Number of times of each season, for each field category.
+     @param[in]      filename   Stage data filename.
+     @param[in]      hash       Hash of configuration and input files.
+     
+     \return                    Status.
+  */
+
+  FILE *infile = NULL; /* Stage data file pointer */
+  char filehash[17]; /* Hash read from stage data file */
+  int filestage; /* Stage read from stage data file */
+  int end_cat; /* End category to process */
+  int cat; /* Loop counter for field categories */
+  int i; /* Loop counter for large-scale fields */
+  int s; /* Loop counter for seasons */
+  int istat = 0; /* Diagnostic status */
+
+  infile = fopen(filename, "rb");
+  if (infile == NULL) {
+    (void) fprintf(stderr, "%s: Cannot open file %s for reading: %s\n", __FILE__, filename, strerror(errno));
+    return -1;
+  }
+  (void) printf("%s: Reading data of stage %d from %s\n", __FILE__, stage, filename);
+
+  read_stage_array(infile, filehash, sizeof(char), strlen(hash)+1, &istat);
+  read_stage_array(infile, &filestage, sizeof(int), 1, &istat);
+  if (istat != 0 || strcmp(filehash, hash) || filestage != stage) {
+    (void) fprintf(stderr, "%s: File %s was not written for this stage, configuration and input files.\n", __FILE__, filename);
+    (void) fclose(infile);
+    return -1;
+  }
+
+  if (data->conf->period_ctrl->downscale == TRUE)
+    end_cat = CTRL_FIELD_LS;
+  else
+    end_cat = FIELD_LS;
+
+  if (stage == CHECKPOINT_CLIM) {
+    /* Large-scale fields with climatology removed: memory was allocated when reading them */
+    for (cat=0; cat<NCAT; cat++)
+      for (i=0; i<data->field[cat].n_ls; i++)
+        if (data->field[cat].data[i].field_ls != NULL)
+          read_stage_array(infile, data->field[cat].data[i].field_ls, sizeof(double),
+                           (size_t) data->field[cat].nlon_ls * data->field[cat].nlat_ls * data->field[cat].ntime_ls, &istat);
+  }
+  else if (stage == CHECKPOINT_EOF) {
+    /* Large-scale fields projected on EOFs */
+    for (cat=FIELD_LS; cat<=CTRL_FIELD_LS; cat++)
+      for (i=0; i<data->field[cat].n_ls; i++)
+        if (data->field[cat].data[i].eof_info->eof_project == TRUE) {
+          data->field[cat].data[i].field_eof_ls = (double *) malloc(data->field[cat].ntime_ls * data->field[cat].data[i].eof_info->neof_ls *
+                                                                    sizeof(double));
+          if (data->field[cat].data[i].field_eof_ls == NULL) alloc_error(__FILE__, __LINE__);
+          read_stage_array(infile, data->field[cat].data[i].field_eof_ls, sizeof(double),
+                           (size_t) data->field[cat].ntime_ls * data->field[cat].data[i].eof_info->neof_ls, &istat);
+        }
+  }
+  else if (stage == CHECKPOINT_CLASS) {
+    /* Normalized distances to clusters, classification and regression index of downscaled days, */
+    /* normalized secondary large-scale fields, and control-run statistics of secondary large-scale fields */
+    for (cat=FIELD_LS; cat<=end_cat; cat++) {
+      read_stage_array(infile, ntime_sub[cat], sizeof(int), (size_t) data->conf->nseasons, &istat);
+      read_stage_array(infile, ntime_sub[cat+2], sizeof(int), (size_t) data->conf->nseasons, &istat);
+      for (i=0; i<data->field[cat].n_ls; i++)
+        for (s=0; s<data->conf->nseasons; s++) {
+          data->field[cat].data[i].down->dist[s] = (double *) malloc(data->conf->season[s].nclusters*ntime_sub[cat][s] * sizeof(double));
+          if (data->field[cat].data[i].down->dist[s] == NULL) alloc_error(__FILE__, __LINE__);
+          read_stage_array(infile, data->field[cat].data[i].down->dist[s], sizeof(double),
+                           (size_t) data->conf->season[s].nclusters * ntime_sub[cat][s], &istat);
+          data->field[cat].data[i].down->days_class_clusters[s] = (int *) malloc(ntime_sub[cat][s] * sizeof(int));
+          if (data->field[cat].data[i].down->days_class_clusters[s] == NULL) alloc_error(__FILE__, __LINE__);
+          read_stage_array(infile, data->field[cat].data[i].down->days_class_clusters[s], sizeof(int),
+                           (size_t) ntime_sub[cat][s], &istat);
+        }
+      if (data->field[cat].n_ls > 0)
+        for (s=0; s<data->conf->nseasons; s++) {
+          data->field[cat].precip_index[s] = (double *) malloc(data->reg->npts*ntime_sub[cat+2][s] * sizeof(double));
+          if (data->field[cat].precip_index[s] == NULL) alloc_error(__FILE__, __LINE__);
+          read_stage_array(infile, data->field[cat].precip_index[s], sizeof(double),
+                           (size_t) data->reg->npts * ntime_sub[cat+2][s], &istat);
+        }
+      for (i=0; i<data->field[cat+2].n_ls; i++)
+        for (s=0; s<data->conf->nseasons; s++) {
+          data->field[cat+2].data[i].down->smean_norm[s] = (double *) malloc(data->field[cat+2].ntime_ls * sizeof(double));
+          if (data->field[cat+2].data[i].down->smean_norm[s] == NULL) alloc_error(__FILE__, __LINE__);
+          read_stage_array(infile, data->field[cat+2].data[i].down->smean_norm[s], sizeof(double),
+                           (size_t) ntime_sub[cat+2][s], &istat);
+          data->field[cat+2].data[i].down->sup_val_norm[s] =
+            (double *) malloc(data->field[cat+2].nlon_ls*data->field[cat+2].nlat_ls*data->field[cat+2].ntime_ls * sizeof(double));
+          if (data->field[cat+2].data[i].down->sup_val_norm[s] == NULL) alloc_error(__FILE__, __LINE__);
+          read_stage_array(infile, data->field[cat+2].data[i].down->sup_val_norm[s], sizeof(double),
+                           (size_t) data->field[cat+2].nlon_ls * data->field[cat+2].nlat_ls * ntime_sub[cat+2][s], &istat);
+        }
+    }
+    for (i=0; i<data->field[CTRL_SEC_FIELD_LS].n_ls; i++) {
+      read_stage_array(infile, data->field[CTRL_SEC_FIELD_LS].data[i].down->mean, sizeof(double), (size_t) data->conf->nseasons, &istat);
+      read_stage_array(infile, data->field[CTRL_SEC_FIELD_LS].data[i].down->var, sizeof(double), (size_t) data->conf->nseasons, &istat);
+    }
+
+    /* Intermediate control-run statistics only used to compute the restored fields */
+    for (i=0; i<data->field[CTRL_FIELD_LS].n_ls; i++)
+      for (s=0; s<data->conf->nseasons; s++) {
+        data->field[CTRL_FIELD_LS].data[i].down->mean_dist[s] = NULL;
+        data->field[CTRL_FIELD_LS].data[i].down->var_dist[s] = NULL;
+      }
+    for (cat=SEC_FIELD_LS; cat<=CTRL_SEC_FIELD_LS; cat++)
+      for (i=0; i<data->field[cat].n_ls; i++)
+        data->field[cat].data[i].down->smean = NULL;
+    for (i=0; i<data->field[CTRL_SEC_FIELD_LS].n_ls; i++)
+      for (s=0; s<data->conf->nseasons; s++) {
+        data->field[CTRL_SEC_FIELD_LS].data[i].down->smean_2d[s] = NULL;
+        data->field[CTRL_SEC_FIELD_LS].data[i].down->svar_2d[s] = NULL;
+      }
+  }
+
+  (void) fclose(infile);
+
+  if (istat != 0) {
+    (void) fprintf(stderr, "%s: File %s is invalid or truncated.\n", __FILE__, filename);
+    /* Free memory allocated for this stage, so that it can be computed instead */
+    if (stage == CHECKPOINT_EOF)
+      for (cat=FIELD_LS; cat<=CTRL_FIELD_LS; cat++)
+        for (i=0; i<data->field[cat].n_ls; i++) {
+          (void) free(data->field[cat].data[i].field_eof_ls);
+          data->field[cat].data[i].field_eof_ls = NULL;
+        }
+    else if (stage == CHECKPOINT_CLASS)
+      for (cat=FIELD_LS; cat<=end_cat; cat++) {
+        for (i=0; i<data->field[cat].n_ls; i++)
+          for (s=0; s<data->conf->nseasons; s++) {
+            (void) free(data->field[cat].data[i].down->dist[s]);
+            (void) free(data->field[cat].data[i].down->days_class_clusters[s]);
+            data->field[cat].data[i].down->dist[s] = NULL;
+            data->field[cat].data[i].down->days_class_clusters[s] = NULL;
+          }
+        if (data->field[cat].n_ls > 0)
+          for (s=0; s<data->conf->nseasons; s++) {
+            (void) free(data->field[cat].precip_index[s]);
+            data->field[cat].precip_index[s] = NULL;
+          }
+        for (i=0; i<data->field[cat+2].n_ls; i++)
+          for (s=0; s<data->conf->nseasons; s++) {
+            (void) free(data->field[cat+2].data[i].down->smean_norm[s]);
+            (void) free(data->field[cat+2].data[i].down->sup_val_norm[s]);
+            data->field[cat+2].data[i].down->smean_norm[s] = NULL;
+            data->field[cat+2].data[i].down->sup_val_norm[s] = NULL;
+          }
+      }
+  }
+
+  return istat;
+}
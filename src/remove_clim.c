@@ -88,6 +88,9 @@ remove_clim(data_struct *data) {
   int ii; /* Loop counter */
   info_field_struct clim_info_field; /* Information structure for climatology field */
   double *timeclim = NULL; /* Time info for climatology field */
+  char *cachefile = NULL; /* Cache filename of climatology */
+  char product[50]; /* Cached product name of climatology */
+  int clim_cached; /* If climatology is read from cache */
 
   /* Remove seasonal cycle:
      - Fix calendar and generate a gregorian calendar
@@ -176,13 +179,32 @@ remove_clim(data_struct *data) {
           /* Get missing value */
           fillvalue = data->field[cat].data[i].info->fillvalue;
         }
+
+        /* Climatology computed by a previous run with the same large-scale fields may be in cache */
+        clim_cached = FALSE;
+        if (data->conf->cache_path != NULL && data->field[cat].data[i].clim_info->clim_provided == FALSE) {
+          (void) sprintf(product, "clim_%d_%d.bin", cat, i);
+          cachefile = cache_filename(data, CHECKPOINT_CLIM, product);
+          if (read_cache_array(cachefile, data->conf->cache_key[CHECKPOINT_CLIM], clim[cat],
+                               (size_t) data->field[cat].nlon_ls * data->field[cat].nlat_ls * ntime_clim) == 0)
+            clim_cached = TRUE;
+        }
       
         /* Remove seasonal cycle by calculating filtered climatology and substracting from field values */
         (void) remove_seasonal_cycle(bufnoclim, clim[cat], data->field[cat].data[i].field_ls, timein_ts,
                                      data->field[cat].data[i].info->fillvalue,
                                      data->conf->clim_filter_width, data->conf->clim_filter_type,
-                                     data->field[cat].data[i].clim_info->clim_provided,
+                                     (clim_cached == TRUE) ? TRUE : data->field[cat].data[i].clim_info->clim_provided,
                                      data->field[cat].nlon_ls, data->field[cat].nlat_ls, data->field[cat].ntime_ls);
+
+        /* Store computed climatology in cache */
+        if (cachefile != NULL) {
+          if (clim_cached == FALSE)
+            (void) write_cache_array(cachefile, data->conf->cache_key[CHECKPOINT_CLIM], clim[cat],
+                                     (size_t) data->field[cat].nlon_ls * data->field[cat].nlat_ls * ntime_clim);
+          (void) free(cachefile);
+          cachefile = NULL;
+        }
       
         /* If we want to save climatology in NetCDF output file for further use */
         if (data->field[cat].data[i].clim_info->clim_save == TRUE) {
@@ -248,6 +270,7 @@ remove_clim(data_struct *data) {
       }
       /* Free memory */
       (void) free(bufnoclim);
+      bufnoclim = NULL;
       (void) free(timein_ts);
     }
   }
@@ -260,8 +283,11 @@ remove_clim(data_struct *data) {
     for (i=0; i<data->field[cat].n_ls; i++) {
 
       /* Allocate memory for field with climatology removed */
-      bufnoclim = (double *) malloc(data->field[cat].nlon_ls * data->field[cat].nlat_ls * data->field[cat].ntime_ls * sizeof(double));
-      if (bufnoclim == NULL) alloc_error(__FILE__, __LINE__);
+      /* Streamed fields are not in memory: climatology is removed by chunks in project_large_scale_field_stream */
+      if (data->field[cat].data[i].field_ls != NULL) {
+        bufnoclim = (double *) malloc(data->field[cat].nlon_ls * data->field[cat].nlat_ls * data->field[cat].ntime_ls * sizeof(double));
+        if (bufnoclim == NULL) alloc_error(__FILE__, __LINE__);
+      }
 
       /* Allocate memory for temporary time structure */
       timein_ts = (tstruct *) malloc(data->field[cat].ntime_ls * sizeof(tstruct));
@@ -315,11 +341,20 @@ remove_clim(data_struct *data) {
         }
       
         /* Remove seasonal cycle by substracting control-run climatology from field values (not the clim[cat+1] */
-        (void) remove_seasonal_cycle(bufnoclim, clim[cat+1], data->field[cat].data[i].field_ls, timein_ts,
-                                     data->field[cat].data[i].info->fillvalue,
-                                     data->conf->clim_filter_width, data->conf->clim_filter_type,
-                                     TRUE,
-                                     data->field[cat].nlon_ls, data->field[cat].nlat_ls, data->field[cat].ntime_ls);
+        if (data->field[cat].data[i].field_ls != NULL)
+          (void) remove_seasonal_cycle(bufnoclim, clim[cat+1], data->field[cat].data[i].field_ls, timein_ts,
+                                       data->field[cat].data[i].info->fillvalue,
+                                       data->conf->clim_filter_width, data->conf->clim_filter_type,
+                                       TRUE,
+                                       data->field[cat].nlon_ls, data->field[cat].nlat_ls, data->field[cat].ntime_ls);
+        else {
+          /* Keep control-run climatology for streamed field */
+          data->field[cat].data[i].clim_ls = (double *) malloc(data->field[cat].nlon_ls * data->field[cat].nlat_ls * ntime_clim *
+                                                               sizeof(double));
+          if (data->field[cat].data[i].clim_ls == NULL) alloc_error(__FILE__, __LINE__);
+          (void) memcpy(data->field[cat].data[i].clim_ls, clim[cat+1],
+                        data->field[cat].nlon_ls * data->field[cat].nlat_ls * ntime_clim * sizeof(double));
+        }
       
         /* If we want to save climatology in NetCDF output file for further use */
         if (data->field[cat].data[i].clim_info->clim_save == TRUE) {
@@ -380,11 +415,13 @@ remove_clim(data_struct *data) {
         }
 
         /* Copy field with climatology removed to proper variable in data structure */
-        for (ii=0; ii<(data->field[cat].nlon_ls * data->field[cat].nlat_ls * data->field[cat].ntime_ls); ii++)
-          data->field[cat].data[i].field_ls[ii] = bufnoclim[ii];
+        if (data->field[cat].data[i].field_ls != NULL)
+          for (ii=0; ii<(data->field[cat].nlon_ls * data->field[cat].nlat_ls * data->field[cat].ntime_ls); ii++)
+            data->field[cat].data[i].field_ls[ii] = bufnoclim[ii];
       }
       /* Free memory */
       (void) free(bufnoclim);
+      bufnoclim = NULL;
       (void) free(timein_ts);
     }
   }
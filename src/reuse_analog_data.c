@@ -0,0 +1,124 @@
+/* ***************************************************** */
+/* Reuse analog data of a checkpoint                     */
+/* or of the cache.                                      */
+/* reuse_analog_data.c                                   */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file reuse_analog_data.c
+    \brief Reuse analog data of a checkpoint or of the cache.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+/** Reuse analog data already computed for this configuration and these input files: analog data files saved by an
+    interrupted run in the checkpoint directory, or else cached analog data files. When available, the output only option
+    is activated with these analog data files, so that the learning and the analog days search are skipped.
+    Must be called after load_conf, and only for a configuration which is downscaled. */
+int
+reuse_analog_data(data_struct *data) {
+  /**
+     @param[in,out]  data  MASTER data structure.
+     
+     \return               Status: 1 if analog data is reused.
+  */
+
+  char *file_ctrl = NULL; /* Analog data filename for control run */
+  char *file_other = NULL; /* Analog data filename for other downscaled period */
+  struct stat st; /* File information */
+
+  if (data->conf->output_only == TRUE)
+    return 0;
+
+  if (data->conf->checkpoint_path != NULL && data->conf->checkpoint_stage == CHECKPOINT_ANALOG) {
+    file_other = (char *) malloc(MAXPATH * sizeof(char));
+    if (file_other == NULL) alloc_error(__FILE__, __LINE__);
+    (void) sprintf(file_other, "%s/%s", data->conf->checkpoint_path, "analog_other.nc");
+    if (data->conf->period_ctrl->downscale == TRUE) {
+      file_ctrl = (char *) malloc(MAXPATH * sizeof(char));
+      if (file_ctrl == NULL) alloc_error(__FILE__, __LINE__);
+      (void) sprintf(file_ctrl, "%s/%s", data->conf->checkpoint_path, "analog_ctrl.nc");
+    }
+    (void) fprintf(stdout, "%s: Analog days already computed by an interrupted run: activating output only option.\n", __FILE__);
+  }
+  else if (data->conf->cache_path != NULL) {
+    file_other = cache_filename(data, CHECKPOINT_ANALOG, "analog_other.nc");
+    if (data->conf->period_ctrl->downscale == TRUE)
+      file_ctrl = cache_filename(data, CHECKPOINT_ANALOG, "analog_ctrl.nc");
+    if (stat(file_other, &st) != 0 || (file_ctrl != NULL && stat(file_ctrl, &st) != 0)) {
+      /* Analog data not in cache */
+      (void) free(file_other);
+      if (file_ctrl != NULL) (void) free(file_ctrl);
+      return 0;
+    }
+    (void) fprintf(stdout, "%s: Analog days found in cache: activating output only option.\n", __FILE__);
+  }
+  else
+    return 0;
+
+  /* Replace analog data filenames of configuration */
+  if (data->conf->analog_save == TRUE) {
+    (void) free(data->conf->analog_file_other);
+    if (data->conf->period_ctrl->downscale == TRUE)
+      (void) free(data->conf->analog_file_ctrl);
+  }
+  data->conf->analog_file_other = file_other;
+  if (file_ctrl != NULL)
+    data->conf->analog_file_ctrl = file_ctrl;
+
+  data->conf->output_only = TRUE;
+  (void) set_output_only(data);
+
+  return 1;
+}
@@ -0,0 +1,105 @@
+/* ***************************************************** */
+/* Save checkpoint data of a completed                   */
+/* downscaling stage.                                    */
+/* save_checkpoint.c                                     */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file save_checkpoint.c
+    \brief Save checkpoint data of a completed downscaling stage.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+/** Save checkpoint data of a completed downscaling stage, then record the stage as completed.
+    Stage data is written in the checkpoint directory by write_stage_data. Analog days stage data is saved separately
+    as analog data files, so only the stage is recorded. */
+int
+save_checkpoint(data_struct *data, int stage, int **ntime_sub) {
+  /**
+     @param[in]  data       MASTER data structure.
+     @param[in]  stage      Completed downscaling stage.
+     @param[in]  ntime_sub  Number of times of each season, for each field category.
+     
+     \return                Status.
+  */
+
+  char *filename = NULL; /* Checkpoint data filename */
+  int istat = 0; /* Diagnostic status */
+
+  filename = (char *) malloc(MAXPATH * sizeof(char));
+  if (filename == NULL) alloc_error(__FILE__, __LINE__);
+
+  if (stage != CHECKPOINT_ANALOG) {
+    (void) sprintf(filename, "%s/stage%d.bin", data->conf->checkpoint_path, stage);
+    istat = write_stage_data(data, stage, ntime_sub, filename, data->conf->checkpoint_hash);
+    if (istat < 0) {
+      (void) free(filename);
+      return istat;
+    }
+  }
+
+  /* Record stage as completed. Streamed fields are not in memory after climatology removal: */
+  /* this stage is only recorded along with the next one. */
+  if (istat == 0) {
+    (void) sprintf(filename, "%s/%s", data->conf->checkpoint_path, "checkpoint.txt");
+    istat = write_checkpoint_state(filename, data->conf->checkpoint_hash, "stage", stage);
+  }
+  else
+    istat = 0;
+
+  (void) free(filename);
+
+  return istat;
+}
@@ -0,0 +1,383 @@
+/* ***************************************************** */
+/* Serve downscaling jobs over a local socket            */
+/* with learning data held in memory.                    */
+/* serve_downscaling.c                                   */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file serve_downscaling.c
+    \brief Serve downscaling jobs over a local socket with learning data held in memory.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+#if defined(HAVE_SYS_SOCKET_H) && defined(HAVE_SYS_UN_H) && defined(HAVE_FORK) && defined(HAVE_SYS_WAIT_H)
+
+/** Downscaling job received from a client. */
+typedef struct {
+  char *output_path; /**< Output path, or NULL to keep the configured one. */
+  char **nomvar; /**< Names of large-scale fields whose input file is replaced. */
+  char **filename; /**< Replacement input files of large-scale fields. */
+  int nfield; /**< Number of replaced large-scale field input files. */
+} serve_job_struct;
+
+static int serve_downscaling_read(serve_job_struct *job, int fd);
+static int serve_downscaling_apply(data_struct *data, serve_job_struct *job);
+static void serve_downscaling_free(serve_job_struct *job);
+static void serve_downscaling_reply(int fd, char *msg);
+static void serve_downscaling_sigchld(int sig);
+
+/** Number of finished jobs reaped by the SIGCHLD handler and not yet accounted for. */
+static volatile sig_atomic_t serve_finished = 0;
+
+/** Reap finished jobs as soon as they exit. */
+static void
+serve_downscaling_sigchld(int sig) {
+
+  int saved_errno = errno; /* Error number of interrupted code */
+  int status; /* Exit status of a finished job */
+
+  (void) sig;
+  while (waitpid(-1, &status, WNOHANG) > 0)
+    serve_finished++;
+  errno = saved_errno;
+}
+
+/** Send a one-line reply to the client. */
+static void
+serve_downscaling_reply(int fd, char *msg) {
+
+  ssize_t nw; /* Number of bytes written */
+  size_t len = strlen(msg); /* Number of bytes to write */
+
+  while (len > 0) {
+    nw = write(fd, msg, len);
+    if (nw <= 0) return;
+    msg += nw;
+    len -= (size_t) nw;
+  }
+}
+
+/** Read a job request: lines "field <name> <file>" and "output <path>" up to an empty line or end of input.
+    A "quit" line asks the service to stop. Returns 0 for a job, 1 for quit, -1 for an invalid or timed out request. */
+static int
+serve_downscaling_read(serve_job_struct *job, int fd) {
+
+  FILE *in = NULL; /* Request stream */
+  char *line = NULL; /* Request line */
+  char *cmd = NULL; /* Request keyword */
+  char *arg1 = NULL; /* First argument */
+  char *arg2 = NULL; /* Second argument */
+  char *eol = NULL; /* End of line */
+  int istat = 0; /* Diagnostic status */
+
+  job->output_path = NULL;
+  job->nomvar = NULL;
+  job->filename = NULL;
+  job->nfield = 0;
+
+  /* Read through a duplicate so that closing the stream keeps the socket open for the reply */
+  in = fdopen(dup(fd), "r");
+  if (in == NULL) return -1;
+  line = (char *) malloc(MAXPATH * sizeof(char));
+  if (line == NULL) alloc_error(__FILE__, __LINE__);
+
+  while (istat == 0 && fgets(line, MAXPATH, in) != NULL) {
+    eol = strpbrk(line, "\r\n");
+    if (eol != NULL)
+      *eol = '\0';
+    cmd = strtok(line, " \t");
+    if (cmd == NULL)
+      /* Empty line ends the request */
+      break;
+    arg1 = strtok(NULL, " \t");
+    arg2 = strtok(NULL, " \t");
+    if ( !strcmp(cmd, "quit") )
+      istat = 1;
+    else if ( !strcmp(cmd, "output") && arg1 != NULL ) {
+      if (job->output_path != NULL) (void) free(job->output_path);
+      job->output_path = strdup(arg1);
+    }
+    else if ( !strcmp(cmd, "field") && arg1 != NULL && arg2 != NULL ) {
+      job->nomvar = (char **) realloc(job->nomvar, (job->nfield+1) * sizeof(char *));
+      if (job->nomvar == NULL) alloc_error(__FILE__, __LINE__);
+      job->filename = (char **) realloc(job->filename, (job->nfield+1) * sizeof(char *));
+      if (job->filename == NULL) alloc_error(__FILE__, __LINE__);
+      job->nomvar[job->nfield] = strdup(arg1);
+      job->filename[job->nfield] = strdup(arg2);
+      job->nfield++;
+    }
+    else {
+      (void) fprintf(stderr, "%s: Invalid request line: %s\n", __FILE__, cmd);
+      istat = -1;
+    }
+  }
+
+  if (istat == 0 && ferror(in)) {
+    (void) fprintf(stderr, "%s: Cannot read request, or no request within %d seconds.\n", __FILE__, SERVE_READ_TIMEOUT);
+    istat = -1;
+  }
+
+  (void) free(line);
+  (void) fclose(in);
+
+  return istat;
+}
+
+/** Apply a job to the (process-private) MASTER data structure: replace model-run large-scale field input files and output path. */
+static int
+serve_downscaling_apply(data_struct *data, serve_job_struct *job) {
+
+  int f; /* Loop counter for replaced fields */
+  int c; /* Loop counter for model-run field categories */
+  int cat; /* Field category */
+  int i; /* Loop counter for large-scale fields */
+  int found; /* If a replaced field was found in configuration */
+
+  for (f=0; f<job->nfield; f++) {
+    found = FALSE;
+    for (c=0; c<2; c++) {
+      cat = (c == 0) ? FIELD_LS : SEC_FIELD_LS;
+      for (i=0; i<data->field[cat].n_ls; i++)
+        if ( !strcmp(data->field[cat].data[i].nomvar_ls, job->nomvar[f]) ) {
+          (void) free(data->field[cat].data[i].filename_ls);
+          data->field[cat].data[i].filename_ls = strdup(job->filename[f]);
+          found = TRUE;
+        }
+    }
+    if (found == FALSE) {
+      (void) fprintf(stderr, "%s: No model large-scale field named %s in configuration.\n", __FILE__, job->nomvar[f]);
+      return -1;
+    }
+  }
+  if (job->output_path != NULL) {
+    (void) free(data->conf->output_path);
+    data->conf->output_path = strdup(job->output_path);
+  }
+
+  return 0;
+}
+
+/** Free a job request. */
+static void
+serve_downscaling_free(serve_job_struct *job) {
+
+  int f; /* Loop counter for replaced fields */
+
+  for (f=0; f<job->nfield; f++) {
+    (void) free(job->nomvar[f]);
+    (void) free(job->filename[f]);
+  }
+  if (job->nomvar != NULL) (void) free(job->nomvar);
+  if (job->filename != NULL) (void) free(job->filename);
+  if (job->output_path != NULL) (void) free(job->output_path);
+}
+
+#endif
+
+/** Serve downscaling jobs sent over a local Unix-domain socket, with the learning data, regression points and masks
+    loaded once in the MASTER data structure. Each job replaces model-run large-scale field input files and the output path
+    of the configuration, and is downscaled in its own process so that jobs never alter the MASTER data. Up to njobs jobs run
+    concurrently. The client receives "OK" or "ERROR" when its job is done. */
+int
+serve_downscaling(data_struct *data, char *socketpath, int njobs) {
+  /**
+     @param[in]  data        MASTER data structure holding the learning data.
+     @param[in]  socketpath  Path of the Unix-domain socket to listen on.
+     @param[in]  njobs       Maximum number of jobs processed concurrently.
+     
+     \return                 Status.
+  */
+
+#if defined(HAVE_SYS_SOCKET_H) && defined(HAVE_SYS_UN_H) && defined(HAVE_FORK) && defined(HAVE_SYS_WAIT_H)
+  struct sockaddr_un addr; /* Socket address */
+  serve_job_struct job; /* Job request */
+  struct sigaction act; /* SIGCHLD handler */
+  struct timeval timeout; /* Time allowed to send a request */
+  sigset_t chld; /* Signal set holding SIGCHLD */
+  sigset_t oldmask; /* Signal mask before blocking SIGCHLD */
+  int sock; /* Listening socket */
+  int fd; /* Client connection */
+  int running = 0; /* Number of jobs being processed */
+  int istat; /* Diagnostic status */
+  int quit = FALSE; /* If service must stop */
+  pid_t pid; /* Process identifier of a job */
+  mode_t mask; /* File mode creation mask of the process */
+
+  if (strlen(socketpath) >= sizeof(addr.sun_path)) {
+    (void) fprintf(stderr, "%s: Socket path too long: %s\n", __FILE__, socketpath);
+    return -1;
+  }
+  if (njobs < 1)
+    njobs = 1;
+
+  sock = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (sock < 0) {
+    (void) fprintf(stderr, "%s: Cannot create socket: %s\n", __FILE__, strerror(errno));
+    return -1;
+  }
+  (void) memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  (void) strcpy(addr.sun_path, socketpath);
+  (void) unlink(socketpath);
+  /* Jobs write where the client asks: only the user running the service may connect */
+  mask = umask(S_IRWXG | S_IRWXO);
+  istat = bind(sock, (struct sockaddr *) &addr, sizeof(addr));
+  (void) umask(mask);
+  if (istat != 0 || chmod(socketpath, S_IRUSR | S_IWUSR) != 0 || listen(sock, 16) != 0) {
+    (void) fprintf(stderr, "%s: Cannot listen on socket %s: %s\n", __FILE__, socketpath, strerror(errno));
+    (void) close(sock);
+    return -1;
+  }
+
+  /* A client going away must not stop the service */
+  (void) signal(SIGPIPE, SIG_IGN);
+
+  /* Reap finished jobs from a signal handler, so that they never wait for the next connection */
+  serve_finished = 0;
+  (void) memset(&act, 0, sizeof(act));
+  act.sa_handler = serve_downscaling_sigchld;
+  (void) sigemptyset(&act.sa_mask);
+  act.sa_flags = SA_NOCLDSTOP | SA_RESTART;
+  (void) sigaction(SIGCHLD, &act, NULL);
+  (void) sigemptyset(&chld);
+  (void) sigaddset(&chld, SIGCHLD);
+
+  timeout.tv_sec = SERVE_READ_TIMEOUT;
+  timeout.tv_usec = 0;
+
+  (void) printf("%s: Waiting for downscaling jobs on %s, %d at a time.\n", __FILE__, socketpath, njobs);
+  (void) fflush(stdout);
+
+  while (quit == FALSE) {
+    /* Account for finished jobs, and wait for one when all jobs are busy */
+    (void) sigprocmask(SIG_BLOCK, &chld, &oldmask);
+    while (running - serve_finished >= njobs)
+      (void) sigsuspend(&oldmask);
+    running -= serve_finished;
+    serve_finished = 0;
+    (void) sigprocmask(SIG_SETMASK, &oldmask, NULL);
+
+    fd = accept(sock, NULL, NULL);
+    if (fd < 0) {
+      if (errno == EINTR) continue;
+      (void) fprintf(stderr, "%s: Cannot accept connection: %s\n", __FILE__, strerror(errno));
+      break;
+    }
+
+    /* A client which does not send its request must not block the service */
+    (void) setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    istat = serve_downscaling_read(&job, fd);
+    if (istat == 1) {
+      quit = TRUE;
+      serve_downscaling_reply(fd, "OK\n");
+    }
+    else if (istat != 0)
+      serve_downscaling_reply(fd, "ERROR invalid request\n");
+    else {
+      (void) fflush(stdout);
+      (void) fflush(stderr);
+      pid = fork();
+      if (pid == 0) {
+        /* Job process: its copy of MASTER data can be changed freely */
+        (void) close(sock);
+        (void) signal(SIGCHLD, SIG_DFL);
+        /* Checkpoints of the MASTER configuration do not describe this job */
+        data->conf->checkpoint_path = NULL;
+        data->conf->checkpoint_stage = CHECKPOINT_NONE;
+        istat = serve_downscaling_apply(data, &job);
+        /* Cached products of this job depend on its input files */
+        if (istat == 0 && data->conf->cache_path != NULL) {
+          istat = cache_hash(data);
+          if (istat == 0)
+            (void) reuse_analog_data(data);
+        }
+        if (istat == 0) {
+          (void) printf("\n**** DOWNSCALING JOB ****\n\n");
+          istat = wt_downscaling(data);
+        }
+        serve_downscaling_reply(fd, (istat == 0) ? "OK\n" : "ERROR downscaling failed\n");
+        (void) fflush(stdout);
+        _exit( (istat == 0) ? 0 : 1 );
+      }
+      else if (pid < 0) {
+        (void) fprintf(stderr, "%s: Cannot create process for job: %s\n", __FILE__, strerror(errno));
+        serve_downscaling_reply(fd, "ERROR cannot create process\n");
+      }
+      else
+        running++;
+    }
+    serve_downscaling_free(&job);
+    (void) close(fd);
+  }
+
+  /* Wait for remaining jobs */
+  (void) sigprocmask(SIG_BLOCK, &chld, &oldmask);
+  while (running - serve_finished > 0)
+    (void) sigsuspend(&oldmask);
+  serve_finished = 0;
+  (void) sigprocmask(SIG_SETMASK, &oldmask, NULL);
+  (void) signal(SIGCHLD, SIG_DFL);
+
+  (void) close(sock);
+  (void) unlink(socketpath);
+
+  return 0;
+#else
+  (void) fprintf(stderr, "%s: Service mode needs Unix-domain sockets and fork, which are not available. Cannot serve on %s with %d jobs.\n",
+                 __FILE__, socketpath, njobs);
+  return -1;
+#endif
+}
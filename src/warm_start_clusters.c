@@ -0,0 +1,152 @@
+/* ***************************************************** */
+/* Warm-start clusters of a season from                  */
+/* previously saved weights.                             */
+/* warm_start_clusters.c                                 */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file warm_start_clusters.c
+    \brief Warm-start clusters of a season from previously saved weights.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+/** Compute clusters of a season by warm-starting the classification algorithm from the cluster centers (weights)
+    of a previous learning, so that an extended learning period does not need all the partitions from random initial points. */
+int
+warm_start_clusters(double *clusters, double *pc_eof_days, data_struct *data, int s, int ntime) {
+  /**
+     @param[out]  clusters     Clusters' positions for reanalysis and observation EOFs.
+     @param[in]   pc_eof_days  Merged reanalysis and observation Principal Components of EOF (daily data).
+     @param[in]   data         MASTER data structure.
+     @param[in]   s            Season index.
+     @param[in]   ntime        Number of days of the season in the learning period.
+     
+     \return                   Number of iterations, or -1 on error.
+  */
+
+  int istat; /* Diagnostic status */
+  int niter; /* Number of iterations of the classification algorithm */
+  double *weight = NULL; /* Previous weights (reanalysis EOFs only) */
+  int *class_clusters = NULL; /* Classification of days in previous clusters */
+  int *ndays_cluster = NULL; /* Number of days in each cluster */
+  pc_days_struct pc_days; /* Principal Components in day-major layout */
+  char *nomvar = NULL; /* NetCDF variable name */
+  char *name = NULL; /* NetCDF clusters dimension name */
+  int neof_file; /* EOF dimension in weight file */
+  int nclusters_file; /* Clusters dimension in weight file */
+  int rea_neof = data->learning->rea_neof; /* Number of reanalysis EOFs */
+  int neof = data->learning->rea_neof + data->learning->obs_neof; /* Number of merged EOFs */
+  int nclusters = data->conf->season[s].nclusters; /* Number of clusters */
+  double shift; /* Distance between new and previous cluster center */
+  int clust; /* Loop counter for clusters */
+  int eof; /* Loop counter for EOFs */
+
+  nomvar = (char *) malloc(500 * sizeof(char));
+  if (nomvar == NULL) alloc_error(__FILE__, __LINE__);
+  name = (char *) malloc(500 * sizeof(char));
+  if (name == NULL) alloc_error(__FILE__, __LINE__);
+
+  /* Read previous weights of this season */
+  (void) sprintf(nomvar, "%s_%d", data->learning->nomvar_weight, s+1);
+  (void) sprintf(name, "%s_%d", data->conf->clustname, s+1);
+  istat = read_netcdf_var_2d(&weight, (info_field_struct *) NULL, (proj_struct *) NULL,
+                             data->learning->filename_open_weight, nomvar, data->conf->eofname, name,
+                             &neof_file, &nclusters_file, TRUE);
+  (void) free(nomvar);
+  (void) free(name);
+  if (istat != 0) {
+    (void) free(weight);
+    return -1;
+  }
+  if (neof_file != rea_neof || nclusters_file != nclusters) {
+    (void) fprintf(stderr, "%s: ERROR: Dimensions of previous learning weights (%d EOFs, %d clusters) for season %d do not match the configuration (%d EOFs, %d clusters)!\n",
+                   __FILE__, neof_file, nclusters_file, s, rea_neof, nclusters);
+    (void) free(weight);
+    return -1;
+  }
+
+  /* Previous weights only span the reanalysis EOFs: classify days with them and use the barycenters
+     of the days of each cluster as initial cluster centers for all merged EOFs */
+  class_clusters = (int *) malloc(ntime * sizeof(int));
+  if (class_clusters == NULL) alloc_error(__FILE__, __LINE__);
+  ndays_cluster = (int *) malloc(nclusters * sizeof(int));
+  if (ndays_cluster == NULL) alloc_error(__FILE__, __LINE__);
+  (void) pack_pc_days(&pc_days, pc_eof_days, neof, ntime);
+  (void) class_days_pc_clusters(class_clusters, &pc_days, weight, data->conf->classif_type, rea_neof, nclusters);
+
+  (void) update_clusters_centroid(clusters, ndays_cluster, &pc_days, class_clusters, nclusters);
+  for (clust=0; clust<nclusters; clust++)
+    if (ndays_cluster[clust] == 0)
+      for (eof=0; eof<rea_neof; eof++)
+        clusters[eof+clust*neof] = weight[eof+clust*rea_neof];
+
+  niter = generate_clusters(clusters, &pc_days, data->conf->classif_type, "provided", data->conf->nclassifications,
+                            nclusters, data->conf->classif_seed, data->conf->classif_tolerance);
+
+  /* Report how far each cluster moved from previous learning */
+  for (clust=0; clust<nclusters; clust++) {
+    shift = 0.0;
+    for (eof=0; eof<rea_neof; eof++)
+      shift += (clusters[eof+clust*neof] - weight[eof+clust*rea_neof]) * (clusters[eof+clust*neof] - weight[eof+clust*rea_neof]);
+    (void) fprintf(stdout, "%s: Season %d cluster %d: distance to previous cluster center = %lf\n", __FILE__, s, clust, sqrt(shift));
+  }
+
+  (void) free_pc_days(&pc_days);
+  (void) free(class_clusters);
+  (void) free(ndays_cluster);
+  (void) free(weight);
+
+  return niter;
+}
@@ -0,0 +1,105 @@
+/* ***************************************************** */
+/* Write an array in a cache file.                       */
+/* write_cache_array.c                                   */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file write_cache_array.c
+    \brief Write an array in a cache file.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+/** Write an array in a cache file (native byte order), preceded by the key it was computed with and its number of
+    elements. The file is written under a temporary name, then renamed: an interrupted write never leaves a truncated file. */
+int
+write_cache_array(char *filename, char *key, double *buf, size_t n) {
+  /**
+     @param[in]  filename  Cache filename.
+     @param[in]  key       Key of configuration and input files.
+     @param[in]  buf       Array.
+     @param[in]  n         Number of elements.
+     
+     \return               Status.
+  */
+
+  FILE *outfile = NULL; /* Cache file pointer */
+  char *filename_tmp = NULL; /* Temporary cache filename */
+  int istat; /* Diagnostic status */
+
+  filename_tmp = (char *) malloc(MAXPATH * sizeof(char));
+  if (filename_tmp == NULL) alloc_error(__FILE__, __LINE__);
+  (void) sprintf(filename_tmp, "%s.tmp", filename);
+
+  outfile = fopen(filename_tmp, "wb");
+  if (outfile == NULL) {
+    (void) fprintf(stderr, "%s: Cannot open cache file %s for writing: %s\n", __FILE__, filename_tmp, strerror(errno));
+    (void) free(filename_tmp);
+    return -1;
+  }
+  (void) fwrite(key, sizeof(char), strlen(key)+1, outfile);
+  (void) fwrite(&n, sizeof(size_t), 1, outfile);
+  (void) fwrite(buf, sizeof(double), n, outfile);
+
+  istat = ferror(outfile);
+  if (fclose(outfile) != 0 || istat != 0 || rename(filename_tmp, filename) != 0) {
+    (void) fprintf(stderr, "%s: Cannot write cache file %s: %s\n", __FILE__, filename, strerror(errno));
+    (void) free(filename_tmp);
+    return -1;
+  }
+  (void) free(filename_tmp);
+
+  /* Success status */
+  return 0;
+}
@@ -0,0 +1,105 @@
+/* ***************************************************** */
+/* Write checkpoint state file.                          */
+/* write_checkpoint_state.c                              */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file write_checkpoint_state.c
+    \brief Write checkpoint state file.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+/** Write checkpoint state file: the hash validating checkpoint files and one state value.
+    The file is written under a temporary name then renamed, so that it is never left incomplete when the process is killed. */
+int
+write_checkpoint_state(char *filename, char *hash, char *key, int value) {
+  /**
+     @param[in]  filename  Checkpoint state filename.
+     @param[in]  hash      Hash of configuration and input files.
+     @param[in]  key       Name of the state value.
+     @param[in]  value     State value.
+     
+     \return               Status.
+  */
+
+  FILE *outfile = NULL; /* Checkpoint state file pointer */
+  char *filename_tmp = NULL; /* Temporary filename */
+  int istat; /* Diagnostic status */
+
+  filename_tmp = (char *) malloc((strlen(filename)+5) * sizeof(char));
+  if (filename_tmp == NULL) alloc_error(__FILE__, __LINE__);
+  (void) sprintf(filename_tmp, "%s.tmp", filename);
+
+  outfile = fopen(filename_tmp, "w");
+  if (outfile == NULL) {
+    (void) fprintf(stderr, "%s: Cannot open checkpoint file %s for writing: %s\n", __FILE__, filename_tmp, strerror(errno));
+    (void) free(filename_tmp);
+    return -1;
+  }
+  (void) fprintf(outfile, "hash %s\n%s %d\n", hash, key, value);
+  istat = fclose(outfile);
+  if (istat == 0)
+    istat = rename(filename_tmp, filename);
+  if (istat != 0) {
+    (void) fprintf(stderr, "%s: Cannot write checkpoint file %s: %s\n", __FILE__, filename, strerror(errno));
+    (void) free(filename_tmp);
+    return -1;
+  }
+
+  (void) free(filename_tmp);
+
+  /* Success status */
+  return 0;
+}
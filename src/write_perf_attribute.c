@@ -0,0 +1,109 @@
+/* ***************************************************** */
+/* write_perf_attribute Write performance report         */
+/* as a NetCDF global attribute.                         */
+/* write_perf_attribute.c                                */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file write_perf_attribute.c
+    \brief Write the performance report of downscaling stages as a global attribute of a NetCDF file.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+/** Write the performance report of the downscaling stages measured so far as the dsclim_performance global attribute
+    of a NetCDF file. */
+int
+write_perf_attribute(char *filename) {
+  /**
+     @param[in]  filename   NetCDF filename.
+
+     \return                Status.
+  */
+
+  char *report = NULL; /* Report text */
+  int ncoutid; /* NetCDF output file ID */
+  int istat; /* Diagnostic status */
+
+  istat = nc_open(filename, NC_WRITE, &ncoutid);
+  if (istat != NC_NOERR) {
+    handle_netcdf_error(istat, __FILE__, __LINE__);
+    return -1;
+  }
+  istat = nc_redef(ncoutid);
+  if (istat != NC_NOERR) {
+    handle_netcdf_error(istat, __FILE__, __LINE__);
+    (void) ncclose(ncoutid);
+    return -1;
+  }
+
+  report = perf_report();
+  istat = nc_put_att_text(ncoutid, NC_GLOBAL, "dsclim_performance", strlen(report), report);
+  (void) free(report);
+  if (istat != NC_NOERR) {
+    handle_netcdf_error(istat, __FILE__, __LINE__);
+    (void) ncclose(ncoutid);
+    return -1;
+  }
+
+  istat = nc_enddef(ncoutid);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __FILE__, __LINE__);
+  istat = ncclose(ncoutid);
+  if (istat != NC_NOERR) {
+    handle_netcdf_error(istat, __FILE__, __LINE__);
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,95 @@
+/* ***************************************************** */
+/* write_perf_report Write performance report.           */
+/* write_perf_report.c                                   */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file write_perf_report.c
+    \brief Write the performance report of downscaling stages in JSON format.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+/** Write the performance report of the downscaling stages measured so far to a file, in JSON format. */
+int
+write_perf_report(char *filename) {
+  /**
+     @param[in]  filename   Report filename.
+
+     \return                Status.
+  */
+
+  FILE *outfile = NULL; /* Report file */
+  char *report = NULL; /* Report text */
+
+  report = perf_report();
+
+  outfile = fopen(filename, "w");
+  if (outfile == NULL) {
+    (void) fprintf(stderr, "%s: Cannot open performance report file %s: %s\n", __FILE__, filename, strerror(errno));
+    (void) free(report);
+    return -1;
+  }
+  (void) fputs(report, outfile);
+  if (fclose(outfile) != 0) {
+    (void) fprintf(stderr, "%s: Cannot write performance report file %s: %s\n", __FILE__, filename, strerror(errno));
+    (void) free(report);
+    return -1;
+  }
+  (void) printf("%s: Performance report written to %s\n", __FILE__, filename);
+
+  (void) free(report);
+
+  return 0;
+}
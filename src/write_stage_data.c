@@ -0,0 +1,191 @@
+/* ***************************************************** */
+/* Write data of a completed downscaling stage           */
+/* in a binary file.                                     */
+/* write_stage_data.c                                    */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/* Date of creation: oct 2026                            */
+/* Last date of modification: oct 2026                   */
+/* ***************************************************** */
+/* Original version: 1.0                                 */
+/* Current revision:                                     */
+/* ***************************************************** */
+/* Revisions                                             */
+/* ***************************************************** */
+/*! \file write_stage_data.c
+    \brief Write data of a completed downscaling stage in a binary file.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#include <dsclim.h>
+
+static void write_stage_array(FILE *outfile, void *buf, size_t size, size_t n);
+
+/** Write an array preceded by its number of elements in a stage data file. */
+static void
+write_stage_array(FILE *outfile, void *buf, size_t size, size_t n) {
+  /**
+     @param[in]  outfile  Stage data file pointer.
+     @param[in]  buf      Array.
+     @param[in]  size     Size of one element.
+     @param[in]  n        Number of elements.
+  */
+
+  (void) fwrite(&n, sizeof(size_t), 1, outfile);
+  if (n > 0)
+    (void) fwrite(buf, size, n, outfile);
+}
+
+/** Write data of a completed downscaling stage in a binary file (native byte order), preceded by a hash identifying
+    the configuration and input files it was computed with. The file is written under a temporary name, then renamed:
+    an interrupted write never leaves a truncated file. */
+int
+write_stage_data(data_struct *data, int stage, int **ntime_sub, char *filename, char *hash) {
+  /**
+     @param[in]  data       MASTER data structure.
+     @param[in]  stage      Completed downscaling stage (CHECKPOINT_CLIM, CHECKPOINT_EOF or CHECKPOINT_CLASS).
+     @param[in]  ntime_sub  Number of times of each season, for each field category.
+     @param[in]  filename   Stage data filename.
+     @param[in]  hash       Hash of configuration and input files.
+     
+     \return                Status: 1 when stage data is incomplete because some fields are streamed.
+  */
+
+  FILE *outfile = NULL; /* Stage data file pointer */
+  char *filename_tmp = NULL; /* Temporary stage data filename */
+  int complete = TRUE; /* If all stage data is in memory */
+  int end_cat; /* End category to process */
+  int cat; /* Loop counter for field categories */
+  int i; /* Loop counter for large-scale fields */
+  int s; /* Loop counter for seasons */
+  int istat; /* Diagnostic status */
+
+  filename_tmp = (char *) malloc(MAXPATH * sizeof(char));
+  if (filename_tmp == NULL) alloc_error(__FILE__, __LINE__);
+
+  if (data->conf->period_ctrl->downscale == TRUE)
+    end_cat = CTRL_FIELD_LS;
+  else
+    end_cat = FIELD_LS;
+
+  (void) sprintf(filename_tmp, "%s.tmp", filename);
+  outfile = fopen(filename_tmp, "wb");
+  if (outfile == NULL) {
+    (void) fprintf(stderr, "%s: Cannot open file %s for writing: %s\n", __FILE__, filename_tmp, strerror(errno));
+    (void) free(filename_tmp);
+    return -1;
+  }
+  (void) printf("%s: Writing data of stage %d in %s\n", __FILE__, stage, filename);
+
+  write_stage_array(outfile, hash, sizeof(char), strlen(hash)+1);
+  write_stage_array(outfile, &stage, sizeof(int), 1);
+
+  if (stage == CHECKPOINT_CLIM) {
+    /* Large-scale fields with climatology removed. Streamed fields are not in memory: their climatology is removed */
+    /* while projecting them on EOFs, so stage data is incomplete. */
+    for (cat=0; cat<NCAT; cat++)
+      for (i=0; i<data->field[cat].n_ls; i++) {
+        if (data->field[cat].data[i].field_ls != NULL)
+          write_stage_array(outfile, data->field[cat].data[i].field_ls, sizeof(double),
+                            (size_t) data->field[cat].nlon_ls * data->field[cat].nlat_ls * data->field[cat].ntime_ls);
+        else
+          complete = FALSE;
+      }
+  }
+  else if (stage == CHECKPOINT_EOF) {
+    /* Large-scale fields projected on EOFs */
+    for (cat=FIELD_LS; cat<=CTRL_FIELD_LS; cat++)
+      for (i=0; i<data->field[cat].n_ls; i++)
+        if (data->field[cat].data[i].eof_info->eof_project == TRUE)
+          write_stage_array(outfile, data->field[cat].data[i].field_eof_ls, sizeof(double),
+                            (size_t) data->field[cat].ntime_ls * data->field[cat].data[i].eof_info->neof_ls);
+  }
+  else if (stage == CHECKPOINT_CLASS) {
+    /* Normalized distances to clusters, classification and regression index of downscaled days, */
+    /* normalized secondary large-scale fields, and control-run statistics of secondary large-scale fields */
+    for (cat=FIELD_LS; cat<=end_cat; cat++) {
+      write_stage_array(outfile, ntime_sub[cat], sizeof(int), (size_t) data->conf->nseasons);
+      write_stage_array(outfile, ntime_sub[cat+2], sizeof(int), (size_t) data->conf->nseasons);
+      for (i=0; i<data->field[cat].n_ls; i++)
+        for (s=0; s<data->conf->nseasons; s++) {
+          write_stage_array(outfile, data->field[cat].data[i].down->dist[s], sizeof(double),
+                            (size_t) data->conf->season[s].nclusters * ntime_sub[cat][s]);
+          write_stage_array(outfile, data->field[cat].data[i].down->days_class_clusters[s], sizeof(int),
+                            (size_t) ntime_sub[cat][s]);
+        }
+      if (data->field[cat].n_ls > 0)
+        for (s=0; s<data->conf->nseasons; s++)
+          write_stage_array(outfile, data->field[cat].precip_index[s], sizeof(double),
+                            (size_t) data->reg->npts * ntime_sub[cat+2][s]);
+      for (i=0; i<data->field[cat+2].n_ls; i++)
+        for (s=0; s<data->conf->nseasons; s++) {
+          write_stage_array(outfile, data->field[cat+2].data[i].down->smean_norm[s], sizeof(double),
+                            (size_t) ntime_sub[cat+2][s]);
+          write_stage_array(outfile, data->field[cat+2].data[i].down->sup_val_norm[s], sizeof(double),
+                            (size_t) data->field[cat+2].nlon_ls * data->field[cat+2].nlat_ls * ntime_sub[cat+2][s]);
+        }
+    }
+    for (i=0; i<data->field[CTRL_SEC_FIELD_LS].n_ls; i++) {
+      write_stage_array(outfile, data->field[CTRL_SEC_FIELD_LS].data[i].down->mean, sizeof(double), (size_t) data->conf->nseasons);
+      write_stage_array(outfile, data->field[CTRL_SEC_FIELD_LS].data[i].down->var, sizeof(double), (size_t) data->conf->nseasons);
+    }
+  }
+
+  istat = ferror(outfile);
+  if (fclose(outfile) != 0 || istat != 0 || rename(filename_tmp, filename) != 0) {
+    (void) fprintf(stderr, "%s: Cannot write file %s: %s\n", __FILE__, filename, strerror(errno));
+    (void) free(filename_tmp);
+    return -1;
+  }
+
+  (void) free(filename_tmp);
+
+  if (complete == FALSE)
+    return 1;
+
+  /* Success status */
+  return 0;
+}
@@ -79,6 +79,7 @@ wt_downscaling(data_struct *data) {
   double *lon_mask = NULL; /* Longitudes of mask */
   double *lat_mask = NULL; /* Latitudes of mask */
   double *var_pc_norm_all = NULL; /* Temporary values of the norm of the principal components */
+  pc_days_struct pc_days; /* Principal components of a season, packed day-major */
   int **ntime_sub = NULL; /* Number of times for sub-periods. Dimensions number of field categories (NCAT) and number of seasons */
   double **time_ls_sub = NULL; /* Time values used for regression diagnostics output */
   int *merged_itimes = NULL; /* Time values in common merged time vector */
@@ -103,7 +104,42 @@ wt_downscaling(data_struct *data) {
   char *analog_file = NULL; /* Analog data filename */
   period_struct *period = NULL; /* Period structure for output */
 
-  char *filename = NULL; /* Temporary filename for regression optional output */
+  char *filename = NULL; /* Temporary filename for regression optional output and checkpoint files */
+  char *filename_tmp = NULL; /* Temporary filename for checkpoint and cached analog data */
+  double *merged_times_cat[NCAT]; /* Merge times in udunit for each field category */
+  int resume; /* Last downscaling stage completed by a previous interrupted run */
+  int cached; /* Last downscaling stage found in cache, beyond the one completed by a previous interrupted run */
+  int stage; /* Loop counter for downscaling stages */
+  int dest; /* Loop counter for analog data destinations: checkpoint and cache */
+  char *cachefile = NULL; /* Cache filename of intermediate products */
+  struct stat st; /* File information */
+  int year_done; /* Last output year completely written by a previous interrupted run */
+  int perf; /* Performance measurement stage */
+
+  /* Resume from checkpoints if a previous run with the same configuration and input files was interrupted */
+  if (data->conf->checkpoint_path != NULL) {
+    resume = data->conf->checkpoint_stage;
+    /* Create checkpoint directory before the first checkpoint is written */
+    if (mkdir(data->conf->checkpoint_path, 0755) != 0 && errno != EEXIST) {
+      (void) fprintf(stderr, "%s: Cannot create checkpoint directory %s: %s\n", __FILE__, data->conf->checkpoint_path, strerror(errno));
+      return -1;
+    }
+  }
+  else
+    resume = CHECKPOINT_NONE;
+
+  /* Reuse intermediate products cached by a previous run with the same configuration and input files */
+  cached = CHECKPOINT_NONE;
+  if (data->conf->cache_path != NULL && data->conf->output_only != TRUE) {
+    for (stage=CHECKPOINT_EOF; stage<=CHECKPOINT_CLASS; stage++) {
+      cachefile = cache_filename(data, stage, (stage == CHECKPOINT_EOF) ? "eof.bin" : "class.bin");
+      if (stat(cachefile, &st) == 0)
+        cached = stage;
+      (void) free(cachefile);
+    }
+    if (cached <= resume)
+      cached = CHECKPOINT_NONE;
+  }
   
   if (data->conf->output_only != TRUE) {
   
@@ -122,8 +158,13 @@ wt_downscaling(data_struct *data) {
     }
 
     /** Step 1: Read large-scale fields **/
+    perf = perf_begin("read_large_scale_fields");
     istat = read_large_scale_fields(data);
-    if (istat != 0) return istat;
+    if (istat != 0) {
+      (void) perf_end(perf);
+      return istat;
+    }
+    (void) perf_end(perf);
     
     /* Prepare optional mask for secondary large-scale fields */
     if (data->secondary_mask->use_mask == TRUE) {
@@ -165,359 +206,482 @@ wt_downscaling(data_struct *data) {
     if (mask_sub != NULL)
       printf("%s: Using a mask for secondary large-scale fields.\n", __FILE__);
 
+    /* Classification stage in cache is loaded first: when it cannot be read, the stages before it are computed */
+    if (cached == CHECKPOINT_CLASS) {
+      perf = perf_begin("classification");
+      cachefile = cache_filename(data, CHECKPOINT_CLASS, "class.bin");
+      istat = read_stage_data(data, CHECKPOINT_CLASS, ntime_sub, cachefile, data->conf->cache_key[CHECKPOINT_CLASS]);
+      (void) free(cachefile);
+      if (istat != 0) {
+        (void) fprintf(stderr, "%s: WARNING: Cannot read classification stage in cache: computing it again.\n", __FILE__);
+        cachefile = cache_filename(data, CHECKPOINT_EOF, "eof.bin");
+        if (resume < CHECKPOINT_EOF && stat(cachefile, &st) == 0)
+          cached = CHECKPOINT_EOF;
+        else
+          cached = CHECKPOINT_NONE;
+        (void) free(cachefile);
+      }
+      (void) perf_end(perf);
+    }
+
     /** Step 2: Compute climatologies and remove them from selected large scale fields **/
-    istat = remove_clim(data);
-    if (istat != 0) return istat;  
+    perf = perf_begin("climatology");
+    if (resume < CHECKPOINT_CLIM && cached < CHECKPOINT_CLASS) {
+      istat = remove_clim(data);
+      if (istat != 0) {
+        (void) perf_end(perf);
+        return istat;
+      }
+      /* Record climatology removal stage */
+      if (data->conf->checkpoint_path != NULL)
+        (void) save_checkpoint(data, CHECKPOINT_CLIM, ntime_sub);
+    }
+    else if (resume < CHECKPOINT_CLASS && cached < CHECKPOINT_CLASS) {
+      /* Climatology removal stage was completed by a previous interrupted run */
+      istat = read_checkpoint(data, CHECKPOINT_CLIM, ntime_sub);
+      if (istat != 0) {
+        (void) perf_end(perf);
+        return istat;
+      }
+    }
+    (void) perf_end(perf);
 
     /** Step 3: Project selected large scale fields on EOF **/  
-
-    /* Read EOFs and Singular Values */
-    istat = read_large_scale_eof(data);
-    if (istat != 0) return istat;
-  
-    /* Project selected large scale fields on EOF */
-    /* Loop over large-scale field categories (Control run and Model run) */
-    for (cat=CTRL_FIELD_LS; cat>=FIELD_LS; cat--)
-      /* Loop over large-scale fields */
-      for (i=0; i<data->field[cat].n_ls; i++) {
-        /* Check if we need to project field on EOFs */
-        if (data->field[cat].data[i].eof_info->eof_project == TRUE) {
-          /* Allocate memory for projected large-scale field */
-          data->field[cat].data[i].field_eof_ls = (double *) malloc(data->field[cat].ntime_ls * data->field[cat].data[i].eof_info->neof_ls *
-                                                                    sizeof(double));
-          if (data->field[cat].data[i].field_eof_ls == NULL) alloc_error(__FILE__, __LINE__);
-          /* Project large-scale field on EOFs */
-          istat = project_field_eof(data->field[cat].data[i].field_eof_ls, data->field[cat].data[i].field_ls,
-                                    data->field[cat].data[i].eof_data->eof_ls, data->field[cat].data[i].eof_data->sing_ls,
-                                    data->field[cat].data[i].eof_info->info->fillvalue, 
-                                    data->field[cat].lon_eof_ls, data->field[cat].lat_eof_ls, 
-                                    data->field[cat].data[i].eof_info->eof_scale,
-                                    data->field[cat].nlon_eof_ls, data->field[cat].nlat_eof_ls, data->field[cat].ntime_ls,
-                                    data->field[cat].data[i].eof_info->neof_ls);
-          if (istat != 0) return istat;
-        }
+    perf = perf_begin("eof_projection");
+
+    if (cached == CHECKPOINT_EOF) {
+      /* EOF projection stage was computed by a previous run */
+      cachefile = cache_filename(data, CHECKPOINT_EOF, "eof.bin");
+      istat = read_stage_data(data, CHECKPOINT_EOF, ntime_sub, cachefile, data->conf->cache_key[CHECKPOINT_EOF]);
+      (void) free(cachefile);
+      if (istat != 0) {
+        (void) fprintf(stderr, "%s: WARNING: Cannot read EOF projection stage in cache: computing it again.\n", __FILE__);
+        cached = CHECKPOINT_NONE;
       }
+    }
 
+    if (resume < CHECKPOINT_EOF && cached < CHECKPOINT_EOF) {
 
-    /** CONTROL RUN **/
-
-    /** Step 4: Compute distance to clusters for the control run **/
-    /* Process control run only */
-    cat = CTRL_FIELD_LS;
-    /* Loop over large-scale fields */
-    for (i=0; i<data->field[cat].n_ls; i++) {
-
-      /* Allocate memory for temporary buffer */
-      buftmp = (double *) malloc(data->field[cat].ntime_ls*data->field[cat].data[i].eof_info->neof_ls * sizeof(double));
-      if (buftmp == NULL) alloc_error(__FILE__, __LINE__); 
-
-      /* Normalisation of the principal component by the square root of the variance of the first one */
-      /* Select common time period between the learning period and the model period (control run) */
-      /* for first variance calculation */
-      istat = sub_period_common(&buf_sub, &ntime_sub_learn_all, data->field[cat].data[i].field_eof_ls,
-                                data->field[cat].time_s->year, data->field[cat].time_s->month, data->field[cat].time_s->day,
-                                data->learning->time_s->year, data->learning->time_s->month,
-                                data->learning->time_s->day, 1,
-                                data->field[cat].data[i].eof_info->neof_ls, 1, data->field[cat].ntime_ls, data->learning->ntime);
-      if (istat != 0) return istat;
-
-      /* Allocate memory for temporary buffer */
-      buftmpf = (double *) malloc(ntime_sub_learn_all*data->field[cat].data[i].eof_info->neof_ls * sizeof(double));
-      if (buftmpf == NULL) alloc_error(__FILE__, __LINE__); 
-
-      //    for (s=0; s<data->field[cat].ntime_ls; s++)
-      //      printf("%d %lf\n",s,data->field[cat].data[i].field_eof_ls[s]);
-
-      /* Compute the norm and the variance of the first EOF of the control run as references */
-      printf("Compute the norm and the variance of the first EOF of the control run as references\n");
-      /* Only when first_variance is -9999.9999, the variance of the first EOF will be computed */
-      data->field[cat].data[i].first_variance = -9999.9999;
-      (void) normalize_pc(data->field[cat].data[i].down->var_pc_norm, &(data->field[cat].data[i].first_variance),
-                          buftmpf, buf_sub, data->field[cat].data[i].eof_info->neof_ls,
-                          ntime_sub_learn_all);
-      //    for (ii=0; ii<9; ii++) printf("%d %lf\n",ii,sqrt(data->field[cat].data[i].down->var_pc_norm[ii]));
-      /* Free temporary buffers */
-      (void) free(buf_sub);
-      (void) free(buftmpf);
-
-      /* Normalize the large-scale field given the reference norm and variance */
-      printf("Normalize the large-scale field given the reference norm and variance.\n");
-      /* Allocate memory for temporary buffer */
-      var_pc_norm_all = (double *) malloc(data->field[cat].data[i].eof_info->neof_ls * sizeof(double));
-      if (var_pc_norm_all == NULL) alloc_error(__FILE__, __LINE__);
-      /* Normalize EOF-projected large-scale fields */
-      (void) normalize_pc(var_pc_norm_all, &(data->field[cat].data[i].first_variance),
-                          buftmp, data->field[cat].data[i].field_eof_ls, data->field[cat].data[i].eof_info->neof_ls,
-                          data->field[cat].ntime_ls);
-      /* Free temporary buffer */
-      (void) free(var_pc_norm_all);
-
-      /* Loop over each season */
-      for (s=0; s<data->conf->nseasons; s++) {
-        /* Compute mean and variance of principal components of selected large-scale fields */
-
-        /* Allocate memory for season-specific mean and variance of distances to clusters */
-        data->field[cat].data[i].down->mean_dist[s] = (double *) malloc(data->conf->season[s].nclusters * sizeof(double));
-        if (data->field[cat].data[i].down->mean_dist[s] == NULL) alloc_error(__FILE__, __LINE__);
-        data->field[cat].data[i].down->var_dist[s] = (double *) malloc(data->conf->season[s].nclusters * sizeof(double));
-        if (data->field[cat].data[i].down->var_dist[s] == NULL) alloc_error(__FILE__, __LINE__);
-      
-        /* Select common time period between the learning period and the model period (control run) */
-        istat = sub_period_common(&buf_sub, &ntime_sub_learn, buftmp,
-                                  data->field[cat].time_s->year, data->field[cat].time_s->month, data->field[cat].time_s->day,
-                                  data->learning->data[s].time_s->year, data->learning->data[s].time_s->month,
-                                  data->learning->data[s].time_s->day, 1,
-                                  data->field[cat].data[i].eof_info->neof_ls, 1, data->field[cat].ntime_ls, data->learning->data[s].ntime);
-        if (istat != 0) return istat;
-      
-        /* Compute mean and variance of distances to clusters */
-        (void) mean_variance_dist_clusters(data->field[cat].data[i].down->mean_dist[s], data->field[cat].data[i].down->var_dist[s],
-                                           buf_sub, data->learning->data[s].weight,
-                                           data->learning->pc_normalized_var, data->field[cat].data[i].down->var_pc_norm,
-                                           data->field[cat].data[i].eof_info->neof_ls, data->conf->season[s].nclusters, ntime_sub_learn);
-        /* Diagnostic output */
-        printf("Season: %d\n", s);
-        for (ii=0; ii<data->conf->season[s].nclusters; ii++)
-          (void) printf("%s: Cluster #%d. Mean and variance of distances to clusters for control run: %lf %lf\n", __FILE__, ii,
-                        data->field[cat].data[i].down->mean_dist[s][ii], sqrt(data->field[cat].data[i].down->var_dist[s][ii]));
+      /* Read EOFs and Singular Values */
+      istat = read_large_scale_eof(data);
+      if (istat != 0) {
+        (void) perf_end(perf);
+        return istat;
+      }
 
-        /* Free temporary buffer */
-        (void) free(buf_sub);
+      /* Compute EOFs and Singular Values when they are not provided */
+      istat = compute_large_scale_eof(data);
+      if (istat != 0) {
+        (void) perf_end(perf);
+        return istat;
+      }
+  
+      /* Project selected large scale fields on EOF */
+      /* Loop over large-scale field categories (Control run and Model run) */
+      for (cat=CTRL_FIELD_LS; cat>=FIELD_LS; cat--)
+        /* Loop over large-scale fields */
+        for (i=0; i<data->field[cat].n_ls; i++) {
+          /* Check if we need to project field on EOFs */
+          if (data->field[cat].data[i].eof_info->eof_project == TRUE) {
+            /* Allocate memory for projected large-scale field */
+            data->field[cat].data[i].field_eof_ls = (double *) malloc(data->field[cat].ntime_ls * data->field[cat].data[i].eof_info->neof_ls *
+                                                                      sizeof(double));
+            if (data->field[cat].data[i].field_eof_ls == NULL) alloc_error(__FILE__, __LINE__);
+            /* Project large-scale field on EOFs */
+            if (data->field[cat].data[i].field_ls == NULL)
+              /* Field was not read in memory: stream it by chunks */
+              istat = project_large_scale_field_stream(data, cat, i);
+            else
+              istat = project_field_eof(data->field[cat].data[i].field_eof_ls, data->field[cat].data[i].field_ls,
+                                      data->field[cat].data[i].eof_data->eof_ls, data->field[cat].data[i].eof_data->sing_ls,
+                                      data->field[cat].data[i].eof_info->info->fillvalue, 
+                                      data->field[cat].lon_eof_ls, data->field[cat].lat_eof_ls, 
+                                      data->field[cat].data[i].eof_info->eof_scale,
+                                      data->field[cat].nlon_eof_ls, data->field[cat].nlat_eof_ls, data->field[cat].ntime_ls,
+                                      data->field[cat].data[i].eof_info->neof_ls);
+            if (istat != 0) {
+              (void) perf_end(perf);
+              return istat;
+            }
+          }
+        }
+
+      /* Record EOF projection stage */
+      if (data->conf->checkpoint_path != NULL)
+        (void) save_checkpoint(data, CHECKPOINT_EOF, ntime_sub);
+      /* Store large-scale fields projected on EOFs in cache */
+      if (data->conf->cache_path != NULL) {
+        cachefile = cache_filename(data, CHECKPOINT_EOF, "eof.bin");
+        (void) write_stage_data(data, CHECKPOINT_EOF, ntime_sub, cachefile, data->conf->cache_key[CHECKPOINT_EOF]);
+        (void) free(cachefile);
       }
-      /* Free temporary buffer */
-      (void) free(buftmp);
     }
+    else if (resume < CHECKPOINT_CLASS && cached < CHECKPOINT_EOF) {
+      /* EOF projection stage was completed by a previous interrupted run */
+      istat = read_checkpoint(data, CHECKPOINT_EOF, ntime_sub);
+      if (istat != 0) {
+        (void) perf_end(perf);
+        return istat;
+      }
+    }
+    (void) perf_end(perf);
 
-    /** Step 5: Compute mean and variance of secondary large-scale fields for the control run **/
+    /* Steps 4 to 9 are skipped when resuming after classification stage, or when it is in cache */
+    perf = perf_begin("classification");
+    if (resume < CHECKPOINT_CLASS && cached < CHECKPOINT_CLASS) {
 
-    /* Process only secondary field of control run. */
-    cat = CTRL_SEC_FIELD_LS;
-    /* Loop over secondary large-scale fields */
-    for (i=0; i<data->field[cat].n_ls; i++) {
+      /** CONTROL RUN **/
 
-      /* Compute spatial mean of secondary large-scale fields */
-      data->field[cat].data[i].down->smean = (double *) malloc(data->field[cat].ntime_ls * sizeof(double));
-      if (data->field[cat].data[i].down->smean == NULL) alloc_error(__FILE__, __LINE__);
+      /** Step 4: Compute distance to clusters for the control run **/
+      /* Process control run only */
+      cat = CTRL_FIELD_LS;
+      /* Loop over large-scale fields */
+      for (i=0; i<data->field[cat].n_ls; i++) {
 
-      (void) mean_field_spatial(data->field[cat].data[i].down->smean, data->field[cat].data[i].field_ls, mask_sub,
-                                data->field[cat].nlon_ls, data->field[cat].nlat_ls, data->field[cat].ntime_ls);
+        /* Allocate memory for temporary buffer */
+        buftmp = (double *) malloc(data->field[cat].ntime_ls*data->field[cat].data[i].eof_info->neof_ls * sizeof(double));
+        if (buftmp == NULL) alloc_error(__FILE__, __LINE__); 
 
-      for (s=0; s<data->conf->nseasons; s++) {
-      
-        /* Compute seasonal mean and variance of principal components of selected large-scale fields */
-      
+        /* Normalisation of the principal component by the square root of the variance of the first one */
         /* Select common time period between the learning period and the model period (control run) */
-        istat = sub_period_common(&buf_sub, &ntime_sub_learn, data->field[cat].data[i].field_ls,
+        /* for first variance calculation */
+        istat = sub_period_common(&buf_sub, &ntime_sub_learn_all, data->field[cat].data[i].field_eof_ls,
                                   data->field[cat].time_s->year, data->field[cat].time_s->month, data->field[cat].time_s->day,
-                                  data->learning->data[s].time_s->year, data->learning->data[s].time_s->month,
-                                  data->learning->data[s].time_s->day, 3,
-                                  data->field[cat].nlon_ls, data->field[cat].nlat_ls, data->field[cat].ntime_ls,
-                                  data->learning->data[s].ntime);
-        if (istat != 0) return istat;
-      
-        /* Compute seasonal mean and variance of spatially-averaged secondary field */
-        (void) mean_variance_field_spatial(&(data->field[cat].data[i].down->mean[s]), &(data->field[cat].data[i].down->var[s]), buf_sub,
-                                           mask_sub, data->field[cat].nlon_ls, data->field[cat].nlat_ls, ntime_sub_learn);
-        
-        /* Compute mean and variance over time for each point of secondary field */
-        data->field[cat].data[i].down->smean_2d[s] = (double *)
-          malloc(data->field[cat].nlon_ls*data->field[cat].nlat_ls*ntime_sub_learn * sizeof(double));
-        if (data->field[cat].data[i].down->smean_2d[s] == NULL) alloc_error(__FILE__, __LINE__);
-        data->field[cat].data[i].down->svar_2d[s] = (double *)
-          malloc(data->field[cat].nlon_ls*data->field[cat].nlat_ls*ntime_sub_learn * sizeof(double));
-        if (data->field[cat].data[i].down->svar_2d[s] == NULL) alloc_error(__FILE__, __LINE__);
-        (void) time_mean_variance_field_2d(data->field[cat].data[i].down->smean_2d[s], data->field[cat].data[i].down->svar_2d[s],
-                                           buf_sub, data->field[cat].nlon_ls, data->field[cat].nlat_ls, ntime_sub_learn);
-
-        /* Diagnostic output */
-        (void) printf("Control run:: Season: %d  TAS mean=%lf variance=%lf cat=%d field=%d\n", s, data->field[cat].data[i].down->mean[s],
-                      sqrt(data->field[cat].data[i].down->var[s]), cat, i);
+                                  data->learning->time_s->year, data->learning->time_s->month,
+                                  data->learning->time_s->day, 1,
+                                  data->field[cat].data[i].eof_info->neof_ls, 1, data->field[cat].ntime_ls, data->learning->ntime);
+        if (istat != 0) {
+          (void) perf_end(perf);
+          return istat;
+        }
 
-        /* Free temporary buffer */
+        /* Allocate memory for temporary buffer */
+        buftmpf = (double *) malloc(ntime_sub_learn_all*data->field[cat].data[i].eof_info->neof_ls * sizeof(double));
+        if (buftmpf == NULL) alloc_error(__FILE__, __LINE__); 
+
+        //    for (s=0; s<data->field[cat].ntime_ls; s++)
+        //      printf("%d %lf\n",s,data->field[cat].data[i].field_eof_ls[s]);
+
+        /* Compute the norm and the variance of the first EOF of the control run as references */
+        printf("Compute the norm and the variance of the first EOF of the control run as references\n");
+        /* Only when first_variance is -9999.9999, the variance of the first EOF will be computed */
+        data->field[cat].data[i].first_variance = -9999.9999;
+        (void) normalize_pc(data->field[cat].data[i].down->var_pc_norm, &(data->field[cat].data[i].first_variance),
+                            buftmpf, buf_sub, data->field[cat].data[i].eof_info->neof_ls,
+                            ntime_sub_learn_all);
+        //    for (ii=0; ii<9; ii++) printf("%d %lf\n",ii,sqrt(data->field[cat].data[i].down->var_pc_norm[ii]));
+        /* Free temporary buffers */
         (void) free(buf_sub);
-      }
-    }
-
-
-    /** MODEL RUN **/
-
-    /** Step 6: Compute mean secondary large-scale fields for the model run **/
+        (void) free(buftmpf);
 
-    cat = SEC_FIELD_LS;
-    /* Loop over secondary large-scale fields */
-    for (i=0; i<data->field[cat].n_ls; i++) {
-      /* Compute spatial mean of secondary large-scale fields */
-      data->field[cat].data[i].down->smean = (double *) malloc(data->field[cat].ntime_ls * sizeof(double));
-      if (data->field[cat].data[i].down->smean == NULL) alloc_error(__FILE__, __LINE__);
-      (void) mean_field_spatial(data->field[cat].data[i].down->smean, data->field[cat].data[i].field_ls, mask_sub,
-                                data->field[cat].nlon_ls, data->field[cat].nlat_ls, data->field[cat].ntime_ls);
-    }
-    
-    /** Step 7: Compute distance to clusters (model run and optionally control run) **/
-
-    /* Downscale also control run if needed */  
-    if (data->conf->period_ctrl->downscale == TRUE)
-      beg_cat = CTRL_FIELD_LS;
-    else
-      beg_cat = FIELD_LS;
-    /* Loop over larg-scale field categories (model run and optionally control run) */
-    for (cat=beg_cat; cat>=FIELD_LS; cat--) {
-      /* Loop over large-scale fields */
-      for (i=0; i<data->field[cat].n_ls; i++) {
-      
+        /* Normalize the large-scale field given the reference norm and variance */
+        printf("Normalize the large-scale field given the reference norm and variance.\n");
         /* Allocate memory for temporary buffer */
-        buftmp = (double *) malloc(data->field[cat].ntime_ls*data->field[cat].data[i].eof_info->neof_ls * sizeof(double));
-        if (buftmp == NULL) alloc_error(__FILE__, __LINE__); 
-      
-        /* Normalisation of the principal component by the square root of the variance of the control run */
         var_pc_norm_all = (double *) malloc(data->field[cat].data[i].eof_info->neof_ls * sizeof(double));
         if (var_pc_norm_all == NULL) alloc_error(__FILE__, __LINE__);
-        (void) normalize_pc(var_pc_norm_all, &(data->field[CTRL_FIELD_LS].data[i].first_variance), buftmp,
-                            data->field[cat].data[i].field_eof_ls, data->field[cat].data[i].eof_info->neof_ls,
+        /* Normalize EOF-projected large-scale fields */
+        (void) normalize_pc(var_pc_norm_all, &(data->field[cat].data[i].first_variance),
+                            buftmp, data->field[cat].data[i].field_eof_ls, data->field[cat].data[i].eof_info->neof_ls,
                             data->field[cat].ntime_ls);
+        /* Free temporary buffer */
         (void) free(var_pc_norm_all);
-      
-        /* Loop over seasons */
+
+        /* Loop over each season */
         for (s=0; s<data->conf->nseasons; s++) {
+          /* Compute mean and variance of principal components of selected large-scale fields */
+
+          /* Allocate memory for season-specific mean and variance of distances to clusters */
+          data->field[cat].data[i].down->mean_dist[s] = (double *) malloc(data->conf->season[s].nclusters * sizeof(double));
+          if (data->field[cat].data[i].down->mean_dist[s] == NULL) alloc_error(__FILE__, __LINE__);
+          data->field[cat].data[i].down->var_dist[s] = (double *) malloc(data->conf->season[s].nclusters * sizeof(double));
+          if (data->field[cat].data[i].down->var_dist[s] == NULL) alloc_error(__FILE__, __LINE__);
+      
+          /* Select common time period between the learning period and the model period (control run) */
+          istat = sub_period_common(&buf_sub, &ntime_sub_learn, buftmp,
+                                    data->field[cat].time_s->year, data->field[cat].time_s->month, data->field[cat].time_s->day,
+                                    data->learning->data[s].time_s->year, data->learning->data[s].time_s->month,
+                                    data->learning->data[s].time_s->day, 1,
+                                    data->field[cat].data[i].eof_info->neof_ls, 1, data->field[cat].ntime_ls, data->learning->data[s].ntime);
+          if (istat != 0) {
+            (void) perf_end(perf);
+            return istat;
+          }
+      
+          /* Compute mean and variance of distances to clusters */
+          (void) pack_pc_days(&pc_days, buf_sub, data->field[cat].data[i].eof_info->neof_ls, ntime_sub_learn);
+          (void) mean_variance_dist_clusters(data->field[cat].data[i].down->mean_dist[s], data->field[cat].data[i].down->var_dist[s],
+                                             &pc_days, data->learning->data[s].weight,
+                                             data->learning->pc_normalized_var, data->field[cat].data[i].down->var_pc_norm,
+                                             data->conf->season[s].nclusters);
+          (void) free_pc_days(&pc_days);
+          /* Diagnostic output */
+          printf("Season: %d\n", s);
+          for (ii=0; ii<data->conf->season[s].nclusters; ii++)
+            (void) printf("%s: Cluster #%d. Mean and variance of distances to clusters for control run: %lf %lf\n", __FILE__, ii,
+                          data->field[cat].data[i].down->mean_dist[s][ii], sqrt(data->field[cat].data[i].down->var_dist[s][ii]));
 
-          /* Select season months in the whole time period and create sub-period large-scale field buffer */
-          (void) extract_subperiod_months(&buf_sub, &(ntime_sub[cat][s]), buftmp,
-                                          data->field[cat].time_s->year, data->field[cat].time_s->month, data->field[cat].time_s->day,
-                                          data->conf->time_units, data->conf->cal_type, period,
-                                          data->conf->season[s].month,
-                                          1, data->field[cat].time_ls, 1,
-                                          data->field[cat].data[i].eof_info->neof_ls, data->field[cat].ntime_ls,
-                                          data->conf->season[s].nmonths);
-
-          /* Compute distances to clusters using normalization and against the control reference run */
-          data->field[cat].data[i].down->dist[s] = (double *) 
-            malloc(data->conf->season[s].nclusters*ntime_sub[cat][s] * sizeof(double));
-          if (data->field[cat].data[i].down->dist[s] == NULL) alloc_error(__FILE__, __LINE__);
-          (void) dist_clusters_normctrl(data->field[cat].data[i].down->dist[s], buf_sub, data->learning->data[s].weight,
-                                        data->learning->pc_normalized_var, data->field[CTRL_FIELD_LS].data[i].down->var_pc_norm,
-                                        data->field[CTRL_FIELD_LS].data[i].down->mean_dist[s],
-                                        data->field[CTRL_FIELD_LS].data[i].down->var_dist[s],
-                                        data->field[cat].data[i].eof_info->neof_ls, data->conf->season[s].nclusters,
-                                        ntime_sub[cat][s]);
-          /* Classify each day in the current clusters */
-          data->field[cat].data[i].down->days_class_clusters[s] = (int *) malloc(ntime_sub[cat][s] * sizeof(int));
-          if (data->field[cat].data[i].down->days_class_clusters[s] == NULL) alloc_error(__FILE__, __LINE__);
-          (void) class_days_pc_clusters(data->field[cat].data[i].down->days_class_clusters[s], buf_sub,
-                                        data->learning->data[s].weight, data->conf->classif_type,
-                                        data->field[cat].data[i].eof_info->neof_ls, data->conf->season[s].nclusters,
-                                        ntime_sub[cat][s]);
           /* Free temporary buffer */
           (void) free(buf_sub);
         }
         /* Free temporary buffer */
         (void) free(buftmp);
       }
-    }
-  
-    /** Step 8: Normalize the secondary large-scale fields by control-run mean and variance **/
 
-    /* Downscale also control run if needed */
-    if (data->conf->period_ctrl->downscale == TRUE)
-      beg_cat = CTRL_SEC_FIELD_LS;
-    else
-      beg_cat = SEC_FIELD_LS;
+      /** Step 5: Compute mean and variance of secondary large-scale fields for the control run **/
 
-    /* Loop over secondary field categories (model run and optionally control run) */
-    for (cat=beg_cat; cat>=SEC_FIELD_LS; cat--) {
+      /* Process only secondary field of control run. */
+      cat = CTRL_SEC_FIELD_LS;
       /* Loop over secondary large-scale fields */
-      for (i=0; i<data->field[cat].n_ls; i++)
-        /* Loop over each season */
+      for (i=0; i<data->field[cat].n_ls; i++) {
+
+        /* Compute spatial mean of secondary large-scale fields */
+        data->field[cat].data[i].down->smean = (double *) malloc(data->field[cat].ntime_ls * sizeof(double));
+        if (data->field[cat].data[i].down->smean == NULL) alloc_error(__FILE__, __LINE__);
+
+        (void) mean_field_spatial(data->field[cat].data[i].down->smean, data->field[cat].data[i].field_ls, mask_sub,
+                                  data->field[cat].nlon_ls, data->field[cat].nlat_ls, data->field[cat].ntime_ls);
+
         for (s=0; s<data->conf->nseasons; s++) {
-          /* Select season months in the whole time period to create a sub-period buffer */
-          (void) extract_subperiod_months(&buf_sub, &(ntime_sub[cat][s]), data->field[cat].data[i].down->smean,
-                                          data->field[cat].time_s->year, data->field[cat].time_s->month, data->field[cat].time_s->day,
-                                          data->conf->time_units, data->conf->cal_type, period,
-                                          data->conf->season[s].month, 3, data->field[cat].time_ls, 1,
-                                          1, data->field[cat].ntime_ls, data->conf->season[s].nmonths);
-          /* Normalize the spatial mean of secondary large-scale fields */
-          data->field[cat].data[i].down->smean_norm[s] = (double *) malloc(data->field[cat].ntime_ls * sizeof(double));
-          if (data->field[cat].data[i].down->smean_norm[s] == NULL) alloc_error(__FILE__, __LINE__);
-          (void) normalize_field(data->field[cat].data[i].down->smean_norm[s], buf_sub,
-                                 data->field[CTRL_SEC_FIELD_LS].data[i].down->mean[s], data->field[CTRL_SEC_FIELD_LS].data[i].down->var[s],
-                                 1, 1, ntime_sub[cat][s]);
-          /* Free temporary buffer */
-          (void) free(buf_sub);
+      
+          /* Compute seasonal mean and variance of principal components of selected large-scale fields */
+      
+          /* Select common time period between the learning period and the model period (control run) */
+          istat = sub_period_common(&buf_sub, &ntime_sub_learn, data->field[cat].data[i].field_ls,
+                                    data->field[cat].time_s->year, data->field[cat].time_s->month, data->field[cat].time_s->day,
+                                    data->learning->data[s].time_s->year, data->learning->data[s].time_s->month,
+                                    data->learning->data[s].time_s->day, 3,
+                                    data->field[cat].nlon_ls, data->field[cat].nlat_ls, data->field[cat].ntime_ls,
+                                    data->learning->data[s].ntime);
+          if (istat != 0) {
+            (void) perf_end(perf);
+            return istat;
+          }
+      
+          /* Compute seasonal mean and variance of spatially-averaged secondary field */
+          (void) mean_variance_field_spatial(&(data->field[cat].data[i].down->mean[s]), &(data->field[cat].data[i].down->var[s]), buf_sub,
+                                             mask_sub, data->field[cat].nlon_ls, data->field[cat].nlat_ls, ntime_sub_learn);
+        
+          /* Compute mean and variance over time for each point of secondary field */
+          data->field[cat].data[i].down->smean_2d[s] = (double *)
+            malloc(data->field[cat].nlon_ls*data->field[cat].nlat_ls*ntime_sub_learn * sizeof(double));
+          if (data->field[cat].data[i].down->smean_2d[s] == NULL) alloc_error(__FILE__, __LINE__);
+          data->field[cat].data[i].down->svar_2d[s] = (double *)
+            malloc(data->field[cat].nlon_ls*data->field[cat].nlat_ls*ntime_sub_learn * sizeof(double));
+          if (data->field[cat].data[i].down->svar_2d[s] == NULL) alloc_error(__FILE__, __LINE__);
+          (void) time_mean_variance_field_2d(data->field[cat].data[i].down->smean_2d[s], data->field[cat].data[i].down->svar_2d[s],
+                                             buf_sub, data->field[cat].nlon_ls, data->field[cat].nlat_ls, ntime_sub_learn);
+
+          /* Diagnostic output */
+          (void) printf("Control run:: Season: %d  TAS mean=%lf variance=%lf cat=%d field=%d\n", s, data->field[cat].data[i].down->mean[s],
+                        sqrt(data->field[cat].data[i].down->var[s]), cat, i);
 
-          /* Select season months in the whole time period to create a 2D sub-period buffer */
-          (void) extract_subperiod_months(&buf_sub, &(ntime_sub[cat][s]), data->field[cat].data[i].field_ls,
-                                          data->field[cat].time_s->year, data->field[cat].time_s->month, data->field[cat].time_s->day,
-                                          data->conf->time_units, data->conf->cal_type, period,
-                                          data->conf->season[s].month, 3, data->field[cat].time_ls,
-                                          data->field[cat].nlon_ls, data->field[cat].nlat_ls,
-                                          data->field[cat].ntime_ls, data->conf->season[s].nmonths);
-          /* Normalize the secondary large-scale fields */
-          data->field[cat].data[i].down->sup_val_norm[s] =
-            (double *) malloc(data->field[cat].nlon_ls*data->field[cat].nlat_ls*data->field[cat].ntime_ls * sizeof(double));
-          if (data->field[cat].data[i].down->sup_val_norm[s] == NULL) alloc_error(__FILE__, __LINE__);
-          (void) normalize_field_2d(data->field[cat].data[i].down->sup_val_norm[s], buf_sub,
-                                    data->field[CTRL_SEC_FIELD_LS].data[i].down->smean_2d[s],
-                                    data->field[CTRL_SEC_FIELD_LS].data[i].down->svar_2d[s],
-                                    data->field[cat].nlon_ls, data->field[cat].nlat_ls, ntime_sub[cat][s]);
           /* Free temporary buffer */
           (void) free(buf_sub);
         }
-    }
+      }
 
-    /** Step 9: Compute the precipitation using the pre-computed regressions for the model run for each season **/
 
-    /* Select the first large-scale field which must contain the cluster distances */
-    /* and the first secondary large-scale fields which must contains its spatial mean */
-    i = 0;
+      /** MODEL RUN **/
 
-    /* Downscale also control run if needed */
-    if (data->conf->period_ctrl->downscale == TRUE)
-      beg_cat = CTRL_FIELD_LS;
-    else
-      beg_cat = FIELD_LS;
+      /** Step 6: Compute mean secondary large-scale fields for the model run **/
 
-    /* Loop over large-scale field categories (model run and optionally control run) */
-    for (cat=beg_cat; cat>=FIELD_LS; cat--) {
-      /* Process only if, for this category, at least one large-scale field is available */
+      cat = SEC_FIELD_LS;
+      /* Loop over secondary large-scale fields */
       for (i=0; i<data->field[cat].n_ls; i++) {
-        /* Loop over each season */
-        for (s=0; s<data->conf->nseasons; s++) {
-          /* Apply the regression coefficients to calculate precipitation using the cluster distances */
-          /* and the normalized spatial mean of the corresponding secondary large-scale field */
-          data->field[cat].precip_index[s] = (double *) malloc(data->reg->npts*ntime_sub[cat+2][s] * sizeof(double));
-          if (data->field[cat].precip_index[s] == NULL) alloc_error(__FILE__, __LINE__);
-          (void) apply_regression(data->field[cat].precip_index[s], data->learning->data[s].precip_reg,
-                                  data->learning->data[s].precip_reg_cst,
-                                  data->field[cat].data[i].down->dist[s], data->field[cat+2].data[i].down->smean_norm[s],
-                                  data->reg->npts, ntime_sub[cat+2][s], data->conf->season[s].nclusters, data->conf->season[s].nreg);
-          if (data->reg->reg_save == TRUE)
-            /* Select season months in the whole time period and create sub-period time vector */
-            (void) extract_subperiod_months(&(time_ls_sub[s]), &ntime_sub_tmp, data->field[cat].time_ls,
+        /* Compute spatial mean of secondary large-scale fields */
+        data->field[cat].data[i].down->smean = (double *) malloc(data->field[cat].ntime_ls * sizeof(double));
+        if (data->field[cat].data[i].down->smean == NULL) alloc_error(__FILE__, __LINE__);
+        (void) mean_field_spatial(data->field[cat].data[i].down->smean, data->field[cat].data[i].field_ls, mask_sub,
+                                  data->field[cat].nlon_ls, data->field[cat].nlat_ls, data->field[cat].ntime_ls);
+      }
+    
+      /** Step 7: Compute distance to clusters (model run and optionally control run) **/
+
+      /* Downscale also control run if needed */  
+      if (data->conf->period_ctrl->downscale == TRUE)
+        beg_cat = CTRL_FIELD_LS;
+      else
+        beg_cat = FIELD_LS;
+      /* Loop over larg-scale field categories (model run and optionally control run) */
+      for (cat=beg_cat; cat>=FIELD_LS; cat--) {
+        /* Loop over large-scale fields */
+        for (i=0; i<data->field[cat].n_ls; i++) {
+      
+          /* Allocate memory for temporary buffer */
+          buftmp = (double *) malloc(data->field[cat].ntime_ls*data->field[cat].data[i].eof_info->neof_ls * sizeof(double));
+          if (buftmp == NULL) alloc_error(__FILE__, __LINE__); 
+      
+          /* Normalisation of the principal component by the square root of the variance of the control run */
+          var_pc_norm_all = (double *) malloc(data->field[cat].data[i].eof_info->neof_ls * sizeof(double));
+          if (var_pc_norm_all == NULL) alloc_error(__FILE__, __LINE__);
+          (void) normalize_pc(var_pc_norm_all, &(data->field[CTRL_FIELD_LS].data[i].first_variance), buftmp,
+                              data->field[cat].data[i].field_eof_ls, data->field[cat].data[i].eof_info->neof_ls,
+                              data->field[cat].ntime_ls);
+          (void) free(var_pc_norm_all);
+      
+          /* Loop over seasons */
+          for (s=0; s<data->conf->nseasons; s++) {
+
+            /* Select season months in the whole time period and create sub-period large-scale field buffer */
+            (void) extract_subperiod_months(&buf_sub, &(ntime_sub[cat][s]), buftmp,
                                             data->field[cat].time_s->year, data->field[cat].time_s->month, data->field[cat].time_s->day,
                                             data->conf->time_units, data->conf->cal_type, period,
                                             data->conf->season[s].month,
-                                            1, data->field[cat].time_ls, 1, 1, data->field[cat].ntime_ls,
+                                            1, data->field[cat].time_ls, 1,
+                                            data->field[cat].data[i].eof_info->neof_ls, data->field[cat].ntime_ls,
                                             data->conf->season[s].nmonths);
+
+            /* Compute distances to clusters using normalization and classify each day in the current clusters, in one pass */
+            data->field[cat].data[i].down->dist[s] = (double *) 
+              malloc(data->conf->season[s].nclusters*ntime_sub[cat][s] * sizeof(double));
+            if (data->field[cat].data[i].down->dist[s] == NULL) alloc_error(__FILE__, __LINE__);
+            data->field[cat].data[i].down->days_class_clusters[s] = (int *) malloc(ntime_sub[cat][s] * sizeof(int));
+            if (data->field[cat].data[i].down->days_class_clusters[s] == NULL) alloc_error(__FILE__, __LINE__);
+            (void) pack_pc_days(&pc_days, buf_sub, data->field[cat].data[i].eof_info->neof_ls, ntime_sub[cat][s]);
+            (void) dist_clusters_normctrl(data->field[cat].data[i].down->dist[s], data->field[cat].data[i].down->days_class_clusters[s],
+                                          &pc_days, data->learning->data[s].weight,
+                                          data->learning->pc_normalized_var, data->field[CTRL_FIELD_LS].data[i].down->var_pc_norm,
+                                          data->field[CTRL_FIELD_LS].data[i].down->mean_dist[s],
+                                          data->field[CTRL_FIELD_LS].data[i].down->var_dist[s],
+                                          data->conf->season[s].nclusters);
+            (void) free_pc_days(&pc_days);
+            /* Free temporary buffer */
+            (void) free(buf_sub);
+          }
+          /* Free temporary buffer */
+          (void) free(buftmp);
         }
-        if (data->reg->reg_save == TRUE) {
-          (void) printf("Writing downscaling regression diagnostic fields.\n");
-          if (cat == CTRL_FIELD_LS)
-            filename = data->reg->filename_save_ctrl_reg;
-          else
-            filename = data->reg->filename_save_other_reg;
-          (void) write_regression_fields(data, filename, time_ls_sub, ntime_sub[cat+2],
-                                         data->field[cat].precip_index,
-                                         data->field[cat].data[i].down->dist,
-                                         data->field[cat+2].data[i].down->smean_norm);
+      }
+  
+      /** Step 8: Normalize the secondary large-scale fields by control-run mean and variance **/
+
+      /* Downscale also control run if needed */
+      if (data->conf->period_ctrl->downscale == TRUE)
+        beg_cat = CTRL_SEC_FIELD_LS;
+      else
+        beg_cat = SEC_FIELD_LS;
+
+      /* Loop over secondary field categories (model run and optionally control run) */
+      for (cat=beg_cat; cat>=SEC_FIELD_LS; cat--) {
+        /* Loop over secondary large-scale fields */
+        for (i=0; i<data->field[cat].n_ls; i++)
+          /* Loop over each season */
+          for (s=0; s<data->conf->nseasons; s++) {
+            /* Select season months in the whole time period to create a sub-period buffer */
+            (void) extract_subperiod_months(&buf_sub, &(ntime_sub[cat][s]), data->field[cat].data[i].down->smean,
+                                            data->field[cat].time_s->year, data->field[cat].time_s->month, data->field[cat].time_s->day,
+                                            data->conf->time_units, data->conf->cal_type, period,
+                                            data->conf->season[s].month, 3, data->field[cat].time_ls, 1,
+                                            1, data->field[cat].ntime_ls, data->conf->season[s].nmonths);
+            /* Normalize the spatial mean of secondary large-scale fields */
+            data->field[cat].data[i].down->smean_norm[s] = (double *) malloc(data->field[cat].ntime_ls * sizeof(double));
+            if (data->field[cat].data[i].down->smean_norm[s] == NULL) alloc_error(__FILE__, __LINE__);
+            (void) normalize_field(data->field[cat].data[i].down->smean_norm[s], buf_sub,
+                                   data->field[CTRL_SEC_FIELD_LS].data[i].down->mean[s], data->field[CTRL_SEC_FIELD_LS].data[i].down->var[s],
+                                   1, 1, ntime_sub[cat][s]);
+            /* Free temporary buffer */
+            (void) free(buf_sub);
+
+            /* Select season months in the whole time period to create a 2D sub-period buffer */
+            (void) extract_subperiod_months(&buf_sub, &(ntime_sub[cat][s]), data->field[cat].data[i].field_ls,
+                                            data->field[cat].time_s->year, data->field[cat].time_s->month, data->field[cat].time_s->day,
+                                            data->conf->time_units, data->conf->cal_type, period,
+                                            data->conf->season[s].month, 3, data->field[cat].time_ls,
+                                            data->field[cat].nlon_ls, data->field[cat].nlat_ls,
+                                            data->field[cat].ntime_ls, data->conf->season[s].nmonths);
+            /* Normalize the secondary large-scale fields */
+            data->field[cat].data[i].down->sup_val_norm[s] =
+              (double *) malloc(data->field[cat].nlon_ls*data->field[cat].nlat_ls*data->field[cat].ntime_ls * sizeof(double));
+            if (data->field[cat].data[i].down->sup_val_norm[s] == NULL) alloc_error(__FILE__, __LINE__);
+            (void) normalize_field_2d(data->field[cat].data[i].down->sup_val_norm[s], buf_sub,
+                                      data->field[CTRL_SEC_FIELD_LS].data[i].down->smean_2d[s],
+                                      data->field[CTRL_SEC_FIELD_LS].data[i].down->svar_2d[s],
+                                      data->field[cat].nlon_ls, data->field[cat].nlat_ls, ntime_sub[cat][s]);
+            /* Free temporary buffer */
+            (void) free(buf_sub);
+          }
+      }
+
+      /** Step 9: Compute the precipitation using the pre-computed regressions for the model run for each season **/
+
+      /* Select the first large-scale field which must contain the cluster distances */
+      /* and the first secondary large-scale fields which must contains its spatial mean */
+      i = 0;
+
+      /* Downscale also control run if needed */
+      if (data->conf->period_ctrl->downscale == TRUE)
+        beg_cat = CTRL_FIELD_LS;
+      else
+        beg_cat = FIELD_LS;
+
+      /* Loop over large-scale field categories (model run and optionally control run) */
+      for (cat=beg_cat; cat>=FIELD_LS; cat--) {
+        /* Process only if, for this category, at least one large-scale field is available */
+        for (i=0; i<data->field[cat].n_ls; i++) {
+          /* Loop over each season */
+          for (s=0; s<data->conf->nseasons; s++) {
+            /* Apply the regression coefficients to calculate precipitation using the cluster distances */
+            /* and the normalized spatial mean of the corresponding secondary large-scale field */
+            data->field[cat].precip_index[s] = (double *) malloc(data->reg->npts*ntime_sub[cat+2][s] * sizeof(double));
+            if (data->field[cat].precip_index[s] == NULL) alloc_error(__FILE__, __LINE__);
+            (void) apply_regression(data->field[cat].precip_index[s], data->learning->data[s].precip_reg,
+                                    data->learning->data[s].precip_reg_cst,
+                                    data->field[cat].data[i].down->dist[s], data->field[cat+2].data[i].down->smean_norm[s],
+                                    data->reg->npts, ntime_sub[cat+2][s], data->conf->season[s].nclusters, data->conf->season[s].nreg);
+            if (data->reg->reg_save == TRUE)
+              /* Select season months in the whole time period and create sub-period time vector */
+              (void) extract_subperiod_months(&(time_ls_sub[s]), &ntime_sub_tmp, data->field[cat].time_ls,
+                                              data->field[cat].time_s->year, data->field[cat].time_s->month, data->field[cat].time_s->day,
+                                              data->conf->time_units, data->conf->cal_type, period,
+                                              data->conf->season[s].month,
+                                              1, data->field[cat].time_ls, 1, 1, data->field[cat].ntime_ls,
+                                              data->conf->season[s].nmonths);
+          }
+          if (data->reg->reg_save == TRUE) {
+            (void) printf("Writing downscaling regression diagnostic fields.\n");
+            if (cat == CTRL_FIELD_LS)
+              filename = data->reg->filename_save_ctrl_reg;
+            else
+              filename = data->reg->filename_save_other_reg;
+            (void) write_regression_fields(data, filename, time_ls_sub, ntime_sub[cat+2],
+                                           data->field[cat].precip_index,
+                                           data->field[cat].data[i].down->dist,
+                                           data->field[cat+2].data[i].down->smean_norm);
+          }
         }
       }
+      if (data->reg->reg_save == TRUE) {
+        for (s=0; s<data->conf->nseasons; s++)
+          (void) free(time_ls_sub[s]);
+        (void) free(time_ls_sub);
+      }
+
+      /* Record classification stage */
+      if (data->conf->checkpoint_path != NULL)
+        (void) save_checkpoint(data, CHECKPOINT_CLASS, ntime_sub);
+      /* Store classification stage in cache */
+      if (data->conf->cache_path != NULL) {
+        cachefile = cache_filename(data, CHECKPOINT_CLASS, "class.bin");
+        (void) write_stage_data(data, CHECKPOINT_CLASS, ntime_sub, cachefile, data->conf->cache_key[CHECKPOINT_CLASS]);
+        (void) free(cachefile);
+      }
     }
-    if (data->reg->reg_save == TRUE) {
-      for (s=0; s<data->conf->nseasons; s++)
-        (void) free(time_ls_sub[s]);
-      (void) free(time_ls_sub);
+    else {
+      /* Classification stage was completed by a previous interrupted run, or read from cache above */
+      if (cached != CHECKPOINT_CLASS) {
+        istat = read_checkpoint(data, CHECKPOINT_CLASS, ntime_sub);
+        if (istat != 0) {
+          (void) perf_end(perf);
+          return istat;
+        }
+      }
+      if (data->reg->reg_save == TRUE)
+        (void) free(time_ls_sub);
     }
+    (void) perf_end(perf);
   
     /** Step 10: Find the days : resampling **/
+    perf = perf_begin("analog_days");
 
     /* Select the first large-scale field which must contain the cluster distances */
     /* and the first secondary large-scale fields which must contains its spatial mean */
@@ -532,64 +696,16 @@ wt_downscaling(data_struct *data) {
     /* Loop over large-scale field categories (model run and optionally control run) */
     for (cat=beg_cat; cat>=FIELD_LS; cat--) {
       /* Process only if, for this category, at least one large-scale field is available */
-      if (data->field[cat].n_ls > 0)
-        /* Loop over each season */
-        for (s=0; s<data->conf->nseasons; s++) {
-          /* Find the analog days in the learning period given the precipitation index, */
-          /* the spatial mean of the secondary large-scale fields and its index, and the cluster classification of the days */
-          data->field[cat].analog_days[s].ntime = ntime_sub[cat][s];
-          data->field[cat].analog_days[s].time = (int *) malloc(ntime_sub[cat][s] * sizeof(int));
-          if (data->field[cat].analog_days[s].time == NULL) alloc_error(__FILE__, __LINE__);
-          data->field[cat].analog_days[s].tindex = (int *) malloc(ntime_sub[cat][s] * sizeof(int));
-          if (data->field[cat].analog_days[s].tindex == NULL) alloc_error(__FILE__, __LINE__);
-          data->field[cat].analog_days[s].tindex_all = (int *) malloc(ntime_sub[cat][s] * sizeof(int));
-          if (data->field[cat].analog_days[s].tindex_all == NULL) alloc_error(__FILE__, __LINE__);
-          data->field[cat].analog_days[s].year = (int *) malloc(ntime_sub[cat][s] * sizeof(int));
-          if (data->field[cat].analog_days[s].year == NULL) alloc_error(__FILE__, __LINE__);
-          data->field[cat].analog_days[s].month = (int *) malloc(ntime_sub[cat][s] * sizeof(int));
-          if (data->field[cat].analog_days[s].month == NULL) alloc_error(__FILE__, __LINE__);
-          data->field[cat].analog_days[s].day = (int *) malloc(ntime_sub[cat][s] * sizeof(int));
-          if (data->field[cat].analog_days[s].day == NULL) alloc_error(__FILE__, __LINE__);
-          data->field[cat].analog_days[s].tindex_s_all = (int *) malloc(ntime_sub[cat][s] * sizeof(int));
-          if (data->field[cat].analog_days[s].tindex_s_all == NULL) alloc_error(__FILE__, __LINE__);
-          data->field[cat].analog_days[s].year_s = (int *) malloc(ntime_sub[cat][s] * sizeof(int));
-          if (data->field[cat].analog_days[s].year_s == NULL) alloc_error(__FILE__, __LINE__);
-          data->field[cat].analog_days[s].month_s = (int *) malloc(ntime_sub[cat][s] * sizeof(int));
-          if (data->field[cat].analog_days[s].month_s == NULL) alloc_error(__FILE__, __LINE__);
-          data->field[cat].analog_days[s].day_s = (int *) malloc(ntime_sub[cat][s] * sizeof(int));
-          if (data->field[cat].analog_days[s].day_s == NULL) alloc_error(__FILE__, __LINE__);
-          data->field[cat].analog_days[s].ndayschoice = (int *) malloc(ntime_sub[cat][s] * sizeof(int));
-          if (data->field[cat].analog_days[s].ndayschoice == NULL) alloc_error(__FILE__, __LINE__);
-          data->field[cat].analog_days[s].analog_dayschoice = (tstruct **) malloc(ntime_sub[cat][s] * sizeof(tstruct *));
-          if (data->field[cat].analog_days[s].analog_dayschoice == NULL) alloc_error(__FILE__, __LINE__);
-          data->field[cat].analog_days[s].metric_norm = (float **) malloc(ntime_sub[cat][s] * sizeof(float *));
-          if (data->field[cat].analog_days[s].metric_norm == NULL) alloc_error(__FILE__, __LINE__);
-          data->field[cat].analog_days[s].tindex_dayschoice = (int **) malloc(ntime_sub[cat][s] * sizeof(int *));
-          if (data->field[cat].analog_days[s].tindex_dayschoice == NULL) alloc_error(__FILE__, __LINE__);
-          for (ii=0; ii<ntime_sub[cat][s]; ii++) {
-            data->field[cat].analog_days[s].ndayschoice[ii] = data->conf->season[s].ndayschoices;
-            data->field[cat].analog_days[s].analog_dayschoice[ii] = (tstruct *) NULL;
-            data->field[cat].analog_days[s].metric_norm[ii] = (float *) NULL;            
-            data->field[cat].analog_days[s].tindex_dayschoice[ii] = (int *) NULL;
-          }
-          (void) printf("%s: Searching analog days for season #%d\n", __FILE__, s);
-          istat = find_the_days(data->field[cat].analog_days[s], data->field[cat].precip_index[s], data->learning->data[s].precip_index,
-                                data->field[cat+2].data[i].down->smean_norm[s], data->learning->data[s].sup_index,
-                                data->field[cat+2].data[i].down->sup_val_norm[s], data->learning->data[s].sup_val, mask_sub,
-                                data->field[cat].data[i].down->days_class_clusters[s], data->learning->data[s].class_clusters,
-                                data->field[cat].time_s->year, data->field[cat].time_s->month, data->field[cat].time_s->day,
-                                data->learning->data[s].time_s->year, data->learning->data[s].time_s->month,
-                                data->learning->data[s].time_s->day, data->conf->time_units,
-                                data->field[cat].ntime_ls, data->learning->data[s].ntime,
-                                data->conf->season[s].month, data->conf->season[s].nmonths,
-                                data->conf->season[s].ndays, data->conf->season[s].ndayschoices, data->reg->npts,
-                                data->conf->season[s].shuffle, data->conf->season[s].secondary_choice,
-                                data->conf->season[s].secondary_main_choice, data->conf->season[s].secondary_cov,
-                                data->conf->use_downscaled_year, data->conf->only_wt,
-                                data->field[cat+2].nlon_ls, data->field[cat+2].nlat_ls,
-                                data->learning->sup_nlon, data->learning->sup_nlat);
-          if (istat != 0) return istat;
+      if (data->field[cat].n_ls > 0) {
+        /* Find the analog days in the learning period given the precipitation index, */
+        /* the spatial mean of the secondary large-scale fields and its index, and the cluster classification of the days. */
+        /* Seasons are independent and are searched concurrently */
+        istat = find_the_days_seasons(data, mask_sub, ntime_sub[cat], cat, i);
+        if (istat != 0) {
+          (void) perf_end(perf);
+          return istat;
         }
+      }
     }
 
     /** Step 11: Compute the secondary large-scale fields difference if wanted */
@@ -622,10 +738,12 @@ wt_downscaling(data_struct *data) {
                                                     data->learning->data[s].sup_index_var, ntime_sub[cat][s]);
         }
     }
+    (void) perf_end(perf);
     
   }
   
-  /** Step 12: Reconstruct data using chosen resampled days and write output */
+  /** Step 12: Merge seasons of chosen resampled days, or read them */
+  perf = perf_begin("analog_data");
   
   /* Downscale also control run if needed */  
   if (data->conf->period_ctrl->downscale == TRUE)
@@ -635,6 +753,7 @@ wt_downscaling(data_struct *data) {
   
   /* Loop over large-scale field categories (model run and optionally control run) */
   for (cat=beg_cat; cat>=FIELD_LS; cat--) {
+    merged_times_cat[cat] = NULL;
     /* Process only if, for this category, at least one large-scale field is available */
     if (data->field[cat].n_ls > 0) {
       /* Process only first large-scale field. Limitation of the current implementation. */
@@ -657,6 +776,7 @@ wt_downscaling(data_struct *data) {
             if (curindex_merged < 0 || curindex_merged >= data->field[cat].ntime_ls) {
               (void) fprintf(stderr, "%s: Fatal error: index in merged season vector outside bounds! curindex_merged=%d max=%d\n",
                              __FILE__, curindex_merged, data->field[cat].ntime_ls-1);
+              (void) perf_end(perf);
               return -1;
             }
             merged_times_flag[curindex_merged] = 1;
@@ -757,6 +877,7 @@ wt_downscaling(data_struct *data) {
           if (istat != 0) {
             (void) free(merged_times);
             (void) free(merged_itimes);
+            (void) perf_end(perf);
             return istat;
           }
           data->field[cat].analog_days_year.ntime += ntime_sub[cat][s];
@@ -773,6 +894,32 @@ wt_downscaling(data_struct *data) {
                                   data->field[cat].data[i].down->dist_all, data->field[cat].data[i].down->days_class_clusters_all,
                                   merged_times, analog_file, data);
         }
+
+        /** Save analog_days information as checkpoint of analog days search, and in cache, under a temporary name until complete **/
+        for (dest=0; dest<2; dest++) {
+          filename = NULL;
+          if (dest == 0 && data->conf->checkpoint_path != NULL) {
+            filename = (char *) malloc(MAXPATH * sizeof(char));
+            if (filename == NULL) alloc_error(__FILE__, __LINE__);
+            (void) sprintf(filename, "%s/%s", data->conf->checkpoint_path, (cat == FIELD_LS) ? "analog_other.nc" : "analog_ctrl.nc");
+          }
+          else if (dest == 1 && data->conf->cache_path != NULL)
+            filename = cache_filename(data, CHECKPOINT_ANALOG, (cat == FIELD_LS) ? "analog_other.nc" : "analog_ctrl.nc");
+          if (filename != NULL) {
+            filename_tmp = (char *) malloc(MAXPATH * sizeof(char));
+            if (filename_tmp == NULL) alloc_error(__FILE__, __LINE__);
+            (void) sprintf(filename_tmp, "%s.tmp", filename);
+            (void) save_analog_data(data->field[cat].analog_days_year, data->field[cat+2].data[i].down->delta_all,
+                                    data->field[cat+2].data[i].down->delta_dayschoice_all,
+                                    data->field[cat].data[i].down->dist_all, data->field[cat].data[i].down->days_class_clusters_all,
+                                    merged_times, filename_tmp, data);
+            if (rename(filename_tmp, filename) != 0)
+              (void) fprintf(stderr, "%s: Cannot write analog data file %s: %s\n", __FILE__, filename, strerror(errno));
+            (void) free(filename);
+            (void) free(filename_tmp);
+          }
+        }
+        (void) free(merged_itimes);
       }
       else {
         if (cat == FIELD_LS)
@@ -782,8 +929,24 @@ wt_downscaling(data_struct *data) {
         (void) printf("%s: Reading analog data from file %s\n", __FILE__, analog_file);
         (void) read_analog_data(&(data->field[cat].analog_days_year), &(data->field[cat+2].data[i].down->delta_all),
                                 &merged_times, analog_file, data->conf->obs_var->timename);
-        ntimes_merged = data->field[cat].analog_days_year.ntime;
       }
+      merged_times_cat[cat] = merged_times;
+    }
+  }
+
+  /* Record analog days search stage once analog data of all categories is saved */
+  if (data->conf->checkpoint_path != NULL && data->conf->output_only != TRUE)
+    (void) save_checkpoint(data, CHECKPOINT_ANALOG, ntime_sub);
+  (void) perf_end(perf);
+
+  /** Step 13: Reconstruct data using chosen resampled days and write output */
+
+  /* Loop over large-scale field categories (model run and optionally control run) */
+  for (cat=beg_cat; cat>=FIELD_LS; cat--) {
+    /* Process only if, for this category, at least one large-scale field is available */
+    if (data->field[cat].n_ls > 0) {
+      /* Process only first large-scale field. Limitation of the current implementation. */
+      i = 0;
       
       /* Process all data */
       if (data->conf->output == TRUE) {
@@ -793,23 +956,42 @@ wt_downscaling(data_struct *data) {
         else {
           period = data->conf->period_ctrl;
         }
+        /* Skip output years completely written by a previous interrupted run, and record written output years */
+        year_done = -1;
+        filename = NULL;
+        if (data->conf->checkpoint_path != NULL) {
+          year_done = data->conf->checkpoint_year[cat];
+          filename = (char *) malloc(MAXPATH * sizeof(char));
+          if (filename == NULL) alloc_error(__FILE__, __LINE__);
+          (void) sprintf(filename, "%s/%s", data->conf->checkpoint_path, (cat == FIELD_LS) ? "output_other.txt" : "output_ctrl.txt");
+        }
+        perf = perf_begin("output");
         istat = output_downscaled_analog(data->field[cat].analog_days_year, data->field[cat+2].data[i].down->delta_all,
                                          data->conf->output_month_begin, data->conf->output_path, data->conf->config,
                                          data->conf->time_units, data->conf->cal_type, data->conf->deltat,
                                          data->conf->format, data->conf->compression, data->conf->compression_level,
                                          data->conf->debug,
-                                         data->info, data->conf->obs_var, period, merged_times, ntimes_merged);
+                                         data->info, data->conf->obs_var, period, merged_times_cat[cat],
+                                         data->field[cat].analog_days_year.ntime, year_done, filename,
+                                         data->conf->checkpoint_hash, data->conf->perf_attribute, data->conf->prefetch_obs);
+        (void) perf_end(perf);
+        if (filename != NULL) {
+          (void) free(filename);
+          filename = NULL;
+        }
         if (istat != 0) {
-          (void) free(merged_times);
-          (void) free(merged_itimes);
+          (void) free(merged_times_cat[cat]);
           return istat;
         }
       }
-      (void) free(merged_times);
-      (void) free(merged_itimes);
+      (void) free(merged_times_cat[cat]);
     }
   }
           
+  /* Downscaling is complete: checkpoints are not needed anymore */
+  if (data->conf->checkpoint_path != NULL)
+    (void) clean_checkpoint(data);
+
   /* Free memory for specific downscaling buffers */
   if (data->conf->output_only != TRUE) {
     for (cat=0; cat<NCAT; cat++)
@@ -83,6 +83,7 @@ wt_learning(data_struct *data) {
   double *buf_learn_rea_sub = NULL;
   double *buf_learn_pc = NULL;
   double *buf_learn_pc_sub = NULL;
+  pc_days_struct pc_days;
 
   double *precip_liquid_obs = NULL;
   double *precip_solid_obs = NULL;
@@ -90,14 +91,8 @@ wt_learning(data_struct *data) {
   double *mean_precip = NULL;
   double *mean_precip_sub = NULL;
 
-  double *precip_reg = NULL;
-  double *precip_err = NULL;
-  double *precip_index = NULL;
   double *dist_reg = NULL;
-  double *vif = NULL;
-  double chisq;
-  double rsq;
-  double autocor;
+  double *chisq = NULL;
 
   double obs_first_sing;
   double rea_sing;
@@ -154,23 +149,43 @@ wt_learning(data_struct *data) {
 
   int istat; /** Return status. */
   int istat_solid; /** Return status solid precipitation. */
+  int perf; /** Performance measurement stage. */
 
   if (data->learning->learning_provided == TRUE) {
     /** Read learning data **/
+    perf = perf_begin("read_learning_fields");
     istat = read_learning_fields(data);
+    (void) perf_end(perf);
     if (istat != 0) return istat;
   }
   else  {
     /** Compute learning data **/
-    /** Assume EOFs are already pre-computed **/
-
-    /* Read re-analysis pre-computed EOF and Singular Values */
-    istat = read_learning_rea_eof(data);
-    if (istat != 0) return istat;
+    if (data->learning->eof_compute != FALSE) {
+      /* Compute re-analysis and observations EOF and Singular Values */
+      perf = perf_begin("compute_learning_eof");
+      istat = compute_learning_eof(data);
+      (void) perf_end(perf);
+      if (istat != 0) return istat;
+    }
+    else {
+      /** Assume EOFs are already pre-computed **/
+
+      /* Read re-analysis pre-computed EOF and Singular Values */
+      perf = perf_begin("read_learning_eof");
+      istat = read_learning_rea_eof(data);
+      if (istat != 0) {
+        (void) perf_end(perf);
+        return istat;
+      }
 
-    /* Read observations pre-computed EOF and Singular Values */
-    istat = read_learning_obs_eof(data);
-    if (istat != 0) return istat;
+      /* Read observations pre-computed EOF and Singular Values */
+      istat = read_learning_obs_eof(data);
+      if (istat != 0) {
+        (void) perf_end(perf);
+        return istat;
+      }
+      (void) perf_end(perf);
+    }
 
     /* Select common time period between the re-analysis and the observation data periods */
     if (data->learning->obs_neof != 0) {
@@ -225,11 +240,15 @@ wt_learning(data_struct *data) {
     if (ntime_sub == NULL) alloc_error(__FILE__, __LINE__);
 
     /* Read observed precipitation (liquid and solid) */
+    perf = perf_begin("read_observations");
     istat_solid = read_obs_period(&precip_solid_obs, &(data->learning->lon), &(data->learning->lat), &missing_value_precip,
                                   data, "prsn", data->learning->obs->time_s->year, data->learning->obs->time_s->month,
                                   data->learning->obs->time_s->day, &(data->learning->nlon), &(data->learning->nlat),
                                   data->learning->obs->ntime);
-    if (istat_solid == -1) return -1;
+    if (istat_solid == -1) {
+      (void) perf_end(perf);
+      return -1;
+    }
     if (istat_solid >= 0) {
       (void) free(data->learning->lon);
       (void) free(data->learning->lat);
@@ -237,7 +256,11 @@ wt_learning(data_struct *data) {
     istat = read_obs_period(&precip_liquid_obs, &(data->learning->lon), &(data->learning->lat), &missing_value_precip, data, "prr",
                             data->learning->obs->time_s->year, data->learning->obs->time_s->month, data->learning->obs->time_s->day,
                             &(data->learning->nlon), &(data->learning->nlat), data->learning->obs->ntime);
-    if (istat == -1) return -1;
+    if (istat == -1) {
+      (void) perf_end(perf);
+      return -1;
+    }
+    (void) perf_end(perf);
 
     /* Calculate total precipitation */
     printf("%d %d %d\n",data->learning->nlon, data->learning->nlat, data->learning->obs->ntime);
@@ -340,6 +363,7 @@ wt_learning(data_struct *data) {
 
     /* Select common time period between the re-analysis and the observation data periods for */
     /* secondary large-scale field and extract subdomain */
+    perf = perf_begin("read_secondary_field");
     istat = read_field_subdomain_period(&tas_rea, &(data->learning->sup_lon), &(data->learning->sup_lat),
                                         &missing_value, data->learning->nomvar_rea_sup,
                                         data->learning->obs->time_s->year, data->learning->obs->time_s->month,
@@ -351,6 +375,7 @@ wt_learning(data_struct *data) {
                                         data->learning->rea_dimxname, data->learning->rea_dimyname,
                                         data->learning->rea_timename, data->learning->filename_rea_sup,
                                         &(data->learning->sup_nlon), &(data->learning->sup_nlat), data->learning->obs->ntime);
+    (void) perf_end(perf);
 
     /* Perform spatial mean of secondary large-scale fields */
     tas_rea_mean = (double *) malloc(data->learning->obs->ntime * sizeof(double));
@@ -391,6 +416,7 @@ wt_learning(data_struct *data) {
     /* Loop over each season */
     (void) printf("Extract data for each season separately and process each season.\n");
 
+    perf = perf_begin("classification_regression");
     for (s=0; s<data->conf->nseasons; s++) {
       /* Process separately each season */
 
@@ -532,9 +558,19 @@ wt_learning(data_struct *data) {
       buf_weight = (double *) realloc(buf_weight, data->conf->season[s].nclusters * (data->learning->rea_neof + data->learning->obs_neof) *
                                       sizeof(double));
       if (buf_weight == NULL) alloc_error(__FILE__, __LINE__);
-      niter = best_clusters(buf_weight, buf_learn, data->conf->classif_type, data->conf->npartitions,
-                            data->conf->nclassifications, data->learning->rea_neof + data->learning->obs_neof,
-                            data->conf->season[s].nclusters, ntime_sub[s]);
+      if (data->learning->learning_incremental == TRUE) {
+        /* Start from the clusters of the previous learning instead of many partitions from random initial points */
+        niter = warm_start_clusters(buf_weight, buf_learn, data, s, ntime_sub[s]);
+        if (niter < 0) {
+          (void) perf_end(perf);
+          return -1;
+        }
+      }
+      else
+        niter = best_clusters(buf_weight, buf_learn, data->conf->classif_type, data->conf->classif_init, data->conf->npartitions,
+                                data->conf->nclassifications, data->learning->rea_neof + data->learning->obs_neof,
+                                data->conf->season[s].nclusters, ntime_sub[s], data->conf->nthreads, data->conf->classif_seed,
+                                data->conf->classif_tolerance);
 
       /* Keep only first data->learning->rea_neof EOFs */
       data->learning->data[s].weight = (double *) 
@@ -548,10 +584,11 @@ wt_learning(data_struct *data) {
       /* Classify each day in the current clusters */
       data->learning->data[s].class_clusters = (int *) malloc(ntime_sub[s] * sizeof(int));
       if (data->learning->data[s].class_clusters == NULL) alloc_error(__FILE__, __LINE__);
-      (void) class_days_pc_clusters(data->learning->data[s].class_clusters, buf_learn,
+      (void) pack_pc_days(&pc_days, buf_learn, data->learning->rea_neof, ntime_sub[s]);
+      (void) class_days_pc_clusters(data->learning->data[s].class_clusters, &pc_days,
                                     data->learning->data[s].weight, data->conf->classif_type,
-                                    data->learning->rea_neof, data->conf->season[s].nclusters,
-                                    ntime_sub[s]);
+                                    data->learning->rea_neof, data->conf->season[s].nclusters);
+      (void) free_pc_days(&pc_days);
 
       /* Set mean and variance of distances to clusters to 1.0 because we first need to compute distances and */
       /* we don't have a control run in learning mode */
@@ -567,9 +604,11 @@ wt_learning(data_struct *data) {
       /* Compute distances to clusters using normalization */
       dist = (double *) realloc(dist, data->conf->season[s].nclusters*ntime_sub[s] * sizeof(double));
       if (dist == NULL) alloc_error(__FILE__, __LINE__);
-      (void) dist_clusters_normctrl(dist, buf_learn_pc_sub, data->learning->data[s].weight,
+      (void) pack_pc_days(&pc_days, buf_learn_pc_sub, data->learning->rea_neof, ntime_sub[s]);
+      (void) dist_clusters_normctrl(dist, NULL, &pc_days, data->learning->data[s].weight,
                                     data->learning->pc_normalized_var, data->learning->pc_normalized_var, mean_dist, var_dist,
-                                    data->learning->rea_neof, data->conf->season[s].nclusters, ntime_sub[s]);
+                                    data->conf->season[s].nclusters);
+      (void) free_pc_days(&pc_days);
       /* Normalize */
       for (clust=0; clust<data->conf->season[s].nclusters; clust++) {
         /* Calculate mean over time */
@@ -590,16 +629,10 @@ wt_learning(data_struct *data) {
       data->learning->rea_neof, data->conf->season[s].nclusters, ntime_sub[s]);*/
 
       /* Allocate memory for regression */
-      precip_reg = (double *) malloc(data->conf->season[s].nreg * sizeof(double));
-      if (precip_reg == NULL) alloc_error(__FILE__, __LINE__);
-      precip_index = (double *) malloc(ntime_sub[s] * sizeof(double));
-      if (precip_index == NULL) alloc_error(__FILE__, __LINE__);
-      precip_err = (double *) malloc(ntime_sub[s] * sizeof(double));
-      if (precip_err == NULL) alloc_error(__FILE__, __LINE__);
+      chisq = (double *) malloc(data->reg->npts * sizeof(double));
+      if (chisq == NULL) alloc_error(__FILE__, __LINE__);
       dist_reg = (double *) malloc(data->conf->season[s].nreg*ntime_sub[s] * sizeof(double));
       if (dist_reg == NULL) alloc_error(__FILE__, __LINE__);
-      vif = (double *) malloc(data->conf->season[s].nreg * sizeof(double));
-      if (vif == NULL) alloc_error(__FILE__, __LINE__);
 
       /* Create variable to hold values of x vector for regression */
       /* Begin with distances to clusters */
@@ -639,49 +672,33 @@ wt_learning(data_struct *data) {
         for (clust=0; clust<data->conf->season[s].nclusters; clust++)
           data->learning->data[s].precip_reg_dist[clust+t*data->conf->season[s].nclusters] = dist[t+clust*ntime_sub[s]];
 
-      for (pt=0; pt<data->reg->npts; pt++) {
-        /* Compute regression and save regression constant */
-        istat = regress(precip_reg, dist_reg, &(mean_precip_sub[pt*ntime_sub[s]]), &(data->learning->data[s].precip_reg_cst[pt]),
-                        precip_index, precip_err, &chisq, &rsq, vif, &autocor, data->conf->season[s].nreg, ntime_sub[s]);
-        /* Save R^2 */
-        data->learning->data[s].precip_reg_rsq[pt] = rsq;
-        /* Save residuals */
-        for (t=0; t<ntime_sub[s]; t++)
-          data->learning->data[s].precip_reg_err[pt+t*data->reg->npts] = precip_err[t];
-        /* Save autocorrelation of residuals */
-        data->learning->data[s].precip_reg_autocor[pt] = autocor;
-        /* Save Variance Inflation Factor VIF, and compute mean VIF */
-        if (pt == 0) {
-          meanvif = 0.0;
-          for (term=0; term<data->conf->season[s].nreg; term++) {
-            data->learning->data[s].precip_reg_vif[term] = vif[term];
-            meanvif += vif[term];
-          }
-          meanvif = meanvif / (double) data->conf->season[s].nreg;
-        }
-
-        //        (void) fprintf(stdout, "%s: pt=%d R^2=%lf CHI^2=%lf ACOR=%lf\n", __FILE__, pt, rsq, chisq, autocor);
-
-        /* Save regression coefficients */
-        for (clust=0; clust<data->conf->season[s].nreg; clust++)
-          data->learning->data[s].precip_reg[pt+clust*data->reg->npts] = precip_reg[clust];
+      /* Compute regression for all regression points at once, since they share the same distances to clusters,
+         and save regression coefficients and constant, precipitation index, residuals, R^2 and autocorrelation of residuals */
+      istat = regress_multi(data->learning->data[s].precip_reg, dist_reg, mean_precip_sub, data->learning->data[s].precip_reg_cst,
+                            data->learning->data[s].precip_index, data->learning->data[s].precip_reg_err, chisq,
+                            data->learning->data[s].precip_reg_rsq, data->learning->data[s].precip_reg_vif,
+                            data->learning->data[s].precip_reg_autocor, data->conf->season[s].nreg, ntime_sub[s], data->reg->npts);
+      if (istat != 0) {
+        (void) fprintf(stderr, "%s: ERROR: Regression failed for season %d. Must abort...\n", __FILE__, s);
+        (void) perf_end(perf);
+        return -1;
+      }
 
-        /* Save precipitation index */
-        for (t=0; t<ntime_sub[s]; t++)
-          data->learning->data[s].precip_index[pt+t*data->reg->npts] = precip_index[t];
+      /* Compute mean Variance Inflation Factor VIF */
+      meanvif = 0.0;
+      for (term=0; term<data->conf->season[s].nreg; term++)
+        meanvif += data->learning->data[s].precip_reg_vif[term];
+      meanvif = meanvif / (double) data->conf->season[s].nreg;
 
-        /* Save observed precipitation index */
+      /* Save observed precipitation index */
+      for (pt=0; pt<data->reg->npts; pt++)
         for (t=0; t<ntime_sub[s]; t++)
           data->learning->data[s].precip_index_obs[pt+t*data->reg->npts] = mean_precip_sub[t+pt*ntime_sub[s]];
-      }
 
       (void) fprintf(stdout, "%s: MeanVIF=%lf\n", __FILE__, meanvif);
 
-      (void) free(precip_reg);
-      (void) free(precip_index);
-      (void) free(precip_err);
+      (void) free(chisq);
       (void) free(dist_reg);
-      (void) free(vif);
 
       (void) free(buf_learn_rea_sub);
       buf_learn_rea_sub = NULL;
@@ -698,6 +715,7 @@ wt_learning(data_struct *data) {
       (void) free(mean_precip_sub);
       mean_precip_sub = NULL;
     }
+    (void) perf_end(perf);
 
     (void) free(tas_rea);
     (void) free(tas_rea_mean);
@@ -716,9 +734,12 @@ wt_learning(data_struct *data) {
     /* If wanted, write learning data to files for later use */
     if (data->learning->learning_save == TRUE) {
       (void) printf("Writing learning fields.\n");
+      perf = perf_begin("write_learning_fields");
       istat = write_learning_fields(data);
+      (void) perf_end(perf);
     }
-    if (niter == 1) {
+    /* A warm start from converged clusters may legitimately need a single iteration */
+    if (niter == 1 && data->learning->learning_incremental != TRUE) {
       (void) fprintf(stderr, "%s: ERROR: In one classification, only 1 iteration was needed! Probably an error in your EOF data or configuration. Must abort...\n",
                      __FILE__);
       return -1;
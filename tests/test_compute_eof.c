@@ -0,0 +1,281 @@
+/* ***************************************************** */
+/* test_compute_eof Test EOF computation.                */
+/* test_compute_eof.c                                    */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/*! \file test_compute_eof.c
+    \brief Test EOF computation.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+/** GNU extensions */
+#define _GNU_SOURCE
+
+/* C standard includes */
+#ifdef HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_MATH_H
+#include <math.h>
+#endif
+#ifdef HAVE_TIME_H
+#include <time.h>
+#endif
+#ifdef HAVE_LIBGEN_H
+#include <libgen.h>
+#endif
+
+#include <gsl/gsl_rng.h>
+#include <gsl/gsl_randist.h>
+
+#include <pceof.h>
+
+/** C prototypes. */
+void show_usage(char *pgm);
+
+/** Main program. */
+int main(int argc, char **argv)
+{
+  /**
+     @param[in]  argc  Number of command-line arguments.
+     @param[in]  argv  Vector of command-line argument strings.
+
+     \return           Status.
+   */
+
+  int ni = 12;
+  int nj = 8;
+  int ntime = 500;
+  int neof = 3;
+  int method;
+  int eof;
+  int i;
+  int t;
+  int nerr = 0;
+
+  double missing_value = -9999.0;
+  double *field = NULL;
+  double *eofs = NULL;
+  double *sing = NULL;
+  double *proj = NULL;
+  double sing_svd[3];
+  double mean;
+  double norm;
+  double sum;
+  double val;
+  double a1;
+  double a2;
+  double a3;
+
+  gsl_rng *rng;
+
+  /* Print BEGIN banner */
+  (void) banner(basename(argv[0]), "1.0", "BEGIN");
+
+  /* Get command-line arguments and set appropriate variables */
+  for (i=1; i<argc; i++) {
+    if ( !strcmp(argv[i], "-h") ) {
+      (void) show_usage(basename(argv[0]));
+      (void) banner(basename(argv[0]), "OK", "END");
+      return 0;
+    }
+    else {
+      (void) fprintf(stderr, "%s:: Wrong arg %s.\n\n", basename(argv[0]), argv[i]);
+      (void) show_usage(basename(argv[0]));
+      (void) banner(basename(argv[0]), "ABORT", "END");
+      (void) abort();
+    }
+  }
+
+  field = (double *) malloc(ni*nj*ntime * sizeof(double));
+  if (field == NULL) alloc_error(__FILE__, __LINE__);
+  eofs = (double *) malloc(ni*nj*neof * sizeof(double));
+  if (eofs == NULL) alloc_error(__FILE__, __LINE__);
+  sing = (double *) malloc(neof * sizeof(double));
+  if (sing == NULL) alloc_error(__FILE__, __LINE__);
+  proj = (double *) malloc(neof*ntime * sizeof(double));
+  if (proj == NULL) alloc_error(__FILE__, __LINE__);
+
+  /* Synthetic anomalies: three large-scale patterns of decreasing amplitude plus noise */
+  rng = gsl_rng_alloc(gsl_rng_mt19937);
+  (void) gsl_rng_set(rng, 1);
+  for (t=0; t<ntime; t++) {
+    a1 = 4.0 * sin(2.0 * M_PI * (double) t / 37.0) + gsl_ran_gaussian(rng, 1.0);
+    a2 = gsl_ran_gaussian(rng, 2.0);
+    a3 = gsl_ran_gaussian(rng, 1.0);
+    for (i=0; i<ni*nj; i++)
+      field[i+t*ni*nj] = a1 * cos(M_PI * (double) (i%ni) / (double) ni) + a2 * sin(M_PI * (double) (i/ni) / (double) nj) +
+        a3 * cos(2.0 * M_PI * (double) (i%ni) / (double) ni) * cos(M_PI * (double) (i/ni) / (double) nj) +
+        gsl_ran_gaussian(rng, 0.1);
+  }
+  (void) gsl_rng_free(rng);
+
+  /* Centered anomalies, as compute_eof removes the time mean */
+  for (i=0; i<ni*nj; i++) {
+    mean = 0.0;
+    for (t=0; t<ntime; t++)
+      mean += field[i+t*ni*nj];
+    mean = mean / (double) ntime;
+    for (t=0; t<ntime; t++)
+      field[i+t*ni*nj] -= mean;
+  }
+  /* Points with missing values are left out of EOFs */
+  field[5] = missing_value;
+  for (t=0; t<ntime; t++)
+    field[ni*nj-1+t*ni*nj] = missing_value;
+
+  for (method=EOF_SVD; method<=EOF_SVD_RANDOM; method++) {
+
+    if (compute_eof(eofs, sing, field, missing_value, method, ni, nj, ntime, neof) != 0) {
+      (void) fprintf(stderr, "%s: compute_eof failed with method %d.\n", basename(argv[0]), method);
+      nerr++;
+      continue;
+    }
+
+    if (eofs[5] != missing_value || eofs[ni*nj-1] != missing_value) {
+      (void) fprintf(stderr, "%s: method %d: points with missing values are not missing in EOFs.\n", basename(argv[0]), method);
+      nerr++;
+    }
+
+    for (eof=0; eof<neof; eof++) {
+      /* EOF norm must be the singular value, as pack_eof_proj expects */
+      norm = 0.0;
+      sum = 0.0;
+      for (i=0; i<ni*nj; i++)
+        if (eofs[i+eof*ni*nj] != missing_value) {
+          val = eofs[i+eof*ni*nj] / sing[eof];
+          norm += val * val;
+          sum += eofs[i+eof*ni*nj];
+        }
+      if (fabs(sqrt(norm) - 1.0) > 1.0e-6) {
+        (void) fprintf(stderr, "%s: method %d EOF #%d: norm / singular value = %lf instead of 1.\n", basename(argv[0]), method,
+                       eof, sqrt(norm));
+        nerr++;
+      }
+      if (sum < 0.0) {
+        (void) fprintf(stderr, "%s: method %d EOF #%d: sum is negative.\n", basename(argv[0]), method, eof);
+        nerr++;
+      }
+      if (method == EOF_SVD)
+        sing_svd[eof] = sing[eof];
+      else if (fabs(sing[eof] - sing_svd[eof]) > 1.0e-3 * sing_svd[eof]) {
+        (void) fprintf(stderr, "%s: EOF #%d: singular value of randomized SVD %lf differs from SVD %lf.\n", basename(argv[0]),
+                       eof, sing[eof], sing_svd[eof]);
+        nerr++;
+      }
+    }
+
+    /* Projection onto EOFs: standard deviation of principal components must be the singular value */
+    if (project_field_eof(proj, field, eofs, sing, missing_value, (double *) NULL, (double *) NULL, 1.0,
+                          ni, nj, ntime, neof) != 0) {
+      (void) fprintf(stderr, "%s: method %d: project_field_eof failed.\n", basename(argv[0]), method);
+      nerr++;
+      continue;
+    }
+    for (eof=0; eof<neof; eof++) {
+      val = sqrt(gsl_stats_variance(&(proj[eof*ntime]), 1, (size_t) ntime));
+      (void) fprintf(stdout, "%s: method %d EOF #%d: singular value %lf, standard deviation of projection %lf\n",
+                     basename(argv[0]), method, eof, sing[eof], val);
+      if (fabs(val / sing[eof] - 1.0) > 1.0e-6) {
+        (void) fprintf(stderr, "%s: method %d EOF #%d: standard deviation of projection / singular value = %lf instead of 1.\n",
+                       basename(argv[0]), method, eof, val / sing[eof]);
+        nerr++;
+      }
+    }
+  }
+
+  /* Free memory */
+  (void) free(field);
+  (void) free(eofs);
+  (void) free(sing);
+  (void) free(proj);
+
+  if (nerr != 0) {
+    (void) banner(basename(argv[0]), "ABORT", "END");
+    return 1;
+  }
+
+  /* Print END banner */
+  (void) banner(basename(argv[0]), "OK", "END");
+
+  return 0;
+}
+
+
+/** Local Subroutines **/
+
+/** Show usage for program command-line arguments. */
+void show_usage(char *pgm) {
+  /**
+     @param[in]  pgm  Program name.
+  */
+
+  (void) fprintf(stderr, "%s: usage:\n", pgm);
+  (void) fprintf(stderr, "-h: help\n");
+
+}
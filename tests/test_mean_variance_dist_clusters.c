@@ -175,6 +175,7 @@ int main(int argc, char **argv)
 
   double *psl_pc = NULL;
   double *buf_sub = NULL;
+  pc_days_struct pc_days;
   double *buftmp = NULL;
   int ntime_sub;
   double *timein = NULL;
@@ -1017,8 +1018,9 @@ int main(int argc, char **argv)
                              neof, 1, ntime, ntime_learn[i]);
     (void) free(buftmp);
     
-    (void) mean_variance_dist_clusters(mean_dist[i], var_dist[i], buf_sub, poid[i], eca_pc_learn, var_pc_norm_all,
-                                       neof, nclust[i], ntime_sub);
+    (void) pack_pc_days(&pc_days, buf_sub, neof, ntime_sub);
+    (void) mean_variance_dist_clusters(mean_dist[i], var_dist[i], &pc_days, poid[i], eca_pc_learn, var_pc_norm_all, nclust[i]);
+    (void) free_pc_days(&pc_days);
     (void) free(buf_sub);
     (void) free(var_pc_norm_all);
 
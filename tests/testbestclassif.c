@@ -216,7 +216,7 @@ int main(int argc, char **argv)
   (void) gsl_rng_free(rng);
 
   /* Find clusters: test best classification algorithm */
-  (void) best_clusters(clusters, pc_eof_days, "euclidian", npart, nclassif, neof, nclusters, ndays);
+  (void) best_clusters(clusters, pc_eof_days, "euclidian", "random", npart, nclassif, neof, nclusters, ndays, 4, 1, 0.0);
 
   /* Output data */
   for (i=0; i<neof; i++)
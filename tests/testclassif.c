@@ -114,9 +114,18 @@ int main(int argc, char **argv)
   int ndays;
   int nclusters;
   int nclassif;
+  int clust;
+  int clust2;
+  int day;
+  int found;
+  int nerr = 0;
 
   double *pc_eof_days = NULL;
   double *clusters = NULL;
+  double *seeds = NULL;
+  double *seeds2 = NULL;
+  double *clusters2 = NULL;
+  pc_days_struct pc_days;
 
   const gsl_rng_type *T;
   gsl_rng *rng;
@@ -178,7 +187,65 @@ int main(int argc, char **argv)
   (void) gsl_rng_free(rng);
 
   /* Find clusters: test classification algorithm */
-  (void) generate_clusters(clusters, pc_eof_days, "euclidian", nclassif, neof, nclusters, ndays);
+  (void) pack_pc_days(&pc_days, pc_eof_days, neof, ndays);
+  (void) generate_clusters(clusters, &pc_days, "euclidian", "random", nclassif, nclusters, 1, 0.0);
+
+  /* k-means++ seeding: seeds must be distinct days, and the same for the same random number generator seed */
+  seeds = (double *) malloc(neof*nclusters * sizeof(double));
+  if (seeds == NULL) alloc_error(__FILE__, __LINE__);
+  seeds2 = (double *) malloc(neof*nclusters * sizeof(double));
+  if (seeds2 == NULL) alloc_error(__FILE__, __LINE__);
+  clusters2 = (double *) malloc(neof*nclusters * sizeof(double));
+  if (clusters2 == NULL) alloc_error(__FILE__, __LINE__);
+
+  rng = gsl_rng_alloc(T);
+  (void) gsl_rng_set(rng, 1);
+  (void) seed_clusters(seeds, &pc_days, "kmeans++", rng, nclusters);
+  (void) gsl_rng_set(rng, 1);
+  (void) seed_clusters(seeds2, &pc_days, "kmeans++", rng, nclusters);
+  (void) gsl_rng_free(rng);
+
+  for (clust=0; clust<nclusters; clust++) {
+    found = 0;
+    for (day=0; day<ndays && found == 0; day++) {
+      found = 1;
+      for (i=0; i<neof; i++)
+        if (seeds[i+clust*neof] != pc_days.pc[i+day*neof])
+          found = 0;
+    }
+    if (found == 0) {
+      (void) fprintf(stderr, "%s: kmeans++ seed %d is not a day.\n", basename(argv[0]), clust);
+      nerr++;
+    }
+    for (clust2=0; clust2<clust; clust2++) {
+      found = 1;
+      for (i=0; i<neof; i++)
+        if (seeds[i+clust*neof] != seeds[i+clust2*neof])
+          found = 0;
+      if (found == 1) {
+        (void) fprintf(stderr, "%s: kmeans++ seeds %d and %d are the same day.\n", basename(argv[0]), clust2, clust);
+        nerr++;
+      }
+    }
+  }
+  for (i=0; i<neof*nclusters; i++)
+    if (seeds[i] != seeds2[i]) {
+      (void) fprintf(stderr, "%s: kmeans++ seeds differ for the same seed.\n", basename(argv[0]));
+      nerr++;
+      break;
+    }
+
+  /* k-means++ classification must be reproducible for a fixed seed */
+  (void) generate_clusters(clusters2, &pc_days, "euclidian", "kmeans++", nclassif, nclusters, 1, 0.0);
+  (void) memcpy(seeds, clusters2, neof*nclusters * sizeof(double));
+  (void) generate_clusters(clusters2, &pc_days, "euclidian", "kmeans++", nclassif, nclusters, 1, 0.0);
+  for (i=0; i<neof*nclusters; i++)
+    if (seeds[i] != clusters2[i]) {
+      (void) fprintf(stderr, "%s: kmeans++ clusters differ for the same seed.\n", basename(argv[0]));
+      nerr++;
+      break;
+    }
+  (void) free_pc_days(&pc_days);
 
   /* Output data */
   for (i=0; i<neof; i++)
@@ -188,6 +255,14 @@ int main(int argc, char **argv)
   /* Free memory */
   (void) free(pc_eof_days);
   (void) free(clusters);
+  (void) free(clusters2);
+  (void) free(seeds);
+  (void) free(seeds2);
+
+  if (nerr != 0) {
+    (void) banner(basename(argv[0]), "ABORT", "END");
+    return 1;
+  }
 
   /* Print END banner */
   (void) banner(basename(argv[0]), "OK", "END");
@@ -0,0 +1,347 @@
+/* ***************************************************** */
+/* testclassif_bounds Benchmark bounds-accelerated       */
+/* classification against exact classification          */
+/* using real NetCDF data.                               */
+/* testclassif_bounds.c                                  */
+/* ***************************************************** */
+/* Author: Christian Page, CERFACS, Toulouse, France.    */
+/* ***************************************************** */
+/*! \file testclassif_bounds.c
+    \brief Benchmark bounds-accelerated classification against exact classification using real NetCDF data.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+/** GNU extensions */
+#define _GNU_SOURCE
+
+/* C standard includes */
+#ifdef HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_MATH_H
+#include <math.h>
+#endif
+#ifdef HAVE_TIME_H
+#include <time.h>
+#endif
+#ifdef HAVE_LIBGEN_H
+#include <libgen.h>
+#endif
+
+#include <zlib.h>
+#include <hdf5.h>
+#include <netcdf.h>
+
+#include <classif.h>
+
+/** C prototypes. */
+void show_usage(char *pgm);
+void handle_netcdf_error(int status, int lineno);
+
+/** Main program. */
+int main(int argc, char **argv)
+{
+  /**
+     @param[in]  argc  Number of command-line arguments.
+     @param[in]  argv  Vector of command-line argument strings.
+
+     \return           Status.
+   */
+
+  int i;
+  int j;
+  int neof;
+  int ndays;
+  int nclusters;
+  int nclassif;
+  int classif;
+  int clust;
+  int *ndays_cluster = NULL;
+  int ndiff = 0;
+  int nchanged;
+
+  size_t dimval;
+
+  double *buf = NULL;
+  double *pc_eof_days = NULL;
+  double *clusters = NULL;
+  pc_days_struct pc_days;
+  double *upper_bound = NULL;
+  double *lower_bound = NULL;
+  double *prev_cluster = NULL;
+  int *class_exact = NULL;
+  int *class_bounds = NULL;
+
+  clock_t clock_start;
+  double time_exact = 0.0;
+  double time_bounds = 0.0;
+
+  char *filein = NULL;
+
+  int istat, ncid;
+  int eofdimid, daydimid, varid;
+  nc_type vartype;
+  int varndims;
+  int vardimids[NC_MAX_VAR_DIMS];    /* dimension ids */
+
+  size_t start[2];
+  size_t count[2];
+
+  const gsl_rng_type *T;
+  gsl_rng *rng;
+
+  /* Print BEGIN banner */
+  (void) banner(basename(argv[0]), "1.0", "BEGIN");
+
+  /* Use 10 clusters */
+  nclusters = 10;
+  /* Perform 100 classifications */
+  nclassif = 100;
+
+  /* Get command-line arguments and set appropriate variables */
+  for (i=1; i<argc; i++) {
+    if ( !strcmp(argv[i], "-h") ) {
+      (void) show_usage(basename(argv[0]));
+      (void) banner(basename(argv[0]), "OK", "END");
+      return 0;
+    }
+    else if ( !strcmp(argv[i], "-i") ) {
+      filein = (char *) malloc((strlen(argv[++i])+1) * sizeof(char));
+      if (filein == NULL) alloc_error(__FILE__, __LINE__);
+      (void) strcpy(filein, argv[i]);
+    }
+    else if ( !strcmp(argv[i], "-n") )
+      nclassif = atoi(argv[++i]);
+    else {
+      (void) fprintf(stderr, "%s:: Wrong arg %s.\n\n", basename(argv[0]), argv[i]);
+      (void) show_usage(basename(argv[0]));
+      (void) banner(basename(argv[0]), "ABORT", "END");
+      (void) abort();
+    }
+  }
+  if (filein == NULL) {
+    (void) show_usage(basename(argv[0]));
+    (void) banner(basename(argv[0]), "ABORT", "END");
+    (void) abort();
+  }
+
+  /* Read data in NetCDF file */
+  istat = nc_open(filein, NC_NOWRITE, &ncid);  /* open for reading */
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __LINE__);
+  
+  istat = nc_inq_dimid(ncid, "eof", &eofdimid);  /* get ID for eof dimension */
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __LINE__);
+  istat = nc_inq_dimlen(ncid, eofdimid, &dimval); /* get eof length */
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __LINE__);
+  neof = (int) dimval;
+
+  istat = nc_inq_dimid(ncid, "day", &daydimid);  /* get ID for day dimension */
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __LINE__);
+  istat = nc_inq_dimlen(ncid, daydimid, &dimval); /* get day length */
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __LINE__);
+  ndays = (int) dimval;
+
+  istat = nc_inq_varid(ncid, "pc_proj", &varid); /* get pc_proj variable ID */
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __LINE__);
+
+  istat = nc_inq_var(ncid, varid, (char *) NULL, &vartype, &varndims, vardimids, (int *) NULL); /* get variable information */
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __LINE__);
+
+  if (vartype != NC_DOUBLE || varndims != 2) {
+    (void) fprintf(stderr, "Error NetCDF type and/or dimensions.\n");
+    (void) banner(basename(argv[0]), "ABORT", "END");
+    (void) abort();
+  }
+
+  /** Read data variable **/
+  start[0] = 0;
+  start[1] = 0;
+  count[0] = (size_t) ndays;
+  count[1] = (size_t) neof;
+  buf = (double *) malloc(neof*ndays * sizeof(double));
+  if (buf == NULL) alloc_error(__FILE__, __LINE__);
+  istat = nc_get_vara_double(ncid, varid, start, count, buf);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __LINE__);
+
+  /* Close the netCDF file. */
+  istat = ncclose(ncid);
+  if (istat != NC_NOERR) handle_netcdf_error(istat, __LINE__);
+
+  /* Transpose to the (day, eof) layout used by the classification library */
+  pc_eof_days = (double *) malloc(neof*ndays * sizeof(double));
+  if (pc_eof_days == NULL) alloc_error(__FILE__, __LINE__);
+  for (j=0; j<ndays; j++)
+    for (i=0; i<neof; i++)
+      pc_eof_days[j+i*ndays] = buf[i+j*neof];
+  (void) free(buf);
+  (void) pack_pc_days(&pc_days, pc_eof_days, neof, ndays);
+
+  /* Allocate memory */
+  clusters = (double *) malloc(neof*nclusters * sizeof(double));
+  if (clusters == NULL) alloc_error(__FILE__, __LINE__);
+  prev_cluster = (double *) malloc(neof*nclusters * sizeof(double));
+  if (prev_cluster == NULL) alloc_error(__FILE__, __LINE__);
+  upper_bound = (double *) malloc(ndays * sizeof(double));
+  if (upper_bound == NULL) alloc_error(__FILE__, __LINE__);
+  lower_bound = (double *) malloc(ndays * sizeof(double));
+  if (lower_bound == NULL) alloc_error(__FILE__, __LINE__);
+  class_exact = (int *) malloc(ndays * sizeof(int));
+  if (class_exact == NULL) alloc_error(__FILE__, __LINE__);
+  class_bounds = (int *) malloc(ndays * sizeof(int));
+  if (class_bounds == NULL) alloc_error(__FILE__, __LINE__);
+  ndays_cluster = (int *) malloc(nclusters * sizeof(int));
+  if (ndays_cluster == NULL) alloc_error(__FILE__, __LINE__);
+
+  /* Random initial clusters */
+  T = gsl_rng_default;
+  rng = gsl_rng_alloc(T);
+  (void) gsl_rng_set(rng, 1);
+  for (clust=0; clust<nclusters; clust++) {
+    j = (int) gsl_rng_uniform_int(rng, ndays);
+    for (i=0; i<neof; i++)
+      clusters[i+clust*neof] = pc_eof_days[j+i*ndays];
+  }
+  (void) gsl_rng_free(rng);
+
+  /* Iterate the clustering algorithm, classifying days with both methods */
+  for (classif=0; classif<nclassif; classif++) {
+
+    clock_start = clock();
+    (void) class_days_pc_clusters(class_exact, &pc_days, clusters, "euclidian", neof, nclusters);
+    time_exact += (double) (clock() - clock_start) / (double) CLOCKS_PER_SEC;
+
+    clock_start = clock();
+    nchanged = class_days_pc_clusters_bounds(class_bounds, upper_bound, lower_bound, prev_cluster, &pc_days, clusters,
+                                             (classif == 0), nclusters);
+    time_bounds += (double) (clock() - clock_start) / (double) CLOCKS_PER_SEC;
+
+    for (j=0; j<ndays; j++)
+      if (class_exact[j] != class_bounds[j])
+        ndiff++;
+
+    /* New cluster centroids */
+    (void) update_clusters_centroid(clusters, ndays_cluster, &pc_days, class_exact, nclusters);
+
+    if (nchanged == 0) {
+      classif++;
+      break;
+    }
+  }
+
+  (void) fprintf(stdout, "%s: %d days, %d EOFs, %d clusters, %d classifications.\n", basename(argv[0]), ndays, neof, nclusters, classif);
+  (void) fprintf(stdout, "%s: exact classification time: %lf s\n", basename(argv[0]), time_exact);
+  (void) fprintf(stdout, "%s: bounds classification time: %lf s\n", basename(argv[0]), time_bounds);
+  if (time_bounds > 0.0)
+    (void) fprintf(stdout, "%s: speedup: %lf\n", basename(argv[0]), time_exact / time_bounds);
+  (void) fprintf(stdout, "%s: days classified differently: %d\n", basename(argv[0]), ndiff);
+
+  /* Free memory */
+  (void) free(pc_eof_days);
+  (void) free_pc_days(&pc_days);
+  (void) free(clusters);
+  (void) free(prev_cluster);
+  (void) free(upper_bound);
+  (void) free(lower_bound);
+  (void) free(class_exact);
+  (void) free(class_bounds);
+  (void) free(ndays_cluster);
+  (void) free(filein);
+
+  if (ndiff != 0) {
+    (void) banner(basename(argv[0]), "ABORT", "END");
+    return 1;
+  }
+
+  /* Print END banner */
+  (void) banner(basename(argv[0]), "OK", "END");
+
+  return 0;
+}
+
+
+/** Local Subroutines **/
+
+/** Show usage for program command-line arguments. */
+void show_usage(char *pgm) {
+  /**
+     @param[in]  pgm  Program name.
+  */
+
+  (void) fprintf(stderr, "%s: usage:\n", pgm);
+  (void) fprintf(stderr, "-h: help\n");
+  (void) fprintf(stderr, "-i: input NetCDF file with pc_proj(day, eof) variable\n");
+  (void) fprintf(stderr, "-n: maximum number of classifications (default 100)\n");
+
+}
+
+/* Handle error */
+void handle_netcdf_error(int status, int lineno)
+{
+  if (status != NC_NOERR) {
+    fprintf(stderr, "Line: %d Error: %s\n", lineno, nc_strerror(status));
+    exit(-1);
+  }
+}
@@ -93,6 +93,7 @@ LICENSE END */
 
 /** C prototypes. */
 void show_usage(char *pgm);
+int check_rectangular(int width, int nt);
 
 /** Main program. */
 int main(int argc, char **argv)
@@ -120,10 +121,18 @@ int main(int argc, char **argv)
   double *outvect;
   double value;
   int width = 60;
+  char type[500] = "hanning"; /* Filter type */
 
   /* Print BEGIN banner */
   (void) banner(basename(argv[0]), "1.0", "BEGIN");
 
+  /* Check rectangular window against running mean, odd and even widths, direct and FFT convolutions */
+  if (check_rectangular(5, 40) != 0 || check_rectangular(6, 40) != 0 ||
+      check_rectangular(33, 100) != 0 || check_rectangular(34, 100) != 0) {
+    (void) banner(basename(argv[0]), "ABORT", "END");
+    (void) abort();
+  }
+
   /* Get command-line arguments and set appropriate variables */
   if (argc <= 1) {
     (void) show_usage(basename(argv[0]));
@@ -138,6 +147,8 @@ int main(int argc, char **argv)
         (void) strcpy(fileout, argv[++i]);
       else if ( !strcmp(argv[i], "-w") )
         (void) sscanf(argv[++i], "%d", &width);
+      else if ( !strcmp(argv[i], "-t") )
+        (void) strcpy(type, argv[++i]);
       else {
         (void) fprintf(stderr, "%s:: Wrong arg %s.\n\n", basename(argv[0]), argv[i]);
         (void) show_usage(basename(argv[0]));
@@ -156,7 +167,7 @@ int main(int argc, char **argv)
     (void) fprintf(stderr, "Cannot open output file : %s.\n", fileout);
     (void) abort();
   }
-  (void) fprintf(stdout, "Filter width=%d\n", width);
+  (void) fprintf(stdout, "Filter type=%s width=%d\n", type, width);
 
   end = FALSE;
   numval = 0;
@@ -177,7 +188,7 @@ int main(int argc, char **argv)
   outvect = (double *) calloc(numval, sizeof(double));
   if (outvect == NULL) alloc_error(__FILE__, __LINE__);
   
-  filter(outvect, invect, "hanning", width, 1, 1, numval);
+  filter(outvect, invect, type, width, 1, 1, numval);
 
   for (i=0; i<numval; i++)
     (void) fprintf(outptr, "%d %lf %lf\n", i, invect[i], outvect[i]);
@@ -207,5 +218,56 @@ void show_usage(char *pgm) {
   (void) fprintf(stderr, "-i: input file\n");
   (void) fprintf(stderr, "-o: output file\n");
   (void) fprintf(stderr, "-w: filter width\n");
+  (void) fprintf(stderr, "-t: filter type: hanning (default), hamming, blackman or rectangular\n");
+
+}
+
+/** Compare rectangular window filtering with a running mean over width-1 values, using wrap edges. */
+int check_rectangular(int width, int nt) {
+  /**
+     @param[in]  width  Width of filter.
+     @param[in]  nt     Length of the test time serie.
+
+     \return           Status.
+  */
+
+  double *invect; /* Test time serie */
+  double *outvect; /* Filtered time serie */
+  double mean; /* Running mean */
+  int ntaps; /* Number of values of the running mean */
+  int half_width; /* Half-width of filter window */
+  int t; /* Loop counter */
+  int tt; /* Loop counter */
+  int istat = 0; /* Status */
+
+  invect = (double *) malloc(nt * sizeof(double));
+  if (invect == NULL) alloc_error(__FILE__, __LINE__);
+  outvect = (double *) malloc(nt * sizeof(double));
+  if (outvect == NULL) alloc_error(__FILE__, __LINE__);
+
+  for (t=0; t<nt; t++)
+    invect[t] = 10.0 + sin((double) t) + 0.01 * (double) (t*t % 17);
+
+  filter(outvect, invect, "rectangular", width, 1, 1, nt);
+
+  ntaps = width - 1;
+  half_width = ( width - 1 ) / 2;
+  for (t=0; t<nt; t++) {
+    mean = 0.0;
+    for (tt=0; tt<ntaps; tt++)
+      mean += invect[(t + tt - half_width + nt) % nt];
+    mean /= (double) ntaps;
+    if (fabs(outvect[t] - mean) > 1.0e-10) {
+      (void) fprintf(stderr, "Rectangular filter width=%d: t=%d filtered=%lf running mean=%lf\n", width, t, outvect[t], mean);
+      istat = -1;
+      break;
+    }
+  }
+  if (istat == 0)
+    (void) fprintf(stdout, "Rectangular filter width=%d: OK\n", width);
+
+  (void) free(invect);
+  (void) free(outvect);
 
+  return istat;
 }
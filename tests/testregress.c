@@ -109,9 +109,8 @@ int main(int argc, char **argv)
   int npts;
   int nterm;
   int pts;
-#if DEBUG >= 6
   int term;
-#endif
+  int resp;
 
   int i;
   int istat;
@@ -127,6 +126,16 @@ int main(int argc, char **argv)
   double rsq;
   double autocor;
 
+  int nresp;
+  double *ym = NULL;
+  double *yregm = NULL;
+  double *coefm = NULL;
+  double *yerrm = NULL;
+  double *ctem = NULL;
+  double *chisqm = NULL;
+  double *rsqm = NULL;
+  double *autocorm = NULL;
+
   /* Print BEGIN banner */
   (void) banner(basename(argv[0]), "1.0", "BEGIN");
 
@@ -195,6 +204,78 @@ int main(int argc, char **argv)
     (void) fprintf(stdout, "%s: pts=%d y=%lf yreg=%lf yerr=%lf\n", __FILE__, pts, y[pts], yreg[pts], yerr[pts]);
 #endif
 
+  /* Same regression for several Y vectors at once: first Y vector is the same as above */
+  nresp = 3;
+  ym = (double *) calloc(npts*nresp, sizeof(double));
+  if (ym == NULL) alloc_error(__FILE__, __LINE__);
+  yregm = (double *) calloc(npts*nresp, sizeof(double));
+  if (yregm == NULL) alloc_error(__FILE__, __LINE__);
+  yerrm = (double *) calloc(npts*nresp, sizeof(double));
+  if (yerrm == NULL) alloc_error(__FILE__, __LINE__);
+  coefm = (double *) calloc(nterm*nresp, sizeof(double));
+  if (coefm == NULL) alloc_error(__FILE__, __LINE__);
+  ctem = (double *) calloc(nresp, sizeof(double));
+  if (ctem == NULL) alloc_error(__FILE__, __LINE__);
+  chisqm = (double *) calloc(nresp, sizeof(double));
+  if (chisqm == NULL) alloc_error(__FILE__, __LINE__);
+  rsqm = (double *) calloc(nresp, sizeof(double));
+  if (rsqm == NULL) alloc_error(__FILE__, __LINE__);
+  autocorm = (double *) calloc(nresp, sizeof(double));
+  if (autocorm == NULL) alloc_error(__FILE__, __LINE__);
+
+  for (pts=0; pts<npts; pts++) {
+    ym[pts+0*npts] = y[pts];
+    ym[pts+1*npts] = -1.0 + 0.5 * x[pts+0*npts] + 2.0 * x[pts+1*npts] + 0.1 * (double) (pts % 2);
+    ym[pts+2*npts] = 2.0 * x[pts+1*npts] * x[pts+1*npts];
+  }
+
+  istat = regress_multi(coefm, x, ym, ctem, yregm, yerrm, chisqm, rsqm, vif, autocorm, nterm, npts, nresp);
+  if (istat != 0) {
+    (void) fprintf(stderr, "%s: Multiple Y vectors regression failed!\n", __FILE__);
+    (void) banner(basename(argv[0]), "ABORT", "END");
+    (void) abort();
+  }
+
+  /* Each Y vector must give the same results as a single Y vector regression */
+  for (resp=0; resp<nresp; resp++) {
+    istat = regress(coef, x, &(ym[resp*npts]), &cte, yreg, yerr, &chisq, &rsq, vif, &autocor, nterm, npts);
+    if (istat != 0 || fabs(ctem[resp] - cte) > 1.0e-8 || fabs(chisqm[resp] - chisq) > 1.0e-8 || fabs(rsqm[resp] - rsq) > 1.0e-8)
+      istat = -1;
+    for (term=0; term<nterm; term++)
+      if (fabs(coefm[resp+term*nresp] - coef[term]) > 1.0e-8)
+        istat = -1;
+    for (pts=0; pts<npts; pts++)
+      if (fabs(yregm[resp+pts*nresp] - yreg[pts]) > 1.0e-8 || fabs(yerrm[resp+pts*nresp] - yerr[pts]) > 1.0e-8)
+        istat = -1;
+    /* Autocorrelation of residuals is only meaningful when the fit is not exact */
+    if (chisq > 1.0e-8 && fabs(autocorm[resp] - autocor) > 1.0e-8)
+      istat = -1;
+    if (istat != 0) {
+      (void) fprintf(stderr, "%s: Multiple Y vectors regression differs from single Y vector regression for Y vector %d!\n",
+                     __FILE__, resp);
+      (void) banner(basename(argv[0]), "ABORT", "END");
+      (void) abort();
+    }
+  }
+
+#if DEBUG >= 6
+  for (resp=0; resp<nresp; resp++) {
+    for (term=0; term<nterm; term++)
+      (void) fprintf(stdout, "%s: resp=%d term=%d coef=%lf\n", __FILE__, resp, term, coefm[resp+term*nresp]);
+    (void) fprintf(stdout, "%s: resp=%d cte=%lf chisq=%lf rsq=%lf autocor=%lf\n", __FILE__, resp, ctem[resp], chisqm[resp],
+                   rsqm[resp], autocorm[resp]);
+  }
+#endif
+
+  (void) free(ym);
+  (void) free(yregm);
+  (void) free(yerrm);
+  (void) free(coefm);
+  (void) free(ctem);
+  (void) free(chisqm);
+  (void) free(rsqm);
+  (void) free(autocorm);
+
   (void) free(coef);
   (void) free(yreg);
   (void) free(yerr);
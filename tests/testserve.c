@@ -0,0 +1,279 @@
+/* ********************************************************* */
+/* testserve Send a downscaling job to dsclim service mode.  */
+/* testserve.c                                               */
+/* ********************************************************* */
+/* Author: Christian Page, CERFACS, Toulouse, France.        */
+/* ********************************************************* */
+/*! \file testserve.c
+    \brief Send a downscaling job to dsclim service mode.
+*/
+
+/* LICENSE BEGIN
+
+Copyright Cerfacs (Christian Page) (2015)
+
+christian.page@cerfacs.fr
+
+This software is a computer program whose purpose is to downscale climate
+scenarios using a statistical methodology based on weather regimes.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and, more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+LICENSE END */
+
+
+
+
+
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+/** GNU extensions */
+#define _GNU_SOURCE
+
+/* C standard includes */
+#ifdef HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_LIBGEN_H
+#include <libgen.h>
+#endif
+#ifdef HAVE_SYS_SOCKET_H
+#include <sys/socket.h>
+#endif
+#ifdef HAVE_SYS_UN_H
+#include <sys/un.h>
+#endif
+
+#include <utils.h>
+
+/** C prototypes. */
+void show_usage(char *pgm);
+int send_request(char *reply, size_t size, char *socketpath, char *request);
+
+/** Main program. */
+int main(int argc, char **argv)
+{
+  /**
+     @param[in]  argc  Number of command-line arguments.
+     @param[in]  argv  Vector of command-line argument strings.
+
+     \return           Status.
+   */
+
+  char *socketpath = NULL; /* Socket path of dsclim service mode */
+  char *request = NULL; /* Request text */
+  char reply[5000]; /* Reply text */
+  size_t len; /* Length of request text */
+  int nerr = 0; /* Number of requests not answered OK */
+
+  int i;
+
+  /* Print BEGIN banner */
+  (void) banner(basename(argv[0]), "1.0", "BEGIN");
+
+  request = strdup("");
+  if (request == NULL) alloc_error(__FILE__, __LINE__);
+
+  /* Get command-line arguments and set appropriate variables */
+  for (i=1; i<argc; i++) {
+    if ( !strcmp(argv[i], "-h") ) {
+      (void) show_usage(basename(argv[0]));
+      (void) banner(basename(argv[0]), "OK", "END");
+      return 0;
+    }
+    else if ( !strcmp(argv[i], "-socket") && i+1 < argc )
+      socketpath = argv[++i];
+    else if ( !strcmp(argv[i], "-field") && i+2 < argc ) {
+      len = strlen(request) + strlen(argv[i+1]) + strlen(argv[i+2]) + 9;
+      request = (char *) realloc(request, len * sizeof(char));
+      if (request == NULL) alloc_error(__FILE__, __LINE__);
+      (void) strcat(request, "field ");
+      (void) strcat(request, argv[i+1]);
+      (void) strcat(request, " ");
+      (void) strcat(request, argv[i+2]);
+      (void) strcat(request, "\n");
+      i += 2;
+    }
+    else if ( !strcmp(argv[i], "-output") && i+1 < argc ) {
+      len = strlen(request) + strlen(argv[i+1]) + 9;
+      request = (char *) realloc(request, len * sizeof(char));
+      if (request == NULL) alloc_error(__FILE__, __LINE__);
+      (void) strcat(request, "output ");
+      (void) strcat(request, argv[++i]);
+      (void) strcat(request, "\n");
+    }
+    else {
+      (void) fprintf(stderr, "%s:: Wrong arg %s.\n\n", basename(argv[0]), argv[i]);
+      (void) show_usage(basename(argv[0]));
+      (void) banner(basename(argv[0]), "ABORT", "END");
+      (void) abort();
+    }
+  }
+
+  if (socketpath == NULL) {
+    (void) fprintf(stderr, "%s:: Missing -socket argument.\n\n", basename(argv[0]));
+    (void) show_usage(basename(argv[0]));
+    (void) banner(basename(argv[0]), "ABORT", "END");
+    (void) abort();
+  }
+
+  /* Send job terminated by an empty line and wait for it to finish */
+  len = strlen(request) + 2;
+  request = (char *) realloc(request, len * sizeof(char));
+  if (request == NULL) alloc_error(__FILE__, __LINE__);
+  (void) strcat(request, "\n");
+  if (send_request(reply, sizeof(reply), socketpath, request) != 0 || strcmp(reply, "OK\n")) {
+    (void) fprintf(stderr, "%s: Job failed. Reply: %s\n", basename(argv[0]), reply);
+    nerr++;
+  }
+  else
+    (void) fprintf(stdout, "%s: Job reply: %s", basename(argv[0]), reply);
+
+  /* Then ask the service to stop */
+  if (send_request(reply, sizeof(reply), socketpath, "quit\n\n") != 0 || strcmp(reply, "OK\n")) {
+    (void) fprintf(stderr, "%s: Quit failed. Reply: %s\n", basename(argv[0]), reply);
+    nerr++;
+  }
+  else
+    (void) fprintf(stdout, "%s: Quit reply: %s", basename(argv[0]), reply);
+
+  (void) free(request);
+
+  if (nerr != 0) {
+    (void) banner(basename(argv[0]), "ABORT", "END");
+    return 1;
+  }
+
+  /* Print END banner */
+  (void) banner(basename(argv[0]), "OK", "END");
+
+  return 0;
+}
+
+
+/** Local Subroutines **/
+
+/** Show usage for program command-line arguments. */
+void show_usage(char *pgm) {
+  /**
+     @param[in]  pgm  Program name.
+  */
+
+  (void) fprintf(stderr, "%s: usage:\n", pgm);
+  (void) fprintf(stderr, "-h: help\n");
+  (void) fprintf(stderr, "-socket: socket path of a running dsclim -serve\n");
+  (void) fprintf(stderr, "-field: nomvar filename: model large-scale field input file replacing the configured one (repeatable)\n");
+  (void) fprintf(stderr, "-output: output path of the downscaled job\n");
+  (void) fprintf(stderr, "The job is sent, then the service is asked to stop: the status is 0 only if both replies are OK.\n");
+
+}
+
+/** Send a request on a new connection to the service and read its reply. */
+int send_request(char *reply, size_t size, char *socketpath, char *request) {
+  /**
+     @param[out] reply       Reply text
+     @param[in]  size        Size of reply buffer
+     @param[in]  socketpath  Socket path of dsclim service mode
+     @param[in]  request     Request text, terminated by an empty line
+
+     \return                 Status.
+  */
+
+#if defined(HAVE_SYS_SOCKET_H) && defined(HAVE_SYS_UN_H)
+  struct sockaddr_un addr; /* Socket address */
+  ssize_t nbytes; /* Number of bytes sent or received */
+  size_t nreply; /* Number of bytes of reply */
+  size_t len = strlen(request); /* Length of request text */
+  int sock; /* Socket descriptor */
+
+  reply[0] = '\0';
+
+  (void) memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (strlen(socketpath) >= sizeof(addr.sun_path)) {
+    (void) fprintf(stderr, "%s: Socket path too long: %s\n", __FILE__, socketpath);
+    return -1;
+  }
+  (void) strcpy(addr.sun_path, socketpath);
+
+  sock = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (sock < 0)  {
+    (void) fprintf(stderr, "%s: Cannot create socket.\n", __FILE__);
+    return -1;
+  }
+  if (connect(sock, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
+    (void) fprintf(stderr, "%s: Cannot connect to %s\n", __FILE__, socketpath);
+    (void) close(sock);
+    return -1;
+  }
+
+  nbytes = write(sock, request, len);
+  if (nbytes != (ssize_t) len) {
+    (void) fprintf(stderr, "%s: Cannot send request to %s\n", __FILE__, socketpath);
+    (void) close(sock);
+    return -1;
+  }
+  (void) shutdown(sock, SHUT_WR);
+
+  nreply = 0;
+  while (nreply < size - 1 && (nbytes = read(sock, reply + nreply, size - 1 - nreply)) > 0)
+    nreply += (size_t) nbytes;
+  reply[nreply] = '\0';
+  (void) close(sock);
+
+  return 0;
+#else
+  (void) size;
+  (void) socketpath;
+  (void) request;
+  reply[0] = '\0';
+  (void) fprintf(stderr, "%s: Unix-domain sockets are not available on this system.\n", __FILE__);
+  return -1;
+#endif
+}